@@ -1,48 +1,78 @@
-#include "ActorDefinition.hpp"
-#include "Engine/Core/NamedStrings.hpp"
-#include "AnimationGroupDefinition.hpp"
-
-float ActorDefinition::GetHeight() const
-{
-    return m_collisionElement.m_physicsHeight;
-}
-
-float ActorDefinition::GetRadius() const
-{
-    return m_collisionElement.m_physicsRadius;
-}
-
-Faction ActorDefinition::GetFaction() const
-{
-    return m_faction;
-}
-
-bool ActorDefinition::IsSimulated() const
-{
-    return m_physicsElement.m_simulated;
-}
-
-bool ActorDefinition::CanBeAI() const
-{
-    return m_AIElement.m_aiEnabled;
-}
-
-void ActorDefinition::AddGroupDefinition(SpriteSheet* const& sheet, Texture* const& texture, XmlElement* const& element)
-{
-	NamedStrings animGroupAttributes;
-	animGroupAttributes.PopulateFromXmlElementAttributes(*element);
-    AnimationGroupDefinition* newGroup = new AnimationGroupDefinition();
-    newGroup->m_name = animGroupAttributes.GetValue("name", "-");
-    newGroup->m_playbackMode = animGroupAttributes.GetValue("playbackMode", "Once");
-    newGroup->m_scaleBySpeed = animGroupAttributes.GetValue("scaleBySpeed", false);
-    newGroup->m_secondsPerFrame = animGroupAttributes.GetValue("secondsPerFrame", 1.f);
-
-    XmlElement* child = element->FirstChildElement();
-    while (child)
-    {
-        newGroup->AddDirectionAnimation(child, sheet, texture);
-        child = child->NextSiblingElement();
-    }
-
-    m_VisualElement.m_groupDefinitions.push_back(newGroup);
-}
\ No newline at end of file
+#include "ActorDefinition.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "AnimationGroupDefinition.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/VertexUtils.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+float ActorDefinition::GetHeight() const
+{
+    return m_collisionElement.m_physicsHeight;
+}
+
+float ActorDefinition::GetRadius() const
+{
+    return m_collisionElement.m_physicsRadius;
+}
+
+Faction ActorDefinition::GetFaction() const
+{
+    return m_faction;
+}
+
+bool ActorDefinition::IsSimulated() const
+{
+    return m_physicsElement.m_simulated;
+}
+
+bool ActorDefinition::CanBeAI() const
+{
+    return m_AIElement.m_aiEnabled;
+}
+
+void ActorDefinition::AddGroupDefinition(SpriteSheet* const& sheet, Texture* const& texture, XmlElement* const& element)
+{
+	NamedStrings animGroupAttributes;
+	animGroupAttributes.PopulateFromXmlElementAttributes(*element);
+    AnimationGroupDefinition* newGroup = new AnimationGroupDefinition();
+    newGroup->m_name = animGroupAttributes.GetValue("name", "-");
+    newGroup->m_playbackMode = animGroupAttributes.GetValue("playbackMode", "Once");
+    newGroup->m_scaleBySpeed = animGroupAttributes.GetValue("scaleBySpeed", false);
+    newGroup->m_secondsPerFrame = animGroupAttributes.GetValue("secondsPerFrame", 1.f);
+
+    XmlElement* child = element->FirstChildElement();
+    while (child)
+    {
+        newGroup->AddDirectionAnimation(child, sheet, texture);
+        child = child->NextSiblingElement();
+    }
+
+    m_VisualElement.m_groupDefinitions.push_back(newGroup);
+}
+
+AnimationGroupDefinition* ActorDefinition::GetGroupDefinition(std::string const& name) const
+{
+	for (int i = 0; i < (int)m_VisualElement.m_groupDefinitions.size(); i++)
+	{
+		if (m_VisualElement.m_groupDefinitions[i]->m_name == name)
+		{
+			return m_VisualElement.m_groupDefinitions[i];
+		}
+	}
+	return nullptr;
+}
+
+void ActorDefinition::AddVertsForBillboard(std::vector<Vertex_PCUTBN>& verts, Mat44 const& cameraTransform, Vec3 const& position, AABB2 const& UVs, Rgba8 const& color) const
+{
+	//Same quad and pivot as Actor::AddCurrentAnimationFrame, but baked into world space for batching
+	Vec2 spriteDims = m_VisualElement.m_spriteWorldSize;
+	Vec3 pivotPoint = Vec3(0, spriteDims.x * (.5f - m_VisualElement.m_pivot.x), spriteDims.y * (.5f - m_VisualElement.m_pivot.y));
+	Mat44 transform = GetBillboardTransform(m_VisualElement.m_billBoardType, cameraTransform, position, spriteDims);
+	transform.AppendTranslation3D(pivotPoint);
+
+	AddVertsForQuad3D(verts,
+		transform.TransformPosition3D(Vec3(0, 0, 0)), transform.TransformPosition3D(Vec3(0, spriteDims.x, 0)),
+		transform.TransformPosition3D(Vec3(0, spriteDims.x, spriteDims.y)), transform.TransformPosition3D(Vec3(0, 0, spriteDims.y)),
+		transform.TransformVectorQuantity3D(Vec3(1, 0, 0)), color, UVs);
+}
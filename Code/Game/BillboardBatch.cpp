@@ -0,0 +1,252 @@
+#include "BillboardBatch.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/TextureAtlas.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/FrameArena.hpp"
+#include <cstring>
+
+void BillboardBatch::Begin(Mat44 const& cameraTransform)
+{
+	m_cameraPosition = cameraTransform.TransformPosition3D(Vec3(0.f, 0.f, 0.f));
+	m_cameraForward = cameraTransform.TransformVectorQuantity3D(Vec3(1.f, 0.f, 0.f)).GetNormalized();
+	for (int i = 0; i < (int)m_groups.size(); i++)
+	{
+		m_groups[i].m_verts.clear();
+	}
+	m_sprites.clear();
+	m_runs.clear();
+}
+
+void BillboardBatch::AddVerts(const Texture* texture, Shader* shader, std::vector<Vertex_PCUTBN> const& localVerts, Mat44 const& transform, Rgba8 const& color)
+{
+	//Sheets packed into the sprite atlas draw from the shared page instead
+	const Texture* groupTexture = (g_theSpriteAtlas != nullptr) ? g_theSpriteAtlas->GetAtlasTexture(texture) : texture;
+	int groupIndex = GetGroupIndex(groupTexture, shader);
+	std::vector<Vertex_PCUTBN>& verts = m_groups[groupIndex].m_verts;
+	int firstVert = (int)verts.size();
+	for (int i = 0; i < (int)localVerts.size(); i++)
+	{
+		//Bake what used to be the per-draw model constants into the vertex
+		Vertex_PCUTBN vert = localVerts[i];
+		if (groupTexture != texture)
+		{
+			vert.m_uvTexCoords = g_theSpriteAtlas->RemapUV(texture, vert.m_uvTexCoords);
+		}
+		vert.m_position = transform.TransformPosition3D(vert.m_position);
+		vert.m_tangent = transform.TransformVectorQuantity3D(vert.m_tangent);
+		vert.m_bitangent = transform.TransformVectorQuantity3D(vert.m_bitangent);
+		vert.m_normal = transform.TransformVectorQuantity3D(vert.m_normal);
+		vert.m_color = Rgba8((unsigned char)((vert.m_color.r * color.r) / 255), (unsigned char)((vert.m_color.g * color.g) / 255),
+			(unsigned char)((vert.m_color.b * color.b) / 255), (unsigned char)((vert.m_color.a * color.a) / 255));
+		verts.push_back(vert);
+	}
+	AddSprite(groupIndex, firstVert);
+}
+
+void BillboardBatch::AddBillboard(const ActorDefinition* definition, Mat44 const& cameraTransform, Vec3 const& position, AABB2 const& UVs, Rgba8 const& color)
+{
+	ActorVisuals const& visuals = definition->m_VisualElement;
+	const Texture* texture = (visuals.m_sheet != nullptr) ? &visuals.m_sheet->GetTexture() : nullptr;
+	int groupIndex = 0;
+	int firstVert = 0;
+	if (g_theSpriteAtlas != nullptr)
+	{
+		groupIndex = GetGroupIndex(g_theSpriteAtlas->GetAtlasTexture(texture), visuals.m_shader);
+		firstVert = (int)m_groups[groupIndex].m_verts.size();
+		definition->AddVertsForBillboard(m_groups[groupIndex].m_verts, cameraTransform, position, g_theSpriteAtlas->RemapUVs(texture, UVs), color);
+	}
+	else
+	{
+		groupIndex = GetGroupIndex(texture, visuals.m_shader);
+		firstVert = (int)m_groups[groupIndex].m_verts.size();
+		definition->AddVertsForBillboard(m_groups[groupIndex].m_verts, cameraTransform, position, UVs, color);
+	}
+	AddSprite(groupIndex, firstVert);
+}
+
+void BillboardBatch::Append(BillboardBatch const& other)
+{
+	//Sprites keep the depth the other batch measured, so both must have begun with the same camera
+	int firstSprite = (int)m_sprites.size();
+	FrameVector<int> groupRemap(other.m_groups.size());
+	FrameVector<int> vertOffsets(other.m_groups.size());
+	for (int i = 0; i < (int)other.m_groups.size(); i++)
+	{
+		BillboardGroup const& otherGroup = other.m_groups[i];
+		groupRemap[i] = GetGroupIndex(otherGroup.m_texture, otherGroup.m_shader);
+		std::vector<Vertex_PCUTBN>& verts = m_groups[groupRemap[i]].m_verts;
+		vertOffsets[i] = (int)verts.size();
+		verts.insert(verts.end(), otherGroup.m_verts.begin(), otherGroup.m_verts.end());
+	}
+
+	m_sprites.insert(m_sprites.end(), other.m_sprites.begin(), other.m_sprites.end());
+	for (int i = firstSprite; i < (int)m_sprites.size(); i++)
+	{
+		BillboardSprite& sprite = m_sprites[i];
+		sprite.m_firstVert += vertOffsets[sprite.m_group];
+		sprite.m_group = groupRemap[sprite.m_group];
+	}
+}
+
+void BillboardBatch::End()
+{
+	SortSpritesBackToFront();
+
+	//Walk far to near, starting a new run whenever the group changes
+	m_sortedVerts.clear();
+	for (int i = 0; i < (int)m_sortEntries.size(); i++)
+	{
+		BillboardSprite const& sprite = m_sprites[m_sortEntries[i].m_spriteIndex];
+		if (m_runs.empty() || m_runs.back().m_group != sprite.m_group)
+		{
+			BillboardRun run;
+			run.m_group = sprite.m_group;
+			run.m_firstVert = (int)m_sortedVerts.size();
+			run.m_depth = sprite.m_depth;
+			m_runs.push_back(run);
+		}
+
+		std::vector<Vertex_PCUTBN> const& groupVerts = m_groups[sprite.m_group].m_verts;
+		m_sortedVerts.insert(m_sortedVerts.end(), groupVerts.begin() + sprite.m_firstVert, groupVerts.begin() + sprite.m_firstVert + sprite.m_numVerts);
+		m_runs.back().m_numVerts += sprite.m_numVerts;
+	}
+}
+
+void BillboardBatch::Submit(RenderQueue& queue, ConstantBuffer* lightBuffer) const
+{
+	for (int i = 0; i < (int)m_runs.size(); i++)
+	{
+		BillboardRun const& run = m_runs[i];
+		BillboardGroup const& group = m_groups[run.m_group];
+
+		RenderCommand command;
+		command.m_pass = RenderPass::TRANSLUCENT;
+		command.m_type = RenderCommandType::VERTEX_STREAM;
+		command.m_sortDepth = run.m_depth;
+		command.m_texture = group.m_texture;
+		command.m_shader = group.m_shader;
+		command.m_streamVerts = &m_sortedVerts[run.m_firstVert];
+		command.m_lightBuffer = lightBuffer;
+		command.m_count = run.m_numVerts;
+		queue.Submit(command);
+	}
+}
+
+int BillboardBatch::GetNumDrawCalls() const
+{
+	return (int)m_runs.size();
+}
+
+int BillboardBatch::GetNumSprites() const
+{
+	return (int)m_sprites.size();
+}
+
+int BillboardBatch::GetNumVerts() const
+{
+	return (int)m_sortedVerts.size();
+}
+
+int BillboardBatch::GetGroupIndex(const Texture* texture, Shader* shader)
+{
+	for (int i = 0; i < (int)m_groups.size(); i++)
+	{
+		if (m_groups[i].m_texture == texture && m_groups[i].m_shader == shader)
+		{
+			return i;
+		}
+	}
+
+	BillboardGroup group;
+	group.m_texture = texture;
+	group.m_shader = shader;
+	m_groups.push_back(group);
+	return (int)m_groups.size() - 1;
+}
+
+void BillboardBatch::AddSprite(int groupIndex, int firstVert)
+{
+	std::vector<Vertex_PCUTBN>& verts = m_groups[groupIndex].m_verts;
+	int numVerts = (int)verts.size() - firstVert;
+	if (numVerts <= 0)
+	{
+		return;
+	}
+
+	Vec3 center;
+	for (int i = firstVert; i < (int)verts.size(); i++)
+	{
+		center += verts[i].m_position;
+	}
+	center /= (float)numVerts;
+	float radius = 0.f;
+	for (int i = firstVert; i < (int)verts.size(); i++)
+	{
+		float distance = (verts[i].m_position - center).GetLength();
+		radius = (distance > radius) ? distance : radius;
+	}
+
+	//Entirely behind the camera, drop the verts again
+	float depth = DotProduct3D(center - m_cameraPosition, m_cameraForward);
+	if (depth + radius < 0.f)
+	{
+		verts.resize(firstVert);
+		return;
+	}
+
+	BillboardSprite sprite;
+	sprite.m_group = groupIndex;
+	sprite.m_firstVert = firstVert;
+	sprite.m_numVerts = numVerts;
+	sprite.m_depth = depth;
+	m_sprites.push_back(sprite);
+}
+
+void BillboardBatch::SortSpritesBackToFront()
+{
+	//Non-negative floats order the same as their bits, so flipping them gives far-to-near keys
+	m_sortEntries.resize(m_sprites.size());
+	for (int i = 0; i < (int)m_sprites.size(); i++)
+	{
+		float depth = (m_sprites[i].m_depth > 0.f) ? m_sprites[i].m_depth : 0.f;
+		uint32_t depthBits = 0;
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+		m_sortEntries[i].m_key = ~depthBits;
+		m_sortEntries[i].m_spriteIndex = i;
+	}
+	if (m_sortEntries.empty())
+	{
+		return;
+	}
+
+	//LSD radix sort a byte at a time; stable, so sprites at equal depth keep their submission order
+	m_scratchEntries.resize(m_sortEntries.size());
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		int counts[257] = {};
+		for (int i = 0; i < (int)m_sortEntries.size(); i++)
+		{
+			counts[((m_sortEntries[i].m_key >> shift) & 0xFF) + 1]++;
+		}
+		if (counts[((m_sortEntries[0].m_key >> shift) & 0xFF) + 1] == (int)m_sortEntries.size())
+		{
+			continue;
+		}
+
+		for (int bucket = 1; bucket < 257; bucket++)
+		{
+			counts[bucket] += counts[bucket - 1];
+		}
+		for (int i = 0; i < (int)m_sortEntries.size(); i++)
+		{
+			int bucket = (int)((m_sortEntries[i].m_key >> shift) & 0xFF);
+			m_scratchEntries[counts[bucket]++] = m_sortEntries[i];
+		}
+		m_sortEntries.swap(m_scratchEntries);
+	}
+}
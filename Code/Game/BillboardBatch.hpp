@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Game/ActorHandle.hpp"
+
+class Texture;
+class Shader;
+class RenderQueue;
+class ConstantBuffer;
+struct AABB2;
+class ActorDefinition;
+
+//The camera a view's billboards are built for, handed in so vertex work never reads the game or player
+struct BillboardView
+{
+	Mat44		m_cameraTransform;
+	Vec3		m_cameraPosition;
+	EulerAngles	m_cameraOrientation;
+	float		m_fovDegrees = 60.f;
+	float		m_aspect = 1.f;
+	ActorHandle	m_hiddenActor = ActorHandle::INVALID;
+};
+
+//All sprites sharing a sheet and shader, already in world space
+struct BillboardGroup
+{
+	const Texture*				m_texture = nullptr;
+	Shader*						m_shader = nullptr;
+	std::vector<Vertex_PCUTBN>	m_verts;
+};
+
+//One visible sprite's verts inside its group, with its distance along the view
+struct BillboardSprite
+{
+	int		m_group = 0;
+	int		m_firstVert = 0;
+	int		m_numVerts = 0;
+	float	m_depth = 0.f;
+};
+
+struct BillboardSortEntry
+{
+	uint32_t	m_key = 0;
+	int			m_spriteIndex = 0;
+};
+
+//Consecutive back-to-front sprites that share a group draw together
+struct BillboardRun
+{
+	int		m_group = 0;
+	int		m_firstVert = 0;
+	int		m_numVerts = 0;
+	float	m_depth = 0.f;
+};
+
+class BillboardBatch
+{
+public:
+	BillboardBatch() = default;
+	~BillboardBatch() = default;
+
+	void						Begin(Mat44 const& cameraTransform);
+	void						AddVerts(const Texture* texture, Shader* shader, std::vector<Vertex_PCUTBN> const& localVerts, Mat44 const& transform, Rgba8 const& color);
+	void						AddBillboard(const ActorDefinition* definition, Mat44 const& cameraTransform, Vec3 const& position, AABB2 const& UVs, Rgba8 const& color);
+	void						Append(BillboardBatch const& other);
+	void						End();
+	void						Submit(RenderQueue& queue, ConstantBuffer* lightBuffer) const;
+	int							GetNumDrawCalls() const;
+	int							GetNumSprites() const;
+	int							GetNumVerts() const;
+
+private:
+	int							GetGroupIndex(const Texture* texture, Shader* shader);
+	void						AddSprite(int groupIndex, int firstVert);
+	void						SortSpritesBackToFront();
+
+	//Everything below persists across frames and is only emptied, so a steady frame allocates nothing
+	std::vector<BillboardGroup>		m_groups;
+	std::vector<BillboardSprite>	m_sprites;
+	std::vector<BillboardSortEntry>	m_sortEntries;
+	std::vector<BillboardSortEntry>	m_scratchEntries;
+	std::vector<Vertex_PCUTBN>		m_sortedVerts;
+	std::vector<BillboardRun>		m_runs;
+
+	Vec3							m_cameraPosition;
+	Vec3							m_cameraForward = Vec3(1.f, 0.f, 0.f);
+};
@@ -0,0 +1,144 @@
+#include "CompactMapMesh.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <cmath>
+
+constexpr float POSITION_SCALE = 64.f;
+constexpr float UV_SCALE = 65535.f;
+constexpr int MAX_FRAMES = 256;
+
+bool CompactMapMesh::Encode(std::vector<Vertex_PCUTBN> const& verts, Vec3 const& origin)
+{
+	Clear();
+	m_origin = origin;
+	m_verts.resize(verts.size());
+	for (int i = 0; i < (int)verts.size(); i++)
+	{
+		Vertex_PCUTBN const& vert = verts[i];
+		Vertex_MapCompact& compact = m_verts[i];
+
+		//Anything off the 1/64 grid or more than 511 tiles from the origin can't round-trip, so the map keeps full vertices instead
+		float const position[3] = { vert.m_position.x - origin.x, vert.m_position.y - origin.y, vert.m_position.z - origin.z };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float scaled = position[axis] * POSITION_SCALE;
+			float rounded = roundf(scaled);
+			if (rounded < -32768.f || rounded > 32767.f || fabsf(scaled - rounded) > .01f)
+			{
+				Clear();
+				return false;
+			}
+			compact.m_position[axis] = (int16_t)rounded;
+		}
+
+		int frameIndex = GetOrAddFrame(vert);
+		if (frameIndex < 0)
+		{
+			Clear();
+			return false;
+		}
+		compact.m_frameIndex = (uint8_t)frameIndex;
+
+		//Sheet UVs sit in [0,1]; 16 bits is finer than any texel of the sheet
+		float u = (vert.m_uvTexCoords.x < 0.f) ? 0.f : ((vert.m_uvTexCoords.x > 1.f) ? 1.f : vert.m_uvTexCoords.x);
+		float v = (vert.m_uvTexCoords.y < 0.f) ? 0.f : ((vert.m_uvTexCoords.y > 1.f) ? 1.f : vert.m_uvTexCoords.y);
+		compact.m_uvTexCoords[0] = (uint16_t)roundf(u * UV_SCALE);
+		compact.m_uvTexCoords[1] = (uint16_t)roundf(v * UV_SCALE);
+		compact.m_color = vert.m_color;
+	}
+	return true;
+}
+
+void CompactMapMesh::Decode(std::vector<Vertex_PCUTBN>& out_verts) const
+{
+	out_verts.resize(m_verts.size());
+	for (int i = 0; i < (int)m_verts.size(); i++)
+	{
+		Vertex_MapCompact const& compact = m_verts[i];
+		MapVertexFrame const& frame = m_frames[compact.m_frameIndex];
+		Vertex_PCUTBN& vert = out_verts[i];
+		vert.m_position = m_origin + Vec3((float)compact.m_position[0] / POSITION_SCALE, (float)compact.m_position[1] / POSITION_SCALE, (float)compact.m_position[2] / POSITION_SCALE);
+		vert.m_color = compact.m_color;
+		vert.m_uvTexCoords = Vec2((float)compact.m_uvTexCoords[0] / UV_SCALE, (float)compact.m_uvTexCoords[1] / UV_SCALE);
+		vert.m_tangent = frame.m_tangent;
+		vert.m_bitangent = frame.m_bitangent;
+		vert.m_normal = frame.m_normal;
+	}
+}
+
+void CompactMapMesh::GetGPUVerts(std::vector<unsigned char> const& frameRemap, std::vector<Vertex_PCU>& out_verts) const
+{
+	out_verts.resize(m_verts.size());
+	for (int i = 0; i < (int)m_verts.size(); i++)
+	{
+		Vertex_MapCompact const& compact = m_verts[i];
+		Vertex_PCU& vert = out_verts[i];
+		vert.m_position = Vec3((float)compact.m_position[0] / POSITION_SCALE, (float)compact.m_position[1] / POSITION_SCALE, (float)compact.m_position[2] / POSITION_SCALE);
+		vert.m_color = Rgba8(compact.m_color.r, compact.m_color.g, compact.m_color.b, frameRemap[compact.m_frameIndex]);
+		vert.m_uvTexCoords = Vec2((float)compact.m_uvTexCoords[0] / UV_SCALE, (float)compact.m_uvTexCoords[1] / UV_SCALE);
+	}
+}
+
+void CompactMapMesh::Clear()
+{
+	m_verts.clear();
+	m_frames.clear();
+	m_origin = Vec3();
+}
+
+std::vector<Vertex_MapCompact> const& CompactMapMesh::GetVerts() const
+{
+	return m_verts;
+}
+
+std::vector<MapVertexFrame> const& CompactMapMesh::GetFrames() const
+{
+	return m_frames;
+}
+
+int CompactMapMesh::GetNumVerts() const
+{
+	return (int)m_verts.size();
+}
+
+int CompactMapMesh::GetNumFrames() const
+{
+	return (int)m_frames.size();
+}
+
+size_t CompactMapMesh::GetNumBytes() const
+{
+	return (m_verts.size() * sizeof(Vertex_MapCompact)) + (m_frames.size() * sizeof(MapVertexFrame));
+}
+
+size_t CompactMapMesh::GetNumUncompressedBytes() const
+{
+	return m_verts.size() * sizeof(Vertex_PCUTBN);
+}
+
+size_t CompactMapMesh::GetNumGPUBytes() const
+{
+	return m_verts.size() * sizeof(Vertex_PCU);
+}
+
+int CompactMapMesh::GetOrAddFrame(Vertex_PCUTBN const& vert)
+{
+	for (int i = 0; i < (int)m_frames.size(); i++)
+	{
+		MapVertexFrame const& frame = m_frames[i];
+		if (frame.m_normal == vert.m_normal && frame.m_tangent == vert.m_tangent && frame.m_bitangent == vert.m_bitangent)
+		{
+			return i;
+		}
+	}
+	if ((int)m_frames.size() >= MAX_FRAMES)
+	{
+		return -1;
+	}
+
+	MapVertexFrame frame;
+	frame.m_tangent = vert.m_tangent;
+	frame.m_bitangent = vert.m_bitangent;
+	frame.m_normal = vert.m_normal;
+	m_frames.push_back(frame);
+	return (int)m_frames.size() - 1;
+}
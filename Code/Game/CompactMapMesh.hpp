@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+//Static map vertex: positions in 1/64ths of a tile from the mesh origin, an index into the mesh's tangent frames, unorm UVs and the baked colour.
+//16 bytes against the 60 of a Vertex_PCUTBN.
+struct Vertex_MapCompact
+{
+	int16_t		m_position[3] = {};
+	uint8_t		m_frameIndex = 0;
+	uint8_t		m_padding = 0;
+	uint16_t	m_uvTexCoords[2] = {};
+	Rgba8		m_color;
+};
+
+//Walls, floors and ceilings only ever face a few ways, so whole frames are shared instead of stored per vertex
+struct MapVertexFrame
+{
+	Vec3	m_tangent;
+	Vec3	m_bitangent;
+	Vec3	m_normal;
+};
+
+//The frame table the compact map shader reads from register b4, one float4 per vector to match HLSL packing
+constexpr int MAX_MAP_VERTEX_FRAMES = 64;
+struct MapVertexFrameConstants
+{
+	float	c_tangents[MAX_MAP_VERTEX_FRAMES][4] = {};
+	float	c_bitangents[MAX_MAP_VERTEX_FRAMES][4] = {};
+	float	c_normals[MAX_MAP_VERTEX_FRAMES][4] = {};
+};
+
+class CompactMapMesh
+{
+public:
+	CompactMapMesh() = default;
+	~CompactMapMesh() = default;
+
+	bool									Encode(std::vector<Vertex_PCUTBN> const& verts, Vec3 const& origin);
+	void									Decode(std::vector<Vertex_PCUTBN>& out_verts) const;
+	void									Clear();
+
+	//The engine's input layouts stop at PCU and PCUTBN, so the GPU copy rides the 24-byte PCU layout: positions relative to
+	//the origin, the baked colour with the frame index in alpha, and plain UVs. frameRemap maps this mesh's frames to the bound table.
+	void									GetGPUVerts(std::vector<unsigned char> const& frameRemap, std::vector<Vertex_PCU>& out_verts) const;
+
+	std::vector<Vertex_MapCompact> const&	GetVerts() const;
+	std::vector<MapVertexFrame> const&		GetFrames() const;
+	int										GetNumVerts() const;
+	int										GetNumFrames() const;
+	size_t									GetNumBytes() const;
+	size_t									GetNumUncompressedBytes() const;
+	size_t									GetNumGPUBytes() const;
+
+private:
+	int										GetOrAddFrame(Vertex_PCUTBN const& vert);
+
+	std::vector<Vertex_MapCompact>			m_verts;
+	std::vector<MapVertexFrame>				m_frames;
+	Vec3									m_origin;
+};
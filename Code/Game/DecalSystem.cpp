@@ -0,0 +1,238 @@
+#include "DecalSystem.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/VertexUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/AnimationGroupDefinition.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/RenderBackend.hpp"
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+constexpr float DECAL_SURFACE_OFFSET = .005f;
+
+DecalSystem::DecalSystem(Map* map)
+{
+	m_map = map;
+	m_capacity = g_gameConfigBlackboard->GetValue("maxDecals", 4096);
+	if (m_capacity < 1)
+	{
+		m_capacity = 1;
+	}
+	m_decalsPerPage = g_gameConfigBlackboard->GetValue("decalsPerPage", 256);
+	if (m_decalsPerPage < 1)
+	{
+		m_decalsPerPage = 1;
+	}
+}
+
+DecalSystem::~DecalSystem()
+{
+	for (int i = 0; i < (int)m_layers.size(); i++)
+	{
+		for (int page = 0; page < (int)m_layers[i].m_pageBuffers.size(); page++)
+		{
+			delete m_layers[i].m_pageBuffers[page];
+		}
+	}
+	m_layers.clear();
+	m_map = nullptr;
+}
+
+void DecalSystem::AddDecal(const ActorDefinition* definition, Vec3 const& position, Vec3 const& normal)
+{
+	if (definition == nullptr || normal == Vec3())
+	{
+		return;
+	}
+	DecalLayer& layer = m_layers[GetOrCreateLayer(definition)];
+
+	//Surface basis with right x up == normal, matching the winding of the map geometry
+	Vec3 forward = normal.GetNormalized();
+	Vec3 up = (fabsf(forward.z) > .5f) ? Vec3(0.f, 1.f, 0.f) : Vec3(0.f, 0.f, 1.f);
+	Vec3 right = CrossProduct3D(up, forward).GetNormalized();
+	up = CrossProduct3D(forward, right);
+
+	Vec2 halfSize = definition->m_VisualElement.m_spriteWorldSize * .5f;
+	Vec2 clipMins;
+	Vec2 clipMaxs;
+	GetClipRangeOnSurface(position, forward, right, up, clipMins, clipMaxs);
+	Vec2 mins = Vec2((clipMins.x > -halfSize.x) ? clipMins.x : -halfSize.x, (clipMins.y > -halfSize.y) ? clipMins.y : -halfSize.y);
+	Vec2 maxs = Vec2((clipMaxs.x < halfSize.x) ? clipMaxs.x : halfSize.x, (clipMaxs.y < halfSize.y) ? clipMaxs.y : halfSize.y);
+	if (mins.x >= maxs.x || mins.y >= maxs.y)
+	{
+		return;
+	}
+
+	//Clipped corners keep the part of the texture they covered
+	AABB2 UVs;
+	UVs.m_mins.x = RangeMap(mins.x, -halfSize.x, halfSize.x, layer.m_UVs.m_mins.x, layer.m_UVs.m_maxs.x);
+	UVs.m_maxs.x = RangeMap(maxs.x, -halfSize.x, halfSize.x, layer.m_UVs.m_mins.x, layer.m_UVs.m_maxs.x);
+	UVs.m_mins.y = RangeMap(mins.y, -halfSize.y, halfSize.y, layer.m_UVs.m_mins.y, layer.m_UVs.m_maxs.y);
+	UVs.m_maxs.y = RangeMap(maxs.y, -halfSize.y, halfSize.y, layer.m_UVs.m_mins.y, layer.m_UVs.m_maxs.y);
+
+	Vec3 center = position + forward * DECAL_SURFACE_OFFSET;
+	//The quad is built in a reused buffer so placing a decal never allocates once the ring exists
+	m_quadVerts.clear();
+	AddVertsForQuad3D(m_quadVerts,
+		center + right * mins.x + up * mins.y, center + right * maxs.x + up * mins.y,
+		center + right * maxs.x + up * maxs.y, center + right * mins.x + up * maxs.y,
+		forward, Rgba8::WHITE, UVs);
+
+	//Overwrite the oldest slot once the ring is full
+	int vertsPerDecal = (int)m_quadVerts.size();
+	if ((int)layer.m_verts.size() != m_capacity * vertsPerDecal)
+	{
+		layer.m_verts.resize(m_capacity * vertsPerDecal);
+	}
+	int firstVert = layer.m_nextDecal * vertsPerDecal;
+	for (int i = 0; i < vertsPerDecal; i++)
+	{
+		layer.m_verts[firstVert + i] = m_quadVerts[i];
+	}
+	layer.m_isPageDirty[layer.m_nextDecal / m_decalsPerPage] = 1;
+	layer.m_nextDecal = (layer.m_nextDecal + 1) % m_capacity;
+	if (layer.m_numDecals < m_capacity)
+	{
+		layer.m_numDecals++;
+	}
+}
+
+void DecalSystem::Submit(RenderQueue& queue, ConstantBuffer* lightBuffer)
+{
+	for (int i = 0; i < (int)m_layers.size(); i++)
+	{
+		DecalLayer& layer = m_layers[i];
+		if (layer.m_numDecals == 0)
+		{
+			continue;
+		}
+
+		//Live decals always fill slots [0, m_numDecals), since the ring only wraps once it is full
+		ActorVisuals const& visuals = layer.m_definition->m_VisualElement;
+		int vertsPerDecal = (int)(layer.m_verts.size() / m_capacity);
+		for (int page = 0; page * m_decalsPerPage < layer.m_numDecals; page++)
+		{
+			int firstDecal = page * m_decalsPerPage;
+			int numDecals = layer.m_numDecals - firstDecal;
+			numDecals = (numDecals < m_decalsPerPage) ? numDecals : m_decalsPerPage;
+
+			RenderCommand command;
+			command.m_pass = RenderPass::DECALS;
+			command.m_type = RenderCommandType::VERTEX_BUFFER;
+			command.m_texture = visuals.m_sheet ? &visuals.m_sheet->GetTexture() : nullptr;
+			command.m_shader = visuals.m_shader;
+			command.m_modelColor = layer.m_definition->m_color;
+			command.m_vertexBuffer = layer.m_pageBuffers[page];
+			command.m_lightBuffer = lightBuffer;
+			command.m_count = vertsPerDecal * numDecals;
+
+			//Uploaded with the first view that draws it; later views in the frame reuse the buffer
+			if (layer.m_isPageDirty[page] != 0)
+			{
+				queue.SubmitUpload(command.m_vertexBuffer, layer.m_verts.data() + (firstDecal * vertsPerDecal), (unsigned int)command.m_count);
+				layer.m_isPageDirty[page] = 0;
+			}
+			queue.Submit(command);
+		}
+	}
+}
+
+void DecalSystem::Clear()
+{
+	for (int i = 0; i < (int)m_layers.size(); i++)
+	{
+		m_layers[i].m_nextDecal = 0;
+		m_layers[i].m_numDecals = 0;
+		for (int page = 0; page < (int)m_layers[i].m_isPageDirty.size(); page++)
+		{
+			m_layers[i].m_isPageDirty[page] = 0;
+		}
+	}
+}
+
+int DecalSystem::GetNumDecals() const
+{
+	int numDecals = 0;
+	for (int i = 0; i < (int)m_layers.size(); i++)
+	{
+		numDecals += m_layers[i].m_numDecals;
+	}
+	return numDecals;
+}
+
+int DecalSystem::GetOrCreateLayer(const ActorDefinition* definition)
+{
+	for (int i = 0; i < (int)m_layers.size(); i++)
+	{
+		if (m_layers[i].m_definition == definition)
+		{
+			return i;
+		}
+	}
+
+	//The mark is the first frame of the effect's Death animation
+	DecalLayer layer;
+	layer.m_definition = definition;
+	AnimationGroupDefinition* animation = definition->GetGroupDefinition("Death");
+	if (animation != nullptr && !animation->m_directionAnims.empty())
+	{
+		layer.m_UVs = animation->m_directionAnims[0].m_animation->GetSpriteDefAtTime(0.f).GetUVs();
+	}
+	int numPages = (m_capacity + m_decalsPerPage - 1) / m_decalsPerPage;
+	layer.m_pageBuffers.resize(numPages);
+	layer.m_isPageDirty.resize(numPages, 0);
+	for (int page = 0; page < numPages; page++)
+	{
+		layer.m_pageBuffers[page] = g_theRenderBackend->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+	}
+	m_layers.push_back(layer);
+	return (int)m_layers.size() - 1;
+}
+
+void DecalSystem::GetClipRangeOnSurface(Vec3 const& position, Vec3 const& normal, Vec3 const& right, Vec3 const& up, Vec2& out_mins, Vec2& out_maxs) const
+{
+	out_mins = Vec2(-999999.f, -999999.f);
+	out_maxs = Vec2(999999.f, 999999.f);
+
+	//Floor and ceiling are continuous, solid tiles cover whatever hangs under them
+	if (fabsf(normal.z) > .5f)
+	{
+		return;
+	}
+
+	//Walls stop at the floor and ceiling
+	float ceiling = m_map->m_definition->m_ceilingHeight;
+	float zMin = -position.z;
+	float zMax = ceiling - position.z;
+	out_mins.y = (up.z > 0.f) ? zMin : -zMax;
+	out_maxs.y = (up.z > 0.f) ? zMax : -zMin;
+
+	//Sideways, the face ends at the tile edge unless the wall carries on into the next tile
+	Vec3 behind = position - normal * .01f;
+	int tileX = (int)floorf(behind.x);
+	int tileY = (int)floorf(behind.y);
+	int normalX = (int)roundf(normal.x);
+	int normalY = (int)roundf(normal.y);
+	int stepX = (int)roundf(right.x);
+	int stepY = (int)roundf(right.y);
+	float alongPosition = (stepX != 0) ? position.x * (float)stepX : position.y * (float)stepY;
+	float faceStart = (stepX != 0) ? (float)tileX : (float)tileY;
+	float faceMin = ((stepX + stepY) > 0) ? faceStart : -(faceStart + 1.f);
+	float faceMax = faceMin + 1.f;
+
+	bool continuesRight = m_map->IsTileSolid(tileX + stepX, tileY + stepY) && !m_map->IsTileSolid(tileX + stepX + normalX, tileY + stepY + normalY);
+	bool continuesLeft = m_map->IsTileSolid(tileX - stepX, tileY - stepY) && !m_map->IsTileSolid(tileX - stepX + normalX, tileY - stepY + normalY);
+	if (!continuesLeft)
+	{
+		out_mins.x = faceMin - alongPosition;
+	}
+	if (!continuesRight)
+	{
+		out_maxs.x = faceMax - alongPosition;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+class Map;
+class VertexBuffer;
+class RenderQueue;
+class ActorDefinition;
+class ConstantBuffer;
+
+//One ring of decal quads per decal definition, since each definition draws with its own texture and color.
+//The ring is split into pages with a buffer each: the engine only rewrites whole buffers, so a new decal re-uploads its page, not the ring
+struct DecalLayer
+{
+	const ActorDefinition*		m_definition = nullptr;
+	AABB2						m_UVs = AABB2(Vec2(0.f, 0.f), Vec2(1.f, 1.f));
+	std::vector<Vertex_PCUTBN>	m_verts;
+	std::vector<VertexBuffer*>	m_pageBuffers;
+	std::vector<unsigned char>	m_isPageDirty;
+	int							m_nextDecal = 0;
+	int							m_numDecals = 0;
+};
+
+class DecalSystem
+{
+public:
+	DecalSystem(Map* map);
+	~DecalSystem();
+
+	void AddDecal(const ActorDefinition* definition, Vec3 const& position, Vec3 const& normal);
+	void Submit(RenderQueue& queue, ConstantBuffer* lightBuffer);
+	void Clear();
+	int  GetNumDecals() const;
+
+private:
+	int  GetOrCreateLayer(const ActorDefinition* definition);
+	void GetClipRangeOnSurface(Vec3 const& position, Vec3 const& normal, Vec3 const& right, Vec3 const& up, Vec2& out_mins, Vec2& out_maxs) const;
+
+	Map*					m_map = nullptr;
+	int						m_capacity = 0;
+	int						m_decalsPerPage = 0;
+	std::vector<DecalLayer>	m_layers;
+	std::vector<Vertex_PCUTBN>	m_quadVerts;
+};
@@ -0,0 +1,853 @@
+#include "DefinitionCache.hpp"
+#include "Game/Game.hpp"
+#include "Game/TileDefinition.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/WeaponDefinition.hpp"
+#include "Game/AnimationGroupDefinition.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+#include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+
+extern Renderer* g_theRenderer;
+
+constexpr uint32_t DEFINITION_CACHE_MAGIC = 0x43464444;	//"DDFC"
+constexpr uint32_t DEFINITION_CACHE_VERSION = 2;
+constexpr char const* DEFINITION_SOURCE_DIRECTORY = "Data/Definitions";
+
+//The whole cache is built in memory and written once, and read back the same way
+struct DefinitionCacheWriter
+{
+	std::vector<unsigned char>	m_bytes;
+};
+
+struct DefinitionCacheReader
+{
+	std::vector<unsigned char>	m_bytes;
+	size_t						m_offset = 0;
+	bool						m_isValid = true;
+};
+
+template <typename T>
+static void WriteValue(DefinitionCacheWriter& writer, T const& value)
+{
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(&value);
+	writer.m_bytes.insert(writer.m_bytes.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static void ReadValue(DefinitionCacheReader& reader, T& out_value)
+{
+	if (!reader.m_isValid || reader.m_offset + sizeof(T) > reader.m_bytes.size())
+	{
+		reader.m_isValid = false;
+		out_value = T();
+		return;
+	}
+	memcpy(&out_value, &reader.m_bytes[reader.m_offset], sizeof(T));
+	reader.m_offset += sizeof(T);
+}
+
+//Engine types go out field by field so the file never depends on their padding
+static void WriteValue(DefinitionCacheWriter& writer, bool const& value)			{ WriteValue(writer, (uint8_t)(value ? 1 : 0)); }
+static void WriteValue(DefinitionCacheWriter& writer, std::string const& value)
+{
+	WriteValue(writer, (uint32_t)value.size());
+	writer.m_bytes.insert(writer.m_bytes.end(), value.begin(), value.end());
+}
+static void WriteValue(DefinitionCacheWriter& writer, IntVec2 const& value)		{ WriteValue(writer, (int32_t)value.x); WriteValue(writer, (int32_t)value.y); }
+static void WriteValue(DefinitionCacheWriter& writer, Vec2 const& value)			{ WriteValue(writer, value.x); WriteValue(writer, value.y); }
+static void WriteValue(DefinitionCacheWriter& writer, Vec3 const& value)			{ WriteValue(writer, value.x); WriteValue(writer, value.y); WriteValue(writer, value.z); }
+static void WriteValue(DefinitionCacheWriter& writer, EulerAngles const& value)	{ WriteValue(writer, value.m_yawDegrees); WriteValue(writer, value.m_pitchDegrees); WriteValue(writer, value.m_rollDegrees); }
+static void WriteValue(DefinitionCacheWriter& writer, FloatRange const& value)	{ WriteValue(writer, value.m_min); WriteValue(writer, value.m_max); }
+static void WriteValue(DefinitionCacheWriter& writer, Rgba8 const& value)			{ WriteValue(writer, value.r); WriteValue(writer, value.g); WriteValue(writer, value.b); WriteValue(writer, value.a); }
+
+static void ReadValue(DefinitionCacheReader& reader, bool& out_value)
+{
+	uint8_t value = 0;
+	ReadValue(reader, value);
+	out_value = value != 0;
+}
+static void ReadValue(DefinitionCacheReader& reader, std::string& out_value)
+{
+	uint32_t length = 0;
+	ReadValue(reader, length);
+	if (!reader.m_isValid || reader.m_offset + length > reader.m_bytes.size())
+	{
+		reader.m_isValid = false;
+		out_value.clear();
+		return;
+	}
+	out_value.assign(reinterpret_cast<char const*>(&reader.m_bytes[reader.m_offset]), length);
+	reader.m_offset += length;
+}
+static void ReadValue(DefinitionCacheReader& reader, IntVec2& out_value)
+{
+	int32_t x = 0;
+	int32_t y = 0;
+	ReadValue(reader, x);
+	ReadValue(reader, y);
+	out_value = IntVec2(x, y);
+}
+static void ReadValue(DefinitionCacheReader& reader, Vec2& out_value)			{ ReadValue(reader, out_value.x); ReadValue(reader, out_value.y); }
+static void ReadValue(DefinitionCacheReader& reader, Vec3& out_value)			{ ReadValue(reader, out_value.x); ReadValue(reader, out_value.y); ReadValue(reader, out_value.z); }
+static void ReadValue(DefinitionCacheReader& reader, EulerAngles& out_value)	{ ReadValue(reader, out_value.m_yawDegrees); ReadValue(reader, out_value.m_pitchDegrees); ReadValue(reader, out_value.m_rollDegrees); }
+static void ReadValue(DefinitionCacheReader& reader, FloatRange& out_value)		{ ReadValue(reader, out_value.m_min); ReadValue(reader, out_value.m_max); }
+static void ReadValue(DefinitionCacheReader& reader, Rgba8& out_value)			{ ReadValue(reader, out_value.r); ReadValue(reader, out_value.g); ReadValue(reader, out_value.b); ReadValue(reader, out_value.a); }
+
+//A count is never more than the bytes left, so a damaged file can't ask for a huge allocation
+static int ReadCount(DefinitionCacheReader& reader)
+{
+	uint32_t count = 0;
+	ReadValue(reader, count);
+	if (!reader.m_isValid || count > reader.m_bytes.size() - reader.m_offset)
+	{
+		reader.m_isValid = false;
+		return 0;
+	}
+	return (int)count;
+}
+
+static uint64_t HashBytes(std::vector<char> const& bytes)
+{
+	//FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (int i = 0; i < (int)bytes.size(); i++)
+	{
+		hash ^= (uint64_t)(unsigned char)bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::vector<DefinitionSource> GetDefinitionSources()
+{
+	//Sorted, so the list only changes when a file is added, removed or renamed
+	std::vector<std::string> paths;
+	std::error_code error;
+	for (std::filesystem::directory_iterator it(DEFINITION_SOURCE_DIRECTORY, error), end; !error && it != end; it.increment(error))
+	{
+		if (it->is_regular_file(error) && it->path().extension() == ".xml")
+		{
+			paths.push_back(it->path().generic_string());
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<DefinitionSource> sources;
+	for (int i = 0; i < (int)paths.size(); i++)
+	{
+		DefinitionSource source;
+		source.m_path = paths[i];
+		std::ifstream file(source.m_path, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		source.m_hash = HashBytes(bytes);
+		sources.push_back(source);
+	}
+	return sources;
+}
+
+static void WriteTileDefinition(DefinitionCacheWriter& writer, TileDefinition const& tileDef)
+{
+	WriteValue(writer, tileDef.m_name);
+	WriteValue(writer, tileDef.m_isSolid);
+	WriteValue(writer, tileDef.m_mapImagePixelColor);
+	WriteValue(writer, tileDef.m_floorSpriteCoords);
+	WriteValue(writer, tileDef.m_wallSpriteCoords);
+	WriteValue(writer, tileDef.m_ceilingSpriteCoords);
+	WriteValue(writer, tileDef.m_secondaryRandom);
+}
+
+static TileDefinition* ReadTileDefinition(DefinitionCacheReader& reader)
+{
+	TileDefinition* tileDef = new TileDefinition();
+	ReadValue(reader, tileDef->m_name);
+	ReadValue(reader, tileDef->m_isSolid);
+	ReadValue(reader, tileDef->m_mapImagePixelColor);
+	ReadValue(reader, tileDef->m_floorSpriteCoords);
+	ReadValue(reader, tileDef->m_wallSpriteCoords);
+	ReadValue(reader, tileDef->m_ceilingSpriteCoords);
+	ReadValue(reader, tileDef->m_secondaryRandom);
+	return tileDef;
+}
+
+static void WriteMapDefinition(DefinitionCacheWriter& writer, MapDefinition const& mapDef)
+{
+	WriteValue(writer, mapDef.m_name);
+	WriteValue(writer, mapDef.m_shaderName);
+	WriteValue(writer, mapDef.m_spriteSheetPath);
+	WriteValue(writer, mapDef.m_spriteSheetCellCount);
+	WriteValue(writer, mapDef.m_ceilingHeight);
+	WriteValue(writer, mapDef.m_skyBoxFilePath);
+	WriteValue(writer, mapDef.m_isStreamed);
+	WriteValue(writer, (uint32_t)mapDef.m_spawnInfo.size());
+	for (int i = 0; i < (int)mapDef.m_spawnInfo.size(); i++)
+	{
+		SpawnInfo const& info = *mapDef.m_spawnInfo[i];
+		WriteValue(writer, info.m_actor);
+		WriteValue(writer, info.m_position);
+		WriteValue(writer, info.m_orientation);
+		WriteValue(writer, info.m_velocity);
+	}
+	WriteValue(writer, (uint32_t)mapDef.m_staticLights.size());
+	for (int i = 0; i < (int)mapDef.m_staticLights.size(); i++)
+	{
+		StaticLightInfo const& info = mapDef.m_staticLights[i];
+		WriteValue(writer, info.m_position);
+		WriteValue(writer, info.m_intensity);
+		WriteValue(writer, info.m_radius);
+		WriteValue(writer, info.m_color);
+	}
+}
+
+static MapDefinition* ReadMapDefinition(DefinitionCacheReader& reader)
+{
+	MapDefinition* mapDef = new MapDefinition();
+	ReadValue(reader, mapDef->m_name);
+	ReadValue(reader, mapDef->m_shaderName);
+	ReadValue(reader, mapDef->m_spriteSheetPath);
+	ReadValue(reader, mapDef->m_spriteSheetCellCount);
+	ReadValue(reader, mapDef->m_ceilingHeight);
+	ReadValue(reader, mapDef->m_skyBoxFilePath);
+	ReadValue(reader, mapDef->m_isStreamed);
+	int numSpawnInfos = ReadCount(reader);
+	for (int i = 0; i < numSpawnInfos; i++)
+	{
+		SpawnInfo* info = new SpawnInfo();
+		ReadValue(reader, info->m_actor);
+		ReadValue(reader, info->m_position);
+		ReadValue(reader, info->m_orientation);
+		ReadValue(reader, info->m_velocity);
+		mapDef->m_spawnInfo.push_back(info);
+	}
+	int numStaticLights = ReadCount(reader);
+	for (int i = 0; i < numStaticLights; i++)
+	{
+		StaticLightInfo info;
+		ReadValue(reader, info.m_position);
+		ReadValue(reader, info.m_intensity);
+		ReadValue(reader, info.m_radius);
+		ReadValue(reader, info.m_color);
+		mapDef->m_staticLights.push_back(info);
+	}
+	return mapDef;
+}
+
+static void ResolveMapDefinition(MapDefinition& mapDef)
+{
+	mapDef.m_shader = g_theRenderer->CreateOrGetShader(mapDef.m_shaderName.c_str(), VertexType::PCUTBN);
+	mapDef.m_spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile(mapDef.m_spriteSheetPath.c_str());
+}
+
+static void WriteSounds(DefinitionCacheWriter& writer, std::vector<SoundDefinition> const& sounds)
+{
+	WriteValue(writer, (uint32_t)sounds.size());
+	for (int i = 0; i < (int)sounds.size(); i++)
+	{
+		WriteValue(writer, sounds[i].m_soundName);
+		WriteValue(writer, sounds[i].m_soundFilePath);
+	}
+}
+
+static void ReadSounds(DefinitionCacheReader& reader, std::vector<SoundDefinition>& out_sounds)
+{
+	int numSounds = ReadCount(reader);
+	for (int i = 0; i < numSounds; i++)
+	{
+		SoundDefinition sound;
+		ReadValue(reader, sound.m_soundName);
+		ReadValue(reader, sound.m_soundFilePath);
+		out_sounds.push_back(sound);
+	}
+}
+
+static void WriteActorDefinition(DefinitionCacheWriter& writer, ActorDefinition const& actorDef)
+{
+	WriteValue(writer, actorDef.m_name);
+	WriteValue(writer, actorDef.m_visible);
+	WriteValue(writer, actorDef.m_dieOnSpawn);
+	WriteValue(writer, actorDef.m_health);
+	WriteValue(writer, actorDef.m_corpseLifetime);
+	WriteValue(writer, actorDef.m_color);
+	WriteValue(writer, (int32_t)actorDef.m_faction);
+	WriteValue(writer, actorDef.m_canBePossessed);
+	WriteValue(writer, actorDef.m_isPickup);
+	WriteValue(writer, (int32_t)actorDef.m_spawnCost);
+
+	ActorCollision const& collision = actorDef.m_collisionElement;
+	WriteValue(writer, collision.m_physicsRadius);
+	WriteValue(writer, collision.m_physicsHeight);
+	WriteValue(writer, collision.m_collidesWithWorld);
+	WriteValue(writer, collision.m_collidesWithActors);
+	WriteValue(writer, collision.m_dieOnCollision);
+	WriteValue(writer, collision.m_damageOnCollide);
+	WriteValue(writer, collision.m_impulseOnCollide);
+
+	ActorPhysics const& physics = actorDef.m_physicsElement;
+	WriteValue(writer, physics.m_simulated);
+	WriteValue(writer, physics.m_flying);
+	WriteValue(writer, physics.m_walkSpeed);
+	WriteValue(writer, physics.m_runSpeed);
+	WriteValue(writer, physics.m_drag);
+	WriteValue(writer, physics.turnSpeed);
+
+	WriteValue(writer, actorDef.m_cameraElement.m_eyeHeight);
+	WriteValue(writer, actorDef.m_cameraElement.m_cameraFOVDegrees);
+	WriteValue(writer, actorDef.m_AIElement.m_aiEnabled);
+	WriteValue(writer, actorDef.m_AIElement.m_sightRadius);
+	WriteValue(writer, actorDef.m_AIElement.m_sightAngle);
+
+	//Actors without a Visuals element have no sheet, and stay that way
+	ActorVisuals const& visuals = actorDef.m_VisualElement;
+	WriteValue(writer, visuals.m_spriteWorldSize);
+	WriteValue(writer, visuals.m_pivot);
+	WriteValue(writer, (int32_t)visuals.m_billBoardType);
+	WriteValue(writer, visuals.m_renderLit);
+	WriteValue(writer, visuals.m_renderRounded);
+	WriteValue(writer, visuals.m_sheet != nullptr);
+	WriteValue(writer, visuals.m_shaderName);
+	WriteValue(writer, visuals.m_spriteSheetPath);
+	WriteValue(writer, visuals.m_spriteCellCount);
+	WriteValue(writer, (uint32_t)visuals.m_groupDefinitions.size());
+	for (int i = 0; i < (int)visuals.m_groupDefinitions.size(); i++)
+	{
+		AnimationGroupDefinition const& group = *visuals.m_groupDefinitions[i];
+		WriteValue(writer, group.m_name);
+		WriteValue(writer, group.m_playbackMode);
+		WriteValue(writer, group.m_scaleBySpeed);
+		WriteValue(writer, group.m_secondsPerFrame);
+		WriteValue(writer, (uint32_t)group.m_directionAnims.size());
+		for (int j = 0; j < (int)group.m_directionAnims.size(); j++)
+		{
+			WriteValue(writer, group.m_directionAnims[j].m_direction);
+			WriteValue(writer, (int32_t)group.m_directionAnims[j].m_startFrame);
+			WriteValue(writer, (int32_t)group.m_directionAnims[j].m_endFrame);
+		}
+	}
+
+	WriteValue(writer, (uint32_t)actorDef.m_weaponElement.m_weaponNames.size());
+	for (int i = 0; i < (int)actorDef.m_weaponElement.m_weaponNames.size(); i++)
+	{
+		WriteValue(writer, actorDef.m_weaponElement.m_weaponNames[i]);
+	}
+	WriteSounds(writer, actorDef.m_sounds);
+}
+
+static ActorDefinition* ReadActorDefinition(DefinitionCacheReader& reader, bool& out_hasSheet)
+{
+	ActorDefinition* actorDef = new ActorDefinition();
+	int32_t faction = 0;
+	int32_t spawnCost = 0;
+	ReadValue(reader, actorDef->m_name);
+	ReadValue(reader, actorDef->m_visible);
+	ReadValue(reader, actorDef->m_dieOnSpawn);
+	ReadValue(reader, actorDef->m_health);
+	ReadValue(reader, actorDef->m_corpseLifetime);
+	ReadValue(reader, actorDef->m_color);
+	ReadValue(reader, faction);
+	ReadValue(reader, actorDef->m_canBePossessed);
+	ReadValue(reader, actorDef->m_isPickup);
+	ReadValue(reader, spawnCost);
+	actorDef->m_faction = (Faction)faction;
+	actorDef->m_spawnCost = spawnCost;
+
+	ActorCollision& collision = actorDef->m_collisionElement;
+	ReadValue(reader, collision.m_physicsRadius);
+	ReadValue(reader, collision.m_physicsHeight);
+	ReadValue(reader, collision.m_collidesWithWorld);
+	ReadValue(reader, collision.m_collidesWithActors);
+	ReadValue(reader, collision.m_dieOnCollision);
+	ReadValue(reader, collision.m_damageOnCollide);
+	ReadValue(reader, collision.m_impulseOnCollide);
+
+	ActorPhysics& physics = actorDef->m_physicsElement;
+	ReadValue(reader, physics.m_simulated);
+	ReadValue(reader, physics.m_flying);
+	ReadValue(reader, physics.m_walkSpeed);
+	ReadValue(reader, physics.m_runSpeed);
+	ReadValue(reader, physics.m_drag);
+	ReadValue(reader, physics.turnSpeed);
+
+	ReadValue(reader, actorDef->m_cameraElement.m_eyeHeight);
+	ReadValue(reader, actorDef->m_cameraElement.m_cameraFOVDegrees);
+	ReadValue(reader, actorDef->m_AIElement.m_aiEnabled);
+	ReadValue(reader, actorDef->m_AIElement.m_sightRadius);
+	ReadValue(reader, actorDef->m_AIElement.m_sightAngle);
+
+	ActorVisuals& visuals = actorDef->m_VisualElement;
+	int32_t billboardType = 0;
+	ReadValue(reader, visuals.m_spriteWorldSize);
+	ReadValue(reader, visuals.m_pivot);
+	ReadValue(reader, billboardType);
+	ReadValue(reader, visuals.m_renderLit);
+	ReadValue(reader, visuals.m_renderRounded);
+	ReadValue(reader, out_hasSheet);
+	ReadValue(reader, visuals.m_shaderName);
+	ReadValue(reader, visuals.m_spriteSheetPath);
+	ReadValue(reader, visuals.m_spriteCellCount);
+	visuals.m_billBoardType = (BillBoardType)billboardType;
+	int numGroups = ReadCount(reader);
+	for (int i = 0; i < numGroups && reader.m_isValid; i++)
+	{
+		AnimationGroupDefinition* group = new AnimationGroupDefinition();
+		ReadValue(reader, group->m_name);
+		ReadValue(reader, group->m_playbackMode);
+		ReadValue(reader, group->m_scaleBySpeed);
+		ReadValue(reader, group->m_secondsPerFrame);
+		int numDirections = ReadCount(reader);
+		for (int j = 0; j < numDirections && reader.m_isValid; j++)
+		{
+			Direction direction;
+			int32_t startFrame = 0;
+			int32_t endFrame = 0;
+			ReadValue(reader, direction.m_direction);
+			ReadValue(reader, startFrame);
+			ReadValue(reader, endFrame);
+			direction.m_startFrame = startFrame;
+			direction.m_endFrame = endFrame;
+			group->m_directionAnims.push_back(direction);
+		}
+		visuals.m_groupDefinitions.push_back(group);
+	}
+
+	int numWeapons = ReadCount(reader);
+	for (int i = 0; i < numWeapons; i++)
+	{
+		std::string weaponName;
+		ReadValue(reader, weaponName);
+		actorDef->m_weaponElement.m_weaponNames.push_back(weaponName);
+	}
+	ReadSounds(reader, actorDef->m_sounds);
+	return actorDef;
+}
+
+//The groups were read with frame ranges only; their animations need the sheet, which is built here
+static void ResolveActorDefinition(ActorDefinition& actorDef, bool hasSheet, std::vector<std::string>& out_atlasSourcePaths)
+{
+	ActorVisuals& visuals = actorDef.m_VisualElement;
+	if (!hasSheet)
+	{
+		for (int i = 0; i < (int)visuals.m_groupDefinitions.size(); i++)
+		{
+			visuals.m_groupDefinitions[i]->m_directionAnims.clear();
+		}
+		return;
+	}
+	visuals.m_shader = g_theRenderer->CreateOrGetShader(visuals.m_shaderName.c_str(), VertexType::PCUTBN);
+	Texture* sheetTexture = g_theRenderer->CreateOrGetTextureFromFile(visuals.m_spriteSheetPath.c_str());
+	visuals.m_sheet = new SpriteSheet(*sheetTexture, visuals.m_spriteCellCount);
+	out_atlasSourcePaths.push_back(visuals.m_spriteSheetPath);
+	for (int i = 0; i < (int)visuals.m_groupDefinitions.size(); i++)
+	{
+		AnimationGroupDefinition& group = *visuals.m_groupDefinitions[i];
+		std::vector<Direction> directions = group.m_directionAnims;
+		group.m_directionAnims.clear();
+		for (int j = 0; j < (int)directions.size(); j++)
+		{
+			group.AddDirectionAnimation(directions[j].m_direction, directions[j].m_startFrame, directions[j].m_endFrame, visuals.m_sheet);
+		}
+	}
+}
+
+static void WriteWeaponDefinition(DefinitionCacheWriter& writer, WeaponDefinition const& weaponDef)
+{
+	WriteValue(writer, weaponDef.m_name);
+	WriteValue(writer, weaponDef.m_refireTime);
+
+	WriteValue(writer, (int32_t)weaponDef.m_rayCount);
+	WriteValue(writer, weaponDef.m_rayConeDegrees);
+	WriteValue(writer, weaponDef.m_rayRange);
+	WriteValue(writer, weaponDef.m_rayDamage);
+	WriteValue(writer, weaponDef.m_rayImpulse);
+	WriteValue(writer, weaponDef.m_rayRender);
+	WriteValue(writer, weaponDef.m_rayColor);
+	WriteValue(writer, (int32_t)weaponDef.m_maxPenetration);
+
+	WriteValue(writer, (int32_t)weaponDef.m_projectileCount);
+	WriteValue(writer, weaponDef.m_projectileConeDegrees);
+	WriteValue(writer, weaponDef.m_projectileSpeed);
+	WriteValue(writer, weaponDef.m_projectileActor);
+	WriteValue(writer, weaponDef.m_projectileColor);
+	WriteValue(writer, weaponDef.m_projectileFallSpeed);
+
+	WriteValue(writer, (int32_t)weaponDef.m_meleeCount);
+	WriteValue(writer, weaponDef.m_meleeRange);
+	WriteValue(writer, weaponDef.m_meleeArcDegrees);
+	WriteValue(writer, weaponDef.m_meleeDamage);
+	WriteValue(writer, weaponDef.m_meleeImpulse);
+
+	WriteValue(writer, (int32_t)weaponDef.m_magSize);
+	WriteValue(writer, weaponDef.m_reloadTime);
+	WriteValue(writer, weaponDef.m_heatPerShot);
+	WriteValue(writer, weaponDef.m_maxHeat);
+	WriteValue(writer, weaponDef.m_cooldownTime);
+	WriteValue(writer, weaponDef.m_isEnergyBased);
+
+	WriteValue(writer, weaponDef.m_chargeShotTime);
+	WriteValue(writer, weaponDef.m_isExplosive);
+	WriteValue(writer, weaponDef.m_blastRadius);
+	WriteValue(writer, weaponDef.m_blastDamage);
+	WriteValue(writer, weaponDef.m_blastImpulse);
+
+	HUDElement const& hud = weaponDef.m_HUDElement;
+	WriteValue(writer, hud.m_shaderName);
+	WriteValue(writer, hud.m_baseTexturePath);
+	WriteValue(writer, hud.m_reticleTexturePath);
+	WriteValue(writer, hud.m_reticleSize);
+	WriteValue(writer, hud.m_spriteSize);
+	WriteValue(writer, hud.m_spritePivot);
+	WriteValue(writer, (uint32_t)hud.m_animationSources.size());
+	for (int i = 0; i < (int)hud.m_animationSources.size(); i++)
+	{
+		HUDAnimationSource const& source = hud.m_animationSources[i];
+		WriteValue(writer, source.m_spriteSheetPath);
+		WriteValue(writer, source.m_cellCount);
+		WriteValue(writer, (int32_t)source.m_startFrame);
+		WriteValue(writer, (int32_t)source.m_endFrame);
+		WriteValue(writer, source.m_secondsPerFrame);
+		WriteValue(writer, (int32_t)source.m_playbackType);
+	}
+
+	WriteSounds(writer, weaponDef.m_sounds);
+	WriteValue(writer, weaponDef.m_loopSoundOnHold);
+}
+
+static WeaponDefinition* ReadWeaponDefinition(DefinitionCacheReader& reader)
+{
+	WeaponDefinition* weaponDef = new WeaponDefinition();
+	int32_t rayCount = 0;
+	int32_t maxPenetration = 0;
+	int32_t projectileCount = 0;
+	int32_t meleeCount = 0;
+	int32_t magSize = 0;
+	ReadValue(reader, weaponDef->m_name);
+	ReadValue(reader, weaponDef->m_refireTime);
+
+	ReadValue(reader, rayCount);
+	ReadValue(reader, weaponDef->m_rayConeDegrees);
+	ReadValue(reader, weaponDef->m_rayRange);
+	ReadValue(reader, weaponDef->m_rayDamage);
+	ReadValue(reader, weaponDef->m_rayImpulse);
+	ReadValue(reader, weaponDef->m_rayRender);
+	ReadValue(reader, weaponDef->m_rayColor);
+	ReadValue(reader, maxPenetration);
+
+	ReadValue(reader, projectileCount);
+	ReadValue(reader, weaponDef->m_projectileConeDegrees);
+	ReadValue(reader, weaponDef->m_projectileSpeed);
+	ReadValue(reader, weaponDef->m_projectileActor);
+	ReadValue(reader, weaponDef->m_projectileColor);
+	ReadValue(reader, weaponDef->m_projectileFallSpeed);
+
+	ReadValue(reader, meleeCount);
+	ReadValue(reader, weaponDef->m_meleeRange);
+	ReadValue(reader, weaponDef->m_meleeArcDegrees);
+	ReadValue(reader, weaponDef->m_meleeDamage);
+	ReadValue(reader, weaponDef->m_meleeImpulse);
+
+	ReadValue(reader, magSize);
+	ReadValue(reader, weaponDef->m_reloadTime);
+	ReadValue(reader, weaponDef->m_heatPerShot);
+	ReadValue(reader, weaponDef->m_maxHeat);
+	ReadValue(reader, weaponDef->m_cooldownTime);
+	ReadValue(reader, weaponDef->m_isEnergyBased);
+
+	ReadValue(reader, weaponDef->m_chargeShotTime);
+	ReadValue(reader, weaponDef->m_isExplosive);
+	ReadValue(reader, weaponDef->m_blastRadius);
+	ReadValue(reader, weaponDef->m_blastDamage);
+	ReadValue(reader, weaponDef->m_blastImpulse);
+	weaponDef->m_rayCount = rayCount;
+	weaponDef->m_maxPenetration = maxPenetration;
+	weaponDef->m_projectileCount = projectileCount;
+	weaponDef->m_meleeCount = meleeCount;
+	weaponDef->m_magSize = magSize;
+
+	HUDElement& hud = weaponDef->m_HUDElement;
+	ReadValue(reader, hud.m_shaderName);
+	ReadValue(reader, hud.m_baseTexturePath);
+	ReadValue(reader, hud.m_reticleTexturePath);
+	ReadValue(reader, hud.m_reticleSize);
+	ReadValue(reader, hud.m_spriteSize);
+	ReadValue(reader, hud.m_spritePivot);
+	int numAnimations = ReadCount(reader);
+	for (int i = 0; i < numAnimations && reader.m_isValid; i++)
+	{
+		HUDAnimationSource source;
+		int32_t startFrame = 0;
+		int32_t endFrame = 0;
+		int32_t playbackType = 0;
+		ReadValue(reader, source.m_spriteSheetPath);
+		ReadValue(reader, source.m_cellCount);
+		ReadValue(reader, startFrame);
+		ReadValue(reader, endFrame);
+		ReadValue(reader, source.m_secondsPerFrame);
+		ReadValue(reader, playbackType);
+		source.m_startFrame = startFrame;
+		source.m_endFrame = endFrame;
+		source.m_playbackType = (SpriteAnimPlaybackType)playbackType;
+		hud.m_animationSources.push_back(source);
+	}
+
+	ReadSounds(reader, weaponDef->m_sounds);
+	ReadValue(reader, weaponDef->m_loopSoundOnHold);
+	return weaponDef;
+}
+
+static void ResolveWeaponDefinition(WeaponDefinition& weaponDef, std::vector<std::string>& out_atlasSourcePaths)
+{
+	HUDElement& hud = weaponDef.m_HUDElement;
+	hud.m_shader = g_theRenderer->CreateOrGetShader(hud.m_shaderName.c_str());
+	hud.m_baseTexture = g_theRenderer->CreateOrGetTextureFromFile(hud.m_baseTexturePath.c_str());
+	hud.m_reticleTexture = g_theRenderer->CreateOrGetTextureFromFile(hud.m_reticleTexturePath.c_str());
+	for (int i = 0; i < (int)hud.m_animationSources.size(); i++)
+	{
+		HUDAnimationSource const& source = hud.m_animationSources[i];
+		Texture* sheetTexture = g_theRenderer->CreateOrGetTextureFromFile(source.m_spriteSheetPath.c_str());
+		SpriteSheet* spriteSheet = new SpriteSheet(*sheetTexture, source.m_cellCount);
+		hud.m_animationDefs.push_back(new SpriteAnimDefinition(*spriteSheet, source.m_startFrame, source.m_endFrame, 1.f / source.m_secondsPerFrame, source.m_playbackType));
+		out_atlasSourcePaths.push_back(source.m_spriteSheetPath);
+	}
+}
+
+//Only plain data exists before resolving, so a rejected cache frees everything it read here
+static void DeleteDefinitions(std::vector<TileDefinition*>& tileDefs, std::vector<MapDefinition*>& mapDefs, std::vector<ActorDefinition*>& actorDefs, std::vector<WeaponDefinition*>& weaponDefs)
+{
+	for (int i = 0; i < (int)tileDefs.size(); i++)
+	{
+		delete tileDefs[i];
+	}
+	for (int i = 0; i < (int)mapDefs.size(); i++)
+	{
+		for (int j = 0; j < (int)mapDefs[i]->m_spawnInfo.size(); j++)
+		{
+			delete mapDefs[i]->m_spawnInfo[j];
+		}
+		delete mapDefs[i];
+	}
+	for (int i = 0; i < (int)actorDefs.size(); i++)
+	{
+		std::vector<AnimationGroupDefinition*>& groups = actorDefs[i]->m_VisualElement.m_groupDefinitions;
+		for (int j = 0; j < (int)groups.size(); j++)
+		{
+			delete groups[j];
+		}
+		delete actorDefs[i];
+	}
+	for (int i = 0; i < (int)weaponDefs.size(); i++)
+	{
+		delete weaponDefs[i];
+	}
+	tileDefs.clear();
+	mapDefs.clear();
+	actorDefs.clear();
+	weaponDefs.clear();
+}
+
+//Writes one definition of each kind, with one of every nested element, and hashes the bytes.
+//Adding, removing or retyping a serialized field changes this, so the layout can't drift from the version by accident.
+static uint64_t GetDefinitionLayoutHash()
+{
+	DefinitionCacheWriter writer;
+	WriteTileDefinition(writer, TileDefinition());
+
+	MapDefinition mapDef;
+	SpawnInfo spawnInfo;
+	mapDef.m_spawnInfo.push_back(&spawnInfo);
+	mapDef.m_staticLights.push_back(StaticLightInfo());
+	WriteMapDefinition(writer, mapDef);
+	mapDef.m_spawnInfo.clear();
+
+	ActorDefinition actorDef;
+	AnimationGroupDefinition group;
+	group.m_directionAnims.push_back(Direction());
+	actorDef.m_VisualElement.m_groupDefinitions.push_back(&group);
+	actorDef.m_weaponElement.m_weaponNames.push_back(std::string());
+	actorDef.m_sounds.push_back(SoundDefinition());
+	WriteActorDefinition(writer, actorDef);
+	actorDef.m_VisualElement.m_groupDefinitions.clear();
+
+	WeaponDefinition weaponDef;
+	weaponDef.m_HUDElement.m_animationSources.push_back(HUDAnimationSource());
+	WriteWeaponDefinition(writer, weaponDef);
+
+	std::vector<char> bytes(writer.m_bytes.begin(), writer.m_bytes.end());
+	return HashBytes(bytes);
+}
+
+bool WriteDefinitionCache(std::string const& path, std::vector<DefinitionSource> const& sources, Game const& game, int numProjectileActorDefs, double parseSeconds)
+{
+	DefinitionCacheWriter writer;
+	WriteValue(writer, DEFINITION_CACHE_MAGIC);
+	WriteValue(writer, DEFINITION_CACHE_VERSION);
+	WriteValue(writer, GetDefinitionLayoutHash());
+	WriteValue(writer, (uint32_t)sources.size());
+	for (int i = 0; i < (int)sources.size(); i++)
+	{
+		WriteValue(writer, sources[i].m_path);
+		WriteValue(writer, sources[i].m_hash);
+	}
+	WriteValue(writer, parseSeconds);
+
+	WriteValue(writer, (uint32_t)game.m_tileDefs.size());
+	for (int i = 0; i < (int)game.m_tileDefs.size(); i++)
+	{
+		WriteTileDefinition(writer, *game.m_tileDefs[i]);
+	}
+	WriteValue(writer, (uint32_t)game.m_mapDefs.size());
+	for (int i = 0; i < (int)game.m_mapDefs.size(); i++)
+	{
+		WriteMapDefinition(writer, *game.m_mapDefs[i]);
+	}
+	WriteValue(writer, (uint32_t)numProjectileActorDefs);
+	for (int i = 0; i < numProjectileActorDefs; i++)
+	{
+		WriteActorDefinition(writer, *game.m_actorDefs[i]);
+	}
+	WriteValue(writer, (uint32_t)game.m_weaponDefs.size());
+	for (int i = 0; i < (int)game.m_weaponDefs.size(); i++)
+	{
+		WriteWeaponDefinition(writer, *game.m_weaponDefs[i]);
+	}
+	WriteValue(writer, (uint32_t)(game.m_actorDefs.size() - numProjectileActorDefs));
+	for (int i = numProjectileActorDefs; i < (int)game.m_actorDefs.size(); i++)
+	{
+		WriteActorDefinition(writer, *game.m_actorDefs[i]);
+	}
+
+	std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+	}
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<char const*>(writer.m_bytes.data()), writer.m_bytes.size());
+	return file.good();
+}
+
+bool ReadDefinitionCache(std::string const& path, std::vector<DefinitionSource> const& sources, Game& game, double& out_parseSeconds)
+{
+	DefinitionCacheReader reader;
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	std::streamoff fileSize = file.tellg();
+	if (fileSize <= 0)
+	{
+		return false;
+	}
+	reader.m_bytes.resize((size_t)fileSize);
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(reader.m_bytes.data()), fileSize);
+	if (!file.good())
+	{
+		return false;
+	}
+
+	//Any edit to a source file, a different set of files, or a change to what gets serialized means parsing again
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t layoutHash = 0;
+	ReadValue(reader, magic);
+	ReadValue(reader, version);
+	ReadValue(reader, layoutHash);
+	if (magic != DEFINITION_CACHE_MAGIC || version != DEFINITION_CACHE_VERSION || layoutHash != GetDefinitionLayoutHash() || ReadCount(reader) != (int)sources.size())
+	{
+		return false;
+	}
+	for (int i = 0; i < (int)sources.size(); i++)
+	{
+		std::string sourcePath;
+		uint64_t sourceHash = 0;
+		ReadValue(reader, sourcePath);
+		ReadValue(reader, sourceHash);
+		if (!reader.m_isValid || sourcePath != sources[i].m_path || sourceHash != sources[i].m_hash)
+		{
+			return false;
+		}
+	}
+	ReadValue(reader, out_parseSeconds);
+
+	//Everything is read as plain data before any of it reaches the game or the renderer, so a damaged cache leaves both as they were
+	std::vector<TileDefinition*> tileDefs;
+	std::vector<MapDefinition*> mapDefs;
+	std::vector<ActorDefinition*> actorDefs;
+	std::vector<WeaponDefinition*> weaponDefs;
+	std::vector<bool> actorHasSheet;
+	int numTileDefs = ReadCount(reader);
+	for (int i = 0; i < numTileDefs && reader.m_isValid; i++)
+	{
+		tileDefs.push_back(ReadTileDefinition(reader));
+	}
+	int numMapDefs = ReadCount(reader);
+	for (int i = 0; i < numMapDefs && reader.m_isValid; i++)
+	{
+		mapDefs.push_back(ReadMapDefinition(reader));
+	}
+	int numProjectileActorDefs = ReadCount(reader);
+	for (int i = 0; i < numProjectileActorDefs && reader.m_isValid; i++)
+	{
+		bool hasSheet = false;
+		actorDefs.push_back(ReadActorDefinition(reader, hasSheet));
+		actorHasSheet.push_back(hasSheet);
+	}
+	int numWeaponDefs = ReadCount(reader);
+	for (int i = 0; i < numWeaponDefs && reader.m_isValid; i++)
+	{
+		weaponDefs.push_back(ReadWeaponDefinition(reader));
+	}
+	int numActorDefs = ReadCount(reader);
+	for (int i = 0; i < numActorDefs && reader.m_isValid; i++)
+	{
+		bool hasSheet = false;
+		actorDefs.push_back(ReadActorDefinition(reader, hasSheet));
+		actorHasSheet.push_back(hasSheet);
+	}
+
+	if (!reader.m_isValid || reader.m_offset != reader.m_bytes.size() || mapDefs.empty())
+	{
+		DeleteDefinitions(tileDefs, mapDefs, actorDefs, weaponDefs);
+		return false;
+	}
+
+	//Sheets reach the atlas in parse order: projectiles, weapons, then the rest
+	std::vector<std::string> atlasSourcePaths;
+	for (int i = 0; i < (int)mapDefs.size(); i++)
+	{
+		ResolveMapDefinition(*mapDefs[i]);
+	}
+	for (int i = 0; i < numProjectileActorDefs; i++)
+	{
+		ResolveActorDefinition(*actorDefs[i], actorHasSheet[i], atlasSourcePaths);
+	}
+	for (int i = 0; i < (int)weaponDefs.size(); i++)
+	{
+		ResolveWeaponDefinition(*weaponDefs[i], atlasSourcePaths);
+	}
+	for (int i = numProjectileActorDefs; i < (int)actorDefs.size(); i++)
+	{
+		ResolveActorDefinition(*actorDefs[i], actorHasSheet[i], atlasSourcePaths);
+	}
+
+	game.m_tileDefs = tileDefs;
+	game.m_mapDefs = mapDefs;
+	game.m_actorDefs = actorDefs;
+	game.m_weaponDefs = weaponDefs;
+	game.CreateMapSpriteSheet();
+	for (int i = 0; i < (int)atlasSourcePaths.size(); i++)
+	{
+		game.AddSpriteSheetToAtlas(g_theRenderer->CreateOrGetTextureFromFile(atlasSourcePaths[i].c_str()), atlasSourcePaths[i]);
+	}
+	return true;
+}
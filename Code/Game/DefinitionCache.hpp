@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class Game;
+
+//A definition file and a hash of its bytes; the cache only stands in for the files while every hash still matches
+struct DefinitionSource
+{
+	std::string	m_path;
+	uint64_t	m_hash = 0;
+};
+
+//Every .xml file in Data/Definitions, hashed, sorted by path
+std::vector<DefinitionSource>	GetDefinitionSources();
+
+//The cache holds the tile, map, actor and weapon definitions as plain data, with the paths of the shaders and textures they use.
+//Reading it parses and checks the whole file first, then resolves those through the renderer and rebuilds sprite sheets and animations without touching the XML.
+//Actors are stored projectiles first, then weapons, then the rest, so sprite sheets reach the atlas in the same order as parsing.
+bool	WriteDefinitionCache(std::string const& path, std::vector<DefinitionSource> const& sources, Game const& game, int numProjectileActorDefs, double parseSeconds);
+bool	ReadDefinitionCache(std::string const& path, std::vector<DefinitionSource> const& sources, Game& game, double& out_parseSeconds);
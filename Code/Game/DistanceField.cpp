@@ -0,0 +1,278 @@
+#include "DistanceField.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cmath>
+
+constexpr float NO_SITE = 1e20f;
+constexpr int BUILD_BLOCK_TILES = 64;
+
+DistanceField::DistanceField(int samplesPerTile, float maxDistance)
+{
+	m_samplesPerTile = (samplesPerTile > 1) ? samplesPerTile : 1;
+	m_spacing = 1.f / (float)m_samplesPerTile;
+	m_maxDistance = (maxDistance > m_spacing) ? maxDistance : m_spacing;
+	m_step = m_maxDistance / (float)INT16_MAX;
+}
+
+void DistanceField::Build(Grid<unsigned char> const& solidity)
+{
+	//Built in blocks so the transform scratch stays one window in size, however large the map
+	double startSeconds = GetCurrentTimeSeconds();
+	IntVec2 const& dimensions = solidity.GetDimensions();
+	m_numSamples = IntVec2((dimensions.x * m_samplesPerTile) + 1, (dimensions.y * m_samplesPerTile) + 1);
+	m_distances.Initialize(m_numSamples, 0);
+	for (int blockY = 0; blockY < dimensions.y; blockY += BUILD_BLOCK_TILES)
+	{
+		for (int blockX = 0; blockX < dimensions.x; blockX += BUILD_BLOCK_TILES)
+		{
+			IntVec2 blockMaxs(blockX + BUILD_BLOCK_TILES - 1, blockY + BUILD_BLOCK_TILES - 1);
+			blockMaxs.x = (blockMaxs.x < dimensions.x - 1) ? blockMaxs.x : dimensions.x - 1;
+			blockMaxs.y = (blockMaxs.y < dimensions.y - 1) ? blockMaxs.y : dimensions.y - 1;
+			RebuildTiles(solidity, IntVec2(blockX, blockY), blockMaxs);
+		}
+	}
+
+	m_stats.m_numSamples = m_numSamples;
+	m_stats.m_numBytes = m_distances.GetCells().size() * sizeof(int16_t);
+	m_stats.m_seconds = GetCurrentTimeSeconds() - startSeconds;
+}
+
+void DistanceField::RebuildAroundTile(Grid<unsigned char> const& solidity, IntVec2 const& tileCoords)
+{
+	//Only samples within the max distance of the tile can see it; everything further was already clamped either way
+	int reach = (int)ceilf(m_maxDistance);
+	RebuildTiles(solidity, IntVec2(tileCoords.x - reach, tileCoords.y - reach), IntVec2(tileCoords.x + reach, tileCoords.y + reach));
+}
+
+void DistanceField::RebuildTiles(Grid<unsigned char> const& solidity, IntVec2 const& tileMins, IntVec2 const& tileMaxs)
+{
+	//Samples on or inside the tiles get rewritten; sites are read a max distance further out, which is all a clamped sample can see
+	int reachSamples = (int)ceilf(m_maxDistance) * m_samplesPerTile;
+	int writeMinX = (tileMins.x * m_samplesPerTile > 0) ? tileMins.x * m_samplesPerTile : 0;
+	int writeMinY = (tileMins.y * m_samplesPerTile > 0) ? tileMins.y * m_samplesPerTile : 0;
+	int writeMaxX = ((tileMaxs.x + 1) * m_samplesPerTile < m_numSamples.x - 1) ? (tileMaxs.x + 1) * m_samplesPerTile : m_numSamples.x - 1;
+	int writeMaxY = ((tileMaxs.y + 1) * m_samplesPerTile < m_numSamples.y - 1) ? (tileMaxs.y + 1) * m_samplesPerTile : m_numSamples.y - 1;
+	if (writeMinX > writeMaxX || writeMinY > writeMaxY)
+	{
+		return;
+	}
+	int windowMinX = (writeMinX - reachSamples > 0) ? writeMinX - reachSamples : 0;
+	int windowMinY = (writeMinY - reachSamples > 0) ? writeMinY - reachSamples : 0;
+	int windowMaxX = (writeMaxX + reachSamples < m_numSamples.x - 1) ? writeMaxX + reachSamples : m_numSamples.x - 1;
+	int windowMaxY = (writeMaxY + reachSamples < m_numSamples.y - 1) ? writeMaxY + reachSamples : m_numSamples.y - 1;
+	IntVec2 windowSize(windowMaxX - windowMinX + 1, windowMaxY - windowMinY + 1);
+	m_outsideDistances.Initialize(windowSize, NO_SITE);
+	m_insideDistances.Initialize(windowSize, NO_SITE);
+
+	//A sample on a tile edge touches two tiles (four at a corner); it's a wall site if any is solid and an open site if any isn't.
+	//Outside the map counts as open, like IsTileSolid.
+	for (int sampleY = windowMinY; sampleY <= windowMaxY; sampleY++)
+	{
+		int tileMaxY = sampleY / m_samplesPerTile;
+		int tileMinY = ((sampleY % m_samplesPerTile) == 0) ? tileMaxY - 1 : tileMaxY;
+		for (int sampleX = windowMinX; sampleX <= windowMaxX; sampleX++)
+		{
+			int tileMaxX = sampleX / m_samplesPerTile;
+			int tileMinX = ((sampleX % m_samplesPerTile) == 0) ? tileMaxX - 1 : tileMaxX;
+			bool isWallSite = false;
+			bool isOpenSite = false;
+			for (int tileY = tileMinY; tileY <= tileMaxY; tileY++)
+			{
+				for (int tileX = tileMinX; tileX <= tileMaxX; tileX++)
+				{
+					if (solidity.GetOrDefault(tileX, tileY, 0) != 0)
+					{
+						isWallSite = true;
+					}
+					else
+					{
+						isOpenSite = true;
+					}
+				}
+			}
+
+			m_outsideDistances.Set(sampleX - windowMinX, sampleY - windowMinY, isWallSite ? 0.f : NO_SITE);
+			m_insideDistances.Set(sampleX - windowMinX, sampleY - windowMinY, isOpenSite ? 0.f : NO_SITE);
+		}
+	}
+
+	ComputeSquaredDistances(m_outsideDistances);
+	ComputeSquaredDistances(m_insideDistances);
+
+	//Each sample is its own kind of site, so at most one side is empty and the clamp catches it
+	for (int y = writeMinY; y <= writeMaxY; y++)
+	{
+		GridRowSpan<int16_t> row = m_distances.GetRow(y);
+		GridRowSpan<float> outsideRow = m_outsideDistances.GetRow(y - windowMinY);
+		GridRowSpan<float> insideRow = m_insideDistances.GetRow(y - windowMinY);
+		for (int x = writeMinX; x <= writeMaxX; x++)
+		{
+			float distance = (sqrtf(outsideRow.m_data[x - windowMinX]) - sqrtf(insideRow.m_data[x - windowMinX])) * m_spacing;
+			distance = (distance < -m_maxDistance) ? -m_maxDistance : ((distance > m_maxDistance) ? m_maxDistance : distance);
+			row.m_data[x] = (int16_t)floorf(distance / m_step);
+		}
+	}
+}
+
+float DistanceField::GetDistance(Vec2 const& position) const
+{
+	int x = 0;
+	int y = 0;
+	float fractionX = 0.f;
+	float fractionY = 0.f;
+	GetCell(position, x, y, fractionX, fractionY);
+	float bottom = GetSample(x, y) + ((GetSample(x + 1, y) - GetSample(x, y)) * fractionX);
+	float top = GetSample(x, y + 1) + ((GetSample(x + 1, y + 1) - GetSample(x, y + 1)) * fractionX);
+	return bottom + ((top - bottom) * fractionY);
+}
+
+float DistanceField::GetDistanceLowerBound(Vec2 const& position) const
+{
+	//Distance changes no faster than the point moves, so each exact corner bounds it from below; keep the tightest
+	int x = 0;
+	int y = 0;
+	float fractionX = 0.f;
+	float fractionY = 0.f;
+	GetCell(position, x, y, fractionX, fractionY);
+	float bestBound = -NO_SITE;
+	for (int cornerY = y; cornerY <= y + 1; cornerY++)
+	{
+		for (int cornerX = x; cornerX <= x + 1; cornerX++)
+		{
+			float offsetX = position.x - ((float)cornerX * m_spacing);
+			float offsetY = position.y - ((float)cornerY * m_spacing);
+			float bound = GetSample(cornerX, cornerY) - sqrtf((offsetX * offsetX) + (offsetY * offsetY));
+			bestBound = (bound > bestBound) ? bound : bestBound;
+		}
+	}
+	return bestBound;
+}
+
+Vec2 DistanceField::GetGradient(Vec2 const& position) const
+{
+	//Slope of the bilinear patch, scaled back to unit length; points away from the nearest wall
+	int x = 0;
+	int y = 0;
+	float fractionX = 0.f;
+	float fractionY = 0.f;
+	GetCell(position, x, y, fractionX, fractionY);
+	float d00 = GetSample(x, y);
+	float d10 = GetSample(x + 1, y);
+	float d01 = GetSample(x, y + 1);
+	float d11 = GetSample(x + 1, y + 1);
+	float gradientX = ((d10 - d00) * (1.f - fractionY)) + ((d11 - d01) * fractionY);
+	float gradientY = ((d01 - d00) * (1.f - fractionX)) + ((d11 - d10) * fractionX);
+	float length = sqrtf((gradientX * gradientX) + (gradientY * gradientY));
+	if (length <= 0.f)
+	{
+		return Vec2(0.f, 0.f);
+	}
+	return Vec2(gradientX / length, gradientY / length);
+}
+
+DistanceFieldStats const& DistanceField::GetStats() const
+{
+	return m_stats;
+}
+
+void DistanceField::ComputeSquaredDistances(Grid<float>& distances)
+{
+	//Separable exact transform: columns first, then rows over the column results
+	IntVec2 const& size = distances.GetDimensions();
+	float* cells = distances.GetCells().data();
+	for (int x = 0; x < size.x; x++)
+	{
+		TransformLine(&cells[x], size.y, size.x);
+	}
+	for (int y = 0; y < size.y; y++)
+	{
+		TransformLine(distances.GetRow(y).m_data, size.x, 1);
+	}
+}
+
+void DistanceField::TransformLine(float* values, int count, int stride)
+{
+	//Felzenszwalb-Huttenlocher: lower envelope of the parabolas (q - site)^2 + f(site), in sample units.
+	//Lines with no site are left empty rather than mixing huge values into the intersections.
+	m_line.resize(count);
+	m_lineResult.resize(count);
+	m_parabolaSites.resize(count);
+	m_parabolaBounds.resize(count + 1);
+	for (int q = 0; q < count; q++)
+	{
+		m_line[q] = values[q * stride];
+	}
+
+	int numParabolas = 0;
+	for (int q = 0; q < count; q++)
+	{
+		if (m_line[q] >= NO_SITE)
+		{
+			continue;
+		}
+		if (numParabolas == 0)
+		{
+			m_parabolaSites[0] = q;
+			m_parabolaBounds[0] = -NO_SITE;
+			m_parabolaBounds[1] = NO_SITE;
+			numParabolas = 1;
+			continue;
+		}
+
+		//The first bound is -NO_SITE, so the envelope never empties
+		float intersection = 0.f;
+		for (;;)
+		{
+			int site = m_parabolaSites[numParabolas - 1];
+			intersection = ((m_line[q] + (float)(q * q)) - (m_line[site] + (float)(site * site))) / (float)(2 * (q - site));
+			if (intersection > m_parabolaBounds[numParabolas - 1])
+			{
+				break;
+			}
+			numParabolas--;
+		}
+		m_parabolaSites[numParabolas] = q;
+		m_parabolaBounds[numParabolas] = intersection;
+		m_parabolaBounds[numParabolas + 1] = NO_SITE;
+		numParabolas++;
+	}
+
+	if (numParabolas == 0)
+	{
+		return;
+	}
+	int parabola = 0;
+	for (int q = 0; q < count; q++)
+	{
+		while (m_parabolaBounds[parabola + 1] < (float)q)
+		{
+			parabola++;
+		}
+		int site = m_parabolaSites[parabola];
+		m_lineResult[q] = (float)((q - site) * (q - site)) + m_line[site];
+	}
+	for (int q = 0; q < count; q++)
+	{
+		values[q * stride] = m_lineResult[q];
+	}
+}
+
+void DistanceField::GetCell(Vec2 const& position, int& out_x, int& out_y, float& out_fractionX, float& out_fractionY) const
+{
+	float sampleX = position.x / m_spacing;
+	float sampleY = position.y / m_spacing;
+	float maxX = (float)(m_numSamples.x - 1);
+	float maxY = (float)(m_numSamples.y - 1);
+	sampleX = (sampleX < 0.f) ? 0.f : ((sampleX > maxX) ? maxX : sampleX);
+	sampleY = (sampleY < 0.f) ? 0.f : ((sampleY > maxY) ? maxY : sampleY);
+	out_x = (int)sampleX;
+	out_y = (int)sampleY;
+	out_x = (out_x < m_numSamples.x - 2) ? out_x : m_numSamples.x - 2;
+	out_y = (out_y < m_numSamples.y - 2) ? out_y : m_numSamples.y - 2;
+	out_fractionX = sampleX - (float)out_x;
+	out_fractionY = sampleY - (float)out_y;
+}
+
+float DistanceField::GetSample(int x, int y) const
+{
+	return (float)m_distances.Get(x, y) * m_step;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Game/Grid.hpp"
+
+struct DistanceFieldStats
+{
+	IntVec2	m_numSamples;
+	size_t	m_numBytes = 0;
+	double	m_seconds = 0.0;
+};
+
+//Signed XY distance to the nearest solid tile, sampled on a lattice of some number of points per tile (negative inside walls).
+//Tile corners sit on the lattice, so the nearest wall point of any sample is a sample too and the transform is exact there.
+//Distances are clamped to the max distance and stored as 16-bit steps rounded down, so a sample never overstates its clearance.
+//Since nothing past the max distance is recorded, a tile change only reaches the samples within that distance of it.
+class DistanceField
+{
+public:
+	DistanceField(int samplesPerTile, float maxDistance);
+	~DistanceField() = default;
+
+	void						Build(Grid<unsigned char> const& solidity);
+	void						RebuildAroundTile(Grid<unsigned char> const& solidity, IntVec2 const& tileCoords);
+
+	float						GetDistance(Vec2 const& position) const;
+	float						GetDistanceLowerBound(Vec2 const& position) const;
+	Vec2						GetGradient(Vec2 const& position) const;
+	DistanceFieldStats const&	GetStats() const;
+
+private:
+	void						RebuildTiles(Grid<unsigned char> const& solidity, IntVec2 const& tileMins, IntVec2 const& tileMaxs);
+	void						ComputeSquaredDistances(Grid<float>& distances);
+	void						TransformLine(float* values, int count, int stride);
+	void						GetCell(Vec2 const& position, int& out_x, int& out_y, float& out_fractionX, float& out_fractionY) const;
+	float						GetSample(int x, int y) const;
+
+	int							m_samplesPerTile = 4;
+	float						m_spacing = .25f;
+	float						m_maxDistance = 4.f;
+	float						m_step = 4.f / 32767.f;
+	IntVec2						m_numSamples;
+	Grid<int16_t>				m_distances;
+
+	//Scratch for the transform, sized to one rebuild window and kept between rebuilds
+	Grid<float>					m_outsideDistances;
+	Grid<float>					m_insideDistances;
+	std::vector<float>			m_line;
+	std::vector<float>			m_lineResult;
+	std::vector<int>			m_parabolaSites;
+	std::vector<float>			m_parabolaBounds;
+
+	DistanceFieldStats			m_stats;
+};
@@ -0,0 +1,133 @@
+#include "EffectSystem.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/AnimationGroupDefinition.hpp"
+#include "Game/BillboardBatch.hpp"
+#include <algorithm>
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+EffectSystem::EffectSystem(Map* map)
+{
+	m_map = map;
+	m_capacity = g_gameConfigBlackboard->GetValue("maxEffects", 2048);
+	if (m_capacity < 1)
+	{
+		m_capacity = 1;
+	}
+
+	m_positions.resize(m_capacity);
+	m_ages.resize(m_capacity, 0.f);
+	m_lifetimes.resize(m_capacity, 0.f);
+	m_typeIndexes.resize(m_capacity, -1);
+}
+
+EffectSystem::~EffectSystem()
+{
+	m_types.clear();
+	m_map = nullptr;
+}
+
+void EffectSystem::SpawnEffect(const ActorDefinition* definition, Vec3 const& position)
+{
+	if (definition == nullptr)
+	{
+		return;
+	}
+
+	int slot = m_nextSlot;
+	m_nextSlot = (m_nextSlot + 1) % m_capacity;
+	if (m_typeIndexes[slot] < 0)
+	{
+		m_numLiveEffects++;
+	}
+
+	m_positions[slot] = position;
+	m_ages[slot] = 0.f;
+	m_lifetimes[slot] = definition->m_corpseLifetime;
+	m_typeIndexes[slot] = GetOrCreateType(definition);
+}
+
+void EffectSystem::Update(float deltaSeconds)
+{
+	if (m_numLiveEffects == 0)
+	{
+		return;
+	}
+
+	for (int slot = 0; slot < m_capacity; slot++)
+	{
+		if (m_typeIndexes[slot] < 0)
+		{
+			continue;
+		}
+
+		m_ages[slot] += deltaSeconds;
+		if (m_ages[slot] >= m_lifetimes[slot])
+		{
+			m_typeIndexes[slot] = -1;
+			m_numLiveEffects--;
+		}
+	}
+}
+
+void EffectSystem::UpdateVerts(Mat44 const& cameraTransform, BillboardBatch& batch) const
+{
+	if (m_numLiveEffects == 0)
+	{
+		return;
+	}
+
+	for (int slot = 0; slot < m_capacity; slot++)
+	{
+		if (m_typeIndexes[slot] < 0)
+		{
+			continue;
+		}
+
+		EffectType const& effectType = m_types[m_typeIndexes[slot]];
+		if (effectType.m_animation == nullptr || effectType.m_animation->m_directionAnims.empty())
+		{
+			continue;
+		}
+
+		SpriteDefinition sprite = effectType.m_animation->m_directionAnims[0].m_animation->GetSpriteDefAtTime(m_ages[slot]);
+		batch.AddBillboard(effectType.m_definition, cameraTransform, m_positions[slot], sprite.GetUVs(), effectType.m_definition->m_color);
+	}
+}
+
+void EffectSystem::Clear()
+{
+	std::fill(m_typeIndexes.begin(), m_typeIndexes.end(), -1);
+	m_numLiveEffects = 0;
+	m_nextSlot = 0;
+}
+
+int EffectSystem::GetNumLiveEffects() const
+{
+	return m_numLiveEffects;
+}
+
+int EffectSystem::GetOrCreateType(const ActorDefinition* definition)
+{
+	for (int i = 0; i < (int)m_types.size(); i++)
+	{
+		if (m_types[i].m_definition == definition)
+		{
+			return i;
+		}
+	}
+
+	//Short-lived actors play their Death group from spawn, so effects do the same
+	EffectType type;
+	type.m_definition = definition;
+	type.m_animation = definition->GetGroupDefinition("Death");
+	if (type.m_animation == nullptr && !definition->m_VisualElement.m_groupDefinitions.empty())
+	{
+		type.m_animation = definition->m_VisualElement.m_groupDefinitions[0];
+	}
+	m_types.push_back(type);
+	return (int)m_types.size() - 1;
+}
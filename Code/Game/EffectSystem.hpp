@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+class Map;
+class BillboardBatch;
+class ActorDefinition;
+class AnimationGroupDefinition;
+
+struct EffectType
+{
+	const ActorDefinition*		m_definition = nullptr;
+	AnimationGroupDefinition*	m_animation = nullptr;
+};
+
+class EffectSystem
+{
+public:
+	EffectSystem(Map* map);
+	~EffectSystem();
+
+	void SpawnEffect(const ActorDefinition* definition, Vec3 const& position);
+	void Update(float deltaSeconds);
+	void UpdateVerts(Mat44 const& cameraTransform, BillboardBatch& batch) const;
+	void Clear();
+	int  GetNumLiveEffects() const;
+
+private:
+	int  GetOrCreateType(const ActorDefinition* definition);
+
+	Map*							m_map = nullptr;
+	int								m_capacity = 0;
+	int								m_nextSlot = 0;
+	int								m_numLiveEffects = 0;
+
+	//Fixed ring of slots; when full, the oldest effect is overwritten
+	std::vector<Vec3>				m_positions;
+	std::vector<float>				m_ages;
+	std::vector<float>				m_lifetimes;
+	std::vector<int>				m_typeIndexes;
+
+	std::vector<EffectType>		m_types;
+};
@@ -0,0 +1,142 @@
+#include "EngineRenderBackend.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+//The slot DrawLitIndexBuffer binds LightConstants to, for both shader stages
+constexpr int LIGHT_CONSTANTS_SLOT = 1;
+
+//Past the engine's camera (b2) and model (b3) constants; only MapCompact.hlsl reads it
+constexpr int VERTEX_FRAME_CONSTANTS_SLOT = 4;
+
+EngineRenderBackend::EngineRenderBackend(Renderer* renderer)
+{
+	m_renderer = renderer;
+}
+
+VertexBuffer* EngineRenderBackend::CreateVertexBuffer(unsigned int size, unsigned int stride)
+{
+	CountBufferCreated();
+	return m_renderer->CreateVertexBuffer(size, stride);
+}
+
+IndexBuffer* EngineRenderBackend::CreateIndexBuffer(unsigned int numIndexes)
+{
+	CountBufferCreated();
+	return m_renderer->CreateIndexBuffer(numIndexes);
+}
+
+ConstantBuffer* EngineRenderBackend::CreateConstantBuffer(unsigned int size)
+{
+	CountBufferCreated();
+	return m_renderer->CreateConstantBuffer(size);
+}
+
+void EngineRenderBackend::CopyCPUToGPU(Vertex_PCUTBN const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer)
+{
+	CountBytesUploaded(numVerts * (unsigned int)sizeof(Vertex_PCUTBN));
+	m_renderer->CopyCPUToGPU(verts, numVerts, vertexBuffer);
+}
+
+void EngineRenderBackend::CopyCPUToGPU(unsigned int const* indexes, unsigned int numIndexes, IndexBuffer* indexBuffer)
+{
+	CountBytesUploaded(numIndexes * (unsigned int)sizeof(unsigned int));
+	m_renderer->CopyCPUToGPU(indexes, numIndexes, indexBuffer);
+}
+
+void EngineRenderBackend::CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* constantBuffer)
+{
+	CountBytesUploaded(size);
+	m_renderer->CopyCPUToGPU(data, size, constantBuffer);
+}
+
+void EngineRenderBackend::CopyCPUToGPU(Vertex_PCU const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer)
+{
+	CountBytesUploaded(numVerts * (unsigned int)sizeof(Vertex_PCU));
+	m_renderer->CopyCPUToGPU(verts, numVerts, vertexBuffer);
+}
+
+void EngineRenderBackend::BeginCamera(Camera const& camera)
+{
+	m_renderer->BeginCamera(camera);
+}
+
+void EngineRenderBackend::EndCamera(Camera const& camera)
+{
+	m_renderer->EndCamera(camera);
+}
+
+void EngineRenderBackend::BindTexture(const Texture* texture)
+{
+	CountTextureChange(texture);
+	m_renderer->BindTexture(texture);
+}
+
+void EngineRenderBackend::BindShader(Shader* shader)
+{
+	CountShaderChange(shader);
+	m_renderer->BindShader(shader);
+}
+
+void EngineRenderBackend::SetBlendMode(BlendMode blendMode)
+{
+	CountBlendModeChange(blendMode);
+	m_renderer->SetBlendMode(blendMode);
+}
+
+void EngineRenderBackend::SetRasterizerMode(RasterizerMode rasterizerMode)
+{
+	CountRasterizerModeChange(rasterizerMode);
+	m_renderer->SetRasterizerMode(rasterizerMode);
+}
+
+void EngineRenderBackend::SetDepthMode(DepthMode depthMode)
+{
+	CountDepthModeChange(depthMode);
+	m_renderer->SetDepthMode(depthMode);
+}
+
+void EngineRenderBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	CountSamplerModeChange(samplerMode);
+	m_renderer->SetSamplerMode(samplerMode);
+}
+
+void EngineRenderBackend::SetStatesIfChanged()
+{
+	m_renderer->SetStatesIfChanged();
+}
+
+void EngineRenderBackend::SetModelConstants(Mat44 const& modelTransform, Rgba8 const& modelColor)
+{
+	CountModelConstantsChange(modelTransform, modelColor);
+	m_renderer->SetModelConstants(modelTransform, modelColor);
+}
+
+void EngineRenderBackend::BindLightBuffer(ConstantBuffer* lightBuffer)
+{
+	CountLightBufferChange(lightBuffer);
+	m_renderer->BindConstantBuffer(LIGHT_CONSTANTS_SLOT, lightBuffer);
+}
+
+void EngineRenderBackend::BindVertexFrameBuffer(ConstantBuffer* vertexFrameBuffer)
+{
+	CountVertexFrameBufferChange(vertexFrameBuffer);
+	m_renderer->BindConstantBuffer(VERTEX_FRAME_CONSTANTS_SLOT, vertexFrameBuffer);
+}
+
+void EngineRenderBackend::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	CountDraw((int)verts.size());
+	m_renderer->DrawVertexArray(verts);
+}
+
+void EngineRenderBackend::DrawVertexBuffer(VertexBuffer* vertexBuffer, int numVerts)
+{
+	CountDraw(numVerts);
+	m_renderer->DrawVertexBuffer(vertexBuffer, numVerts);
+}
+
+void EngineRenderBackend::DrawLitIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, ConstantBuffer* lightBuffer, int numIndexes)
+{
+	CountDraw(numIndexes);
+	m_renderer->DrawLitIndexBuffer(vertexBuffer, indexBuffer, lightBuffer, numIndexes);
+}
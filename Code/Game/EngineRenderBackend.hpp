@@ -0,0 +1,40 @@
+#pragma once
+#include "Game/RenderBackend.hpp"
+
+class Renderer;
+
+//Forwards straight to the DX11 engine renderer, counting as it goes
+class EngineRenderBackend : public RenderBackend
+{
+public:
+	EngineRenderBackend(Renderer* renderer);
+	~EngineRenderBackend() = default;
+
+	VertexBuffer*	CreateVertexBuffer(unsigned int size, unsigned int stride) override;
+	IndexBuffer*	CreateIndexBuffer(unsigned int numIndexes) override;
+	ConstantBuffer*	CreateConstantBuffer(unsigned int size) override;
+	void			CopyCPUToGPU(Vertex_PCUTBN const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) override;
+	void			CopyCPUToGPU(unsigned int const* indexes, unsigned int numIndexes, IndexBuffer* indexBuffer) override;
+	void			CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* constantBuffer) override;
+	void			CopyCPUToGPU(Vertex_PCU const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) override;
+
+	void			BeginCamera(Camera const& camera) override;
+	void			EndCamera(Camera const& camera) override;
+	void			BindTexture(const Texture* texture) override;
+	void			BindShader(Shader* shader) override;
+	void			SetBlendMode(BlendMode blendMode) override;
+	void			SetRasterizerMode(RasterizerMode rasterizerMode) override;
+	void			SetDepthMode(DepthMode depthMode) override;
+	void			SetSamplerMode(SamplerMode samplerMode) override;
+	void			SetStatesIfChanged() override;
+	void			SetModelConstants(Mat44 const& modelTransform, Rgba8 const& modelColor) override;
+	void			BindLightBuffer(ConstantBuffer* lightBuffer) override;
+	void			BindVertexFrameBuffer(ConstantBuffer* vertexFrameBuffer) override;
+
+	void			DrawVertexArray(std::vector<Vertex_PCU> const& verts) override;
+	void			DrawVertexBuffer(VertexBuffer* vertexBuffer, int numVerts) override;
+	void			DrawLitIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, ConstantBuffer* lightBuffer, int numIndexes) override;
+
+private:
+	Renderer*		m_renderer = nullptr;
+};
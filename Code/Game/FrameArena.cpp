@@ -0,0 +1,181 @@
+#include "FrameArena.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <new>
+
+static std::atomic<int> s_numHeapAllocations(0);
+
+#if defined(GAME_COUNT_HEAP_ALLOCATIONS)
+//Replacing the global allocator is the only way to see the engine's allocations as well as the game's
+void* operator new(size_t size)
+{
+	s_numHeapAllocations++;
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+#endif
+
+int GetNumHeapAllocations()
+{
+	return s_numHeapAllocations;
+}
+
+FrameArena::FrameArena(size_t initialSize)
+{
+	AddChunk(initialSize);
+	m_heapAllocationsAtFrameStart = GetNumHeapAllocations();
+}
+
+FrameArena::~FrameArena()
+{
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		free(m_chunks[i].m_memory);
+	}
+	m_chunks.clear();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	for (;;)
+	{
+		Chunk& chunk = m_chunks[m_currentChunk];
+		size_t alignedOffset = (m_offset + alignment - 1) & ~(alignment - 1);
+		if (alignedOffset + size <= chunk.m_size)
+		{
+			m_offset = alignedOffset + size;
+			m_bytesUsed += size;
+			return chunk.m_memory + alignedOffset;
+		}
+
+		//Spill into the next chunk, adding one only the first time a frame needs it
+		m_currentChunk++;
+		m_offset = 0;
+		if (m_currentChunk >= (int)m_chunks.size())
+		{
+			AddChunk(size + alignment);
+		}
+	}
+}
+
+void FrameArena::Reset()
+{
+	//A frame that spilled gets one chunk big enough for the whole of it, so the next frame is back to a single bump pointer
+	if (m_chunks.size() > 1)
+	{
+		size_t totalSize = 0;
+		for (int i = 0; i < (int)m_chunks.size(); i++)
+		{
+			totalSize += m_chunks[i].m_size;
+			free(m_chunks[i].m_memory);
+		}
+		m_chunks.clear();
+		AddChunk(totalSize);
+	}
+
+	m_currentChunk = 0;
+	m_offset = 0;
+	m_lastFrameBytesUsed = m_bytesUsed;
+	m_bytesUsed = 0;
+
+	int numHeapAllocations = GetNumHeapAllocations();
+	m_lastFrameHeapAllocations = numHeapAllocations - m_heapAllocationsAtFrameStart - m_debugHeapAllocations;
+	m_lastFrameDebugHeapAllocations = m_debugHeapAllocations;
+	m_heapAllocationsAtFrameStart = numHeapAllocations;
+	m_debugHeapAllocations = 0;
+}
+
+size_t FrameArena::GetBytesUsed() const
+{
+	return m_bytesUsed;
+}
+
+size_t FrameArena::GetLastFrameBytesUsed() const
+{
+	return m_lastFrameBytesUsed;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		capacity += m_chunks[i].m_size;
+	}
+	return capacity;
+}
+
+int FrameArena::GetLastFrameHeapAllocations() const
+{
+	return m_lastFrameHeapAllocations;
+}
+
+void FrameArena::BeginDebugAllocations()
+{
+	m_heapAllocationsAtDebugStart = GetNumHeapAllocations();
+}
+
+void FrameArena::EndDebugAllocations()
+{
+	m_debugHeapAllocations += GetNumHeapAllocations() - m_heapAllocationsAtDebugStart;
+}
+
+int FrameArena::GetLastFrameDebugHeapAllocations() const
+{
+	return m_lastFrameDebugHeapAllocations;
+}
+
+void FrameArena::AddChunk(size_t minSize)
+{
+	Chunk chunk;
+	chunk.m_size = (minSize > 64 * 1024) ? minSize : 64 * 1024;
+	chunk.m_memory = (unsigned char*)malloc(chunk.m_size);
+	m_chunks.push_back(chunk);
+}
+
+char const* FrameStringf(char const* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int length = vsnprintf(nullptr, 0, format, args);
+	va_end(args);
+
+	length = (length > 0) ? length : 0;
+	char* text = (char*)g_theFrameArena->Allocate((size_t)length + 1, 1);
+	vsnprintf(text, (size_t)length + 1, format, argsCopy);
+	va_end(argsCopy);
+	return text;
+}
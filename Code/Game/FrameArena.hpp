@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+
+//#define GAME_COUNT_HEAP_ALLOCATIONS	// (If uncommented) Replaces the global operator new to count every heap allocation, game and engine, per frame
+
+//Bump allocator for data that only lives until the end of the frame. Everything is released at once by Reset,
+//and after the first few frames the arena has grown to fit and stops touching the heap. Main thread only.
+class FrameArena
+{
+public:
+	FrameArena(size_t initialSize);
+	~FrameArena();
+
+	void*		Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	void		Reset();
+
+	size_t		GetBytesUsed() const;
+	size_t		GetLastFrameBytesUsed() const;
+	size_t		GetCapacity() const;
+	int			GetLastFrameHeapAllocations() const;
+
+	//The stats overlay, dev console and debug drawing allocate inside the engine every frame they draw.
+	//Allocations between these calls are reported on their own, so the game's count can reach zero with the overlay up.
+	void		BeginDebugAllocations();
+	void		EndDebugAllocations();
+	int			GetLastFrameDebugHeapAllocations() const;
+
+private:
+	struct Chunk
+	{
+		unsigned char*	m_memory = nullptr;
+		size_t			m_size = 0;
+	};
+
+	void		AddChunk(size_t minSize);
+
+	std::vector<Chunk>	m_chunks;
+	int					m_currentChunk = 0;
+	size_t				m_offset = 0;
+	size_t				m_bytesUsed = 0;
+	size_t				m_lastFrameBytesUsed = 0;
+
+	//Heap allocations made anywhere in the process between two resets, less those made for debug output
+	int					m_heapAllocationsAtFrameStart = 0;
+	int					m_lastFrameHeapAllocations = 0;
+	int					m_heapAllocationsAtDebugStart = 0;
+	int					m_debugHeapAllocations = 0;
+	int					m_lastFrameDebugHeapAllocations = 0;
+};
+
+extern FrameArena* g_theFrameArena;
+
+//Counts every global operator new; the count only goes up. Always zero unless GAME_COUNT_HEAP_ALLOCATIONS is defined.
+int GetNumHeapAllocations();
+
+//STL allocator over the frame arena; freeing is a no-op, memory comes back at the end of the frame
+template<typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator() = default;
+	template<typename U> FrameAllocator(FrameAllocator<U> const&) {}
+
+	T*		allocate(size_t count)						{ return (T*)g_theFrameArena->Allocate(count * sizeof(T), alignof(T)); }
+	void	deallocate(T*, size_t)						{}
+
+	template<typename U> bool operator==(FrameAllocator<U> const&) const	{ return true; }
+	template<typename U> bool operator!=(FrameAllocator<U> const&) const	{ return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> FrameString;
+
+//Stringf into the arena; the text is valid until the end of the frame
+char const* FrameStringf(char const* format, ...);
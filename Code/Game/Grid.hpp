@@ -0,0 +1,209 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+
+//ROW_MAJOR keeps each row contiguous for spans and sweeps.
+//BLOCKED stores 8x8 blocks contiguously, so small 2D neighbourhoods touch a couple of cache lines instead of up to nine rows.
+enum class GridLayout
+{
+	ROW_MAJOR,
+	BLOCKED
+};
+
+constexpr int GRID_BLOCK_SIZE_LOG2 = 3;
+constexpr int GRID_BLOCK_SIZE = 1 << GRID_BLOCK_SIZE_LOG2;
+constexpr int GRID_BLOCK_MASK = GRID_BLOCK_SIZE - 1;
+
+//Contiguous cells of one row, for loops the compiler can vectorise
+template <typename T>
+struct GridRowSpan
+{
+	T*	m_data = nullptr;
+	int	m_count = 0;
+};
+
+//A 2D array of cells addressed by (x, y), with y up like the map.
+//Get is unchecked; GetClamped and IsInBounds are branch-free so per-cell loops stay cheap at the edges.
+template <typename T>
+class Grid
+{
+public:
+	Grid() = default;
+	Grid(IntVec2 const& dimensions, T const& initialValue, GridLayout layout = GridLayout::ROW_MAJOR);
+	~Grid() = default;
+
+	void				Initialize(IntVec2 const& dimensions, T const& initialValue, GridLayout layout = GridLayout::ROW_MAJOR);
+	void				Fill(T const& value);
+
+	IntVec2 const&		GetDimensions() const	{ return m_dimensions; }
+	int					GetNumCells() const		{ return m_dimensions.x * m_dimensions.y; }
+	GridLayout			GetLayout() const		{ return m_layout; }
+	bool				IsInBounds(int x, int y) const;
+	int					GetIndex(int x, int y) const;
+
+	T&					Get(int x, int y)					{ return m_cells[GetIndex(x, y)]; }
+	T const&			Get(int x, int y) const				{ return m_cells[GetIndex(x, y)]; }
+	T const&			GetClamped(int x, int y) const;
+	T const&			GetOrDefault(int x, int y, T const& outsideValue) const;
+	void				Set(int x, int y, T const& value)	{ m_cells[GetIndex(x, y)] = value; }
+
+	//Row-major only
+	GridRowSpan<T>		GetRow(int y);
+	GridRowSpan<T const>	GetRow(int y) const;
+
+	//Edge neighbours first (+y, -y, -x, +x), then corners; cells off the grid are skipped
+	template <typename Function>
+	void				ForEachNeighbor4(int x, int y, Function&& function) const;
+	template <typename Function>
+	void				ForEachNeighbor8(int x, int y, Function&& function) const;
+
+	//Every cell in [mins, maxs), clipped to the grid, in y-then-x order
+	template <typename Function>
+	void				ForEachInRange(IntVec2 const& mins, IntVec2 const& maxs, Function&& function) const;
+
+	std::vector<T>&			GetCells()			{ return m_cells; }
+	std::vector<T> const&	GetCells() const	{ return m_cells; }
+
+private:
+	IntVec2				m_dimensions;
+	GridLayout			m_layout = GridLayout::ROW_MAJOR;
+	int					m_numBlocksX = 0;
+	std::vector<T>		m_cells;
+};
+
+constexpr int GRID_NEIGHBOR_OFFSETS_X[8] = { 0, 0, -1, 1, 1, -1, -1, 1 };
+constexpr int GRID_NEIGHBOR_OFFSETS_Y[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+
+template <typename T>
+Grid<T>::Grid(IntVec2 const& dimensions, T const& initialValue, GridLayout layout)
+{
+	Initialize(dimensions, initialValue, layout);
+}
+
+template <typename T>
+void Grid<T>::Initialize(IntVec2 const& dimensions, T const& initialValue, GridLayout layout)
+{
+	m_dimensions = dimensions;
+	m_layout = layout;
+	if (m_layout == GridLayout::BLOCKED)
+	{
+		//Padded out to whole blocks; the padding is never addressed
+		m_numBlocksX = (dimensions.x + GRID_BLOCK_MASK) >> GRID_BLOCK_SIZE_LOG2;
+		int numBlocksY = (dimensions.y + GRID_BLOCK_MASK) >> GRID_BLOCK_SIZE_LOG2;
+		m_cells.assign(m_numBlocksX * numBlocksY * GRID_BLOCK_SIZE * GRID_BLOCK_SIZE, initialValue);
+	}
+	else
+	{
+		m_numBlocksX = 0;
+		m_cells.assign(dimensions.x * dimensions.y, initialValue);
+	}
+}
+
+template <typename T>
+void Grid<T>::Fill(T const& value)
+{
+	for (int i = 0; i < (int)m_cells.size(); i++)
+	{
+		m_cells[i] = value;
+	}
+}
+
+template <typename T>
+bool Grid<T>::IsInBounds(int x, int y) const
+{
+	//Negative coords wrap to huge unsigned values, so one compare per axis covers both ends
+	return ((unsigned int)x < (unsigned int)m_dimensions.x) & ((unsigned int)y < (unsigned int)m_dimensions.y);
+}
+
+template <typename T>
+int Grid<T>::GetIndex(int x, int y) const
+{
+	if (m_layout == GridLayout::ROW_MAJOR)
+	{
+		return (y * m_dimensions.x) + x;
+	}
+	int block = ((y >> GRID_BLOCK_SIZE_LOG2) * m_numBlocksX) + (x >> GRID_BLOCK_SIZE_LOG2);
+	return (block << (2 * GRID_BLOCK_SIZE_LOG2)) + ((y & GRID_BLOCK_MASK) << GRID_BLOCK_SIZE_LOG2) + (x & GRID_BLOCK_MASK);
+}
+
+template <typename T>
+T const& Grid<T>::GetClamped(int x, int y) const
+{
+	//Written as selects so they compile to conditional moves
+	x = (x < 0) ? 0 : x;
+	x = (x >= m_dimensions.x) ? m_dimensions.x - 1 : x;
+	y = (y < 0) ? 0 : y;
+	y = (y >= m_dimensions.y) ? m_dimensions.y - 1 : y;
+	return m_cells[GetIndex(x, y)];
+}
+
+template <typename T>
+T const& Grid<T>::GetOrDefault(int x, int y, T const& outsideValue) const
+{
+	return IsInBounds(x, y) ? m_cells[GetIndex(x, y)] : outsideValue;
+}
+
+template <typename T>
+GridRowSpan<T> Grid<T>::GetRow(int y)
+{
+	GridRowSpan<T> span;
+	span.m_data = &m_cells[y * m_dimensions.x];
+	span.m_count = m_dimensions.x;
+	return span;
+}
+
+template <typename T>
+GridRowSpan<T const> Grid<T>::GetRow(int y) const
+{
+	GridRowSpan<T const> span;
+	span.m_data = &m_cells[y * m_dimensions.x];
+	span.m_count = m_dimensions.x;
+	return span;
+}
+
+template <typename T>
+template <typename Function>
+void Grid<T>::ForEachNeighbor4(int x, int y, Function&& function) const
+{
+	for (int i = 0; i < 4; i++)
+	{
+		int neighborX = x + GRID_NEIGHBOR_OFFSETS_X[i];
+		int neighborY = y + GRID_NEIGHBOR_OFFSETS_Y[i];
+		if (IsInBounds(neighborX, neighborY))
+		{
+			function(neighborX, neighborY, m_cells[GetIndex(neighborX, neighborY)]);
+		}
+	}
+}
+
+template <typename T>
+template <typename Function>
+void Grid<T>::ForEachNeighbor8(int x, int y, Function&& function) const
+{
+	for (int i = 0; i < 8; i++)
+	{
+		int neighborX = x + GRID_NEIGHBOR_OFFSETS_X[i];
+		int neighborY = y + GRID_NEIGHBOR_OFFSETS_Y[i];
+		if (IsInBounds(neighborX, neighborY))
+		{
+			function(neighborX, neighborY, m_cells[GetIndex(neighborX, neighborY)]);
+		}
+	}
+}
+
+template <typename T>
+template <typename Function>
+void Grid<T>::ForEachInRange(IntVec2 const& mins, IntVec2 const& maxs, Function&& function) const
+{
+	int minX = (mins.x > 0) ? mins.x : 0;
+	int minY = (mins.y > 0) ? mins.y : 0;
+	int maxX = (maxs.x < m_dimensions.x) ? maxs.x : m_dimensions.x;
+	int maxY = (maxs.y < m_dimensions.y) ? maxs.y : m_dimensions.y;
+	for (int y = minY; y < maxY; y++)
+	{
+		for (int x = minX; x < maxX; x++)
+		{
+			function(x, y, m_cells[GetIndex(x, y)]);
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#include "GridBenchmark.hpp"
+#include "Game/Grid.hpp"
+#include "Game/MapGenerator.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include <vector>
+#include <cstdint>
+
+extern DevConsole* g_theDevConsole;
+
+static uint32_t NextRandom(uint32_t& state)
+{
+	//xorshift32: cheap enough that it doesn't hide the lookups being timed
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static void FillSolidity(Grid<unsigned char>& grid, GeneratedMap const& map)
+{
+	map.m_cells.ForEachInRange(IntVec2(0, 0), map.m_cells.GetDimensions(), [&grid](int x, int y, GeneratedCell cell)
+	{
+		grid.Set(x, y, (cell == GeneratedCell::WALL || cell == GeneratedCell::PILLAR) ? 1 : 0);
+	});
+}
+
+static void LogResult(char const* name, double seconds, int numReads, unsigned int checksum)
+{
+	g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, Stringf("  %-28s %8.2f ms  %6.2f ns/read  (checksum %u)",
+		name, seconds * 1000.0, (seconds * 1e9) / (double)numReads, checksum));
+}
+
+static void BenchmarkRandomReads(Grid<unsigned char> const& grid, std::vector<int> const& coords, char const* name)
+{
+	int numQueries = (int)coords.size() / 2;
+	unsigned int checksum = 0;
+	double startSeconds = GetCurrentTimeSeconds();
+	for (int i = 0; i < numQueries; i++)
+	{
+		checksum += grid.GetClamped(coords[2 * i], coords[(2 * i) + 1]);
+	}
+	LogResult(name, GetCurrentTimeSeconds() - startSeconds, numQueries, checksum);
+}
+
+static void BenchmarkNeighborhoods(Grid<unsigned char> const& grid, char const* name)
+{
+	IntVec2 const& dimensions = grid.GetDimensions();
+	unsigned int checksum = 0;
+	double startSeconds = GetCurrentTimeSeconds();
+	for (int y = 0; y < dimensions.y; y++)
+	{
+		for (int x = 0; x < dimensions.x; x++)
+		{
+			grid.ForEachNeighbor8(x, y, [&checksum](int neighborX, int neighborY, unsigned char value)
+			{
+				UNUSED(neighborX);
+				UNUSED(neighborY);
+				checksum += value;
+			});
+		}
+	}
+	LogResult(name, GetCurrentTimeSeconds() - startSeconds, grid.GetNumCells() * 8, checksum);
+}
+
+void RunGridBenchmarks(int gridSize, int numQueries)
+{
+	gridSize = (gridSize > 8) ? gridSize : 8;
+	numQueries = (numQueries > 1) ? numQueries : 1;
+	g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, Stringf("Grid benchmarks: %ix%i cells, %i random reads", gridSize, gridSize, numQueries));
+
+	//The solidity of a generated map, so reads see real runs of wall and floor rather than noise
+	MapGeneratorSettings settings;
+	settings.m_dimensions = IntVec2(gridSize, gridSize);
+	settings.m_seed = 12345u;
+	GeneratedMap generated;
+	GenerateMapLayout(settings, generated);
+	Grid<unsigned char> rowMajor(IntVec2(gridSize, gridSize), 0, GridLayout::ROW_MAJOR);
+	Grid<unsigned char> blocked(IntVec2(gridSize, gridSize), 0, GridLayout::BLOCKED);
+	FillSolidity(rowMajor, generated);
+	FillSolidity(blocked, generated);
+
+	//Coordinates are generated up front and run a little past the edges so the clamp is exercised
+	std::vector<int> coords(numQueries * 2);
+	uint32_t seed = 6789u;
+	for (int i = 0; i < (int)coords.size(); i++)
+	{
+		coords[i] = (int)(NextRandom(seed) % (uint32_t)(gridSize + 4)) - 2;
+	}
+
+	//The lookup Map::GetTile used to do: a flat index clamped through float
+	std::vector<unsigned char> const& flatCells = rowMajor.GetCells();
+	unsigned int checksum = 0;
+	double startSeconds = GetCurrentTimeSeconds();
+	for (int i = 0; i < numQueries; i++)
+	{
+		int index = (coords[(2 * i) + 1] * gridSize) + coords[2 * i];
+		float indexF = GetClamped((float)index, 0.f, (float)(flatCells.size() - 1));
+		checksum += flatCells[(int)indexF];
+	}
+	LogResult("random, float-clamped index", GetCurrentTimeSeconds() - startSeconds, numQueries, checksum);
+
+	BenchmarkRandomReads(rowMajor, coords, "random, row-major");
+	BenchmarkRandomReads(blocked, coords, "random, blocked");
+	BenchmarkNeighborhoods(rowMajor, "8-neighbourhood, row-major");
+	BenchmarkNeighborhoods(blocked, "8-neighbourhood, blocked");
+
+	checksum = 0;
+	startSeconds = GetCurrentTimeSeconds();
+	for (int y = 0; y < gridSize; y++)
+	{
+		GridRowSpan<unsigned char> row = rowMajor.GetRow(y);
+		for (int x = 0; x < row.m_count; x++)
+		{
+			checksum += row.m_data[x];
+		}
+	}
+	LogResult("row spans, row-major", GetCurrentTimeSeconds() - startSeconds, gridSize * gridSize, checksum);
+}
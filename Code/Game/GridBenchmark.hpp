@@ -0,0 +1,5 @@
+#pragma once
+
+//Times random and neighbourhood reads through Grid<T> in each layout against the old float-clamped tile lookup.
+//Results go to the dev console; run from the "benchmarkgrid" command.
+void RunGridBenchmarks(int gridSize, int numQueries);
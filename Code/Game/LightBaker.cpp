@@ -0,0 +1,198 @@
+#include "LightBaker.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/WorkerPool.hpp"
+#include <cfloat>
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+constexpr int LIGHT_BAKE_BATCH_SIZE = 256;
+constexpr float RAY_START_OFFSET = .01f;
+
+LightBaker::LightBaker(Grid<unsigned char> const& solidity, IntVec2 const& solidityOrigin, float wallHeight)
+	: m_solidity(solidity)
+	, m_solidityOrigin(solidityOrigin)
+{
+	m_wallHeight = wallHeight;
+	m_aoDistance = g_gameConfigBlackboard->GetValue("bakeOcclusionDistance", 1.5f);
+
+	//Three rings of six, each ring turned half a step so the samples don't line up with the grid
+	float const ringElevations[3] = { 20.f, 45.f, 70.f };
+	for (int ring = 0; ring < 3; ring++)
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			float azimuth = ((float)i + ((float)ring * .5f)) * 60.f;
+			float horizontal = CosDegrees(ringElevations[ring]);
+			m_aoDirections.push_back(Vec3(horizontal * CosDegrees(azimuth), horizontal * SinDegrees(azimuth), SinDegrees(ringElevations[ring])));
+		}
+	}
+}
+
+void LightBaker::Bake(std::vector<Vertex_PCUTBN>& verts, Vec3 const& sunDirection, float sunIntensity, float ambientIntensity, std::vector<StaticLightInfo> const& staticLights, WorkerPool* pool)
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	m_toSun = -sunDirection.GetNormalized();
+	m_sunIntensity = sunIntensity;
+	m_ambientIntensity = ambientIntensity;
+	m_staticLights = staticLights;
+
+	//Every vertex is independent and the solidity is read-only here, so batches need no locking
+	if (pool != nullptr)
+	{
+		pool->ParallelFor((int)verts.size(), LIGHT_BAKE_BATCH_SIZE, [this, &verts](int begin, int end, int workerIndex)
+		{
+			UNUSED(workerIndex);
+			for (int i = begin; i < end; i++)
+			{
+				verts[i].m_color = BakeVertex(verts[i]);
+			}
+		});
+	}
+	else
+	{
+		for (int i = 0; i < (int)verts.size(); i++)
+		{
+			verts[i].m_color = BakeVertex(verts[i]);
+		}
+	}
+
+	m_stats.m_numVerts = (int)verts.size();
+	m_stats.m_numRays = m_stats.m_numVerts * ((int)m_aoDirections.size() + 1 + (int)m_staticLights.size());
+	m_stats.m_numWorkers = (pool != nullptr) ? pool->GetNumWorkers() : 1;
+	m_stats.m_seconds = GetCurrentTimeSeconds() - startSeconds;
+}
+
+LightBakeStats const& LightBaker::GetStats() const
+{
+	return m_stats;
+}
+
+Rgba8 LightBaker::BakeVertex(Vertex_PCUTBN const& vert) const
+{
+	Vec3 normal = vert.m_normal.GetNormalized();
+	Vec3 start = vert.m_position + (normal * RAY_START_OFFSET);
+
+	float ambient = m_ambientIntensity * GetAmbientOcclusion(start, normal);
+	Vec3 light = Vec3(ambient, ambient, ambient);
+
+	//Sun: the ray only has to climb over the walls to be in the open
+	float sunDot = DotProduct3D(normal, m_toSun);
+	if (sunDot > 0.f && m_toSun.z > 0.f)
+	{
+		float sunDistance = ((m_wallHeight - start.z) / m_toSun.z) + RAY_START_OFFSET;
+		if (sunDistance <= 0.f || !IsSegmentBlocked(start, start + (m_toSun * sunDistance)))
+		{
+			float sun = m_sunIntensity * sunDot;
+			light += Vec3(sun, sun, sun);
+		}
+	}
+
+	for (int i = 0; i < (int)m_staticLights.size(); i++)
+	{
+		StaticLightInfo const& staticLight = m_staticLights[i];
+		Vec3 toLight = staticLight.m_position - start;
+		float distance = toLight.GetLength();
+		if (distance <= 0.f || distance >= staticLight.m_radius)
+		{
+			continue;
+		}
+		float lightDot = DotProduct3D(normal, toLight / distance);
+		if (lightDot <= 0.f || IsSegmentBlocked(start, staticLight.m_position))
+		{
+			continue;
+		}
+
+		float falloff = 1.f - (distance / staticLight.m_radius);
+		float strength = staticLight.m_intensity * lightDot * falloff * falloff;
+		light += Vec3(strength * (float)staticLight.m_color.r / 255.f, strength * (float)staticLight.m_color.g / 255.f, strength * (float)staticLight.m_color.b / 255.f);
+	}
+
+	//The shader still multiplies by vertex colour, so any tint already on the vertex survives
+	return Rgba8((unsigned char)(GetClamped(light.x, 0.f, 1.f) * (float)vert.m_color.r),
+		(unsigned char)(GetClamped(light.y, 0.f, 1.f) * (float)vert.m_color.g),
+		(unsigned char)(GetClamped(light.z, 0.f, 1.f) * (float)vert.m_color.b), vert.m_color.a);
+}
+
+float LightBaker::GetAmbientOcclusion(Vec3 const& position, Vec3 const& normal) const
+{
+	//Any basis around the normal will do, since the sample pattern has no preferred heading
+	Vec3 reference = (fabsf(normal.z) < .9f) ? Vec3(0.f, 0.f, 1.f) : Vec3(1.f, 0.f, 0.f);
+	Vec3 tangent = CrossProduct3D(reference, normal).GetNormalized();
+	Vec3 bitangent = CrossProduct3D(normal, tangent);
+
+	int numOpen = 0;
+	for (int i = 0; i < (int)m_aoDirections.size(); i++)
+	{
+		Vec3 const& local = m_aoDirections[i];
+		Vec3 direction = (tangent * local.x) + (bitangent * local.y) + (normal * local.z);
+		if (!IsSegmentBlocked(position, position + (direction * m_aoDistance)))
+		{
+			numOpen++;
+		}
+	}
+	return (float)numOpen / (float)m_aoDirections.size();
+}
+
+bool LightBaker::IsSegmentBlocked(Vec3 const& start, Vec3 const& end) const
+{
+	//Dipping through the floor is blocked; rising over the walls is open sky
+	if (end.z < 0.f)
+	{
+		return true;
+	}
+
+	//Walk the tile cells the segment crosses in XY, checking its height while inside each solid one
+	Vec3 delta = end - start;
+	int cellX = (int)floorf(start.x);
+	int cellY = (int)floorf(start.y);
+	int stepX = (delta.x > 0.f) ? 1 : -1;
+	int stepY = (delta.y > 0.f) ? 1 : -1;
+	float tDeltaX = (delta.x != 0.f) ? fabsf(1.f / delta.x) : FLT_MAX;
+	float tDeltaY = (delta.y != 0.f) ? fabsf(1.f / delta.y) : FLT_MAX;
+	float tMaxX = (delta.x != 0.f) ? (((delta.x > 0.f) ? ((float)(cellX + 1) - start.x) : (start.x - (float)cellX)) * tDeltaX) : FLT_MAX;
+	float tMaxY = (delta.y != 0.f) ? (((delta.y > 0.f) ? ((float)(cellY + 1) - start.y) : (start.y - (float)cellY)) * tDeltaY) : FLT_MAX;
+
+	float tEnter = 0.f;
+	while (true)
+	{
+		float tExit = (tMaxX < tMaxY) ? tMaxX : tMaxY;
+		tExit = (tExit < 1.f) ? tExit : 1.f;
+		if (IsTileSolid(cellX, cellY))
+		{
+			float zEnter = start.z + (delta.z * tEnter);
+			float zExit = start.z + (delta.z * tExit);
+			if (((zEnter < zExit) ? zEnter : zExit) < m_wallHeight)
+			{
+				return true;
+			}
+		}
+		if (tExit >= 1.f)
+		{
+			return false;
+		}
+
+		tEnter = tExit;
+		if (delta.z >= 0.f && start.z + (delta.z * tEnter) >= m_wallHeight)
+		{
+			return false;
+		}
+		if (tMaxX < tMaxY)
+		{
+			cellX += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			cellY += stepY;
+			tMaxY += tDeltaY;
+		}
+	}
+}
+
+bool LightBaker::IsTileSolid(int x, int y) const
+{
+	return m_solidity.GetOrDefault(x - m_solidityOrigin.x, y - m_solidityOrigin.y, 0) != 0;
+}
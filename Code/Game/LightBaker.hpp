@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/Grid.hpp"
+
+class WorkerPool;
+
+struct LightBakeStats
+{
+	int		m_numVerts = 0;
+	int		m_numRays = 0;
+	int		m_numWorkers = 0;
+	double	m_seconds = 0.0;
+};
+
+//Bakes sun, ambient occlusion and static lights into the colour of map vertices, optionally spread across a worker pool.
+//Walls are full-height tile columns, so every occlusion test is a walk through a snapshot of the solidity grid.
+//The snapshot can be a window of the map starting at solidityOrigin; tiles outside it count as open.
+class LightBaker
+{
+public:
+	LightBaker(Grid<unsigned char> const& solidity, IntVec2 const& solidityOrigin, float wallHeight);
+	~LightBaker() = default;
+
+	void					Bake(std::vector<Vertex_PCUTBN>& verts, Vec3 const& sunDirection, float sunIntensity, float ambientIntensity, std::vector<StaticLightInfo> const& staticLights, WorkerPool* pool);
+	LightBakeStats const&	GetStats() const;
+
+private:
+	Rgba8					BakeVertex(Vertex_PCUTBN const& vert) const;
+	float					GetAmbientOcclusion(Vec3 const& position, Vec3 const& normal) const;
+	bool					IsSegmentBlocked(Vec3 const& start, Vec3 const& end) const;
+	bool					IsTileSolid(int x, int y) const;
+
+	Grid<unsigned char> const&	m_solidity;
+	IntVec2					m_solidityOrigin;
+	float					m_wallHeight = 1.f;
+	float					m_aoDistance = 1.5f;
+
+	//Hemisphere around +z, rotated onto each vertex normal
+	std::vector<Vec3>		m_aoDirections;
+
+	Vec3							m_toSun;
+	float							m_sunIntensity = 0.f;
+	float							m_ambientIntensity = 0.f;
+	std::vector<StaticLightInfo>	m_staticLights;
+
+	LightBakeStats			m_stats;
+};
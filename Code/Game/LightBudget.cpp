@@ -0,0 +1,97 @@
+#include "LightBudget.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+//How far a light of intensity 1 reaches before it stops mattering
+constexpr float LIGHT_RADIUS_PER_INTENSITY = 40.f;
+
+void LightBudget::BeginView(Vec3 const& position, EulerAngles const& orientation, float fovDegrees, float aspect, float farDistance)
+{
+	m_position = position;
+	orientation.GetAsVectors_IFwd_JLeft_KUp(m_forward, m_left, m_up);
+	m_tanHalfVertical = SinDegrees(fovDegrees * .5f) / CosDegrees(fovDegrees * .5f);
+	m_tanHalfHorizontal = m_tanHalfVertical * aspect;
+	m_farDistance = farDistance;
+}
+
+void LightBudget::SelectLights(std::vector<PointLight> const& lights)
+{
+	m_stats = LightBudgetStats();
+	m_stats.m_numLights = (int)lights.size();
+	m_scores.resize(lights.size());
+	m_selectedLights.clear();
+
+	for (int i = 0; i < (int)lights.size(); i++)
+	{
+		if (!IsLightInView(lights[i]))
+		{
+			continue;
+		}
+		float radius = GetLightRadius(lights[i]);
+		float distance = (lights[i].LightPosition - m_position).GetLength();
+		m_scores[i] = lights[i].Intensity / (1.f + ((distance * distance) / (radius * radius)));
+		m_selectedLights.push_back(i);
+	}
+	m_stats.m_numVisible = (int)m_selectedLights.size();
+
+	//The constant buffer holds a fixed number of lights; past that the dimmest go first.
+	//Ties resolve by light order so the same scene picks the same lights every frame
+	constexpr int MAX_UPLOADED_LIGHTS = (int)(sizeof(LightConstants::c_pointLightList) / sizeof(PointLight));
+	auto isBrighter = [this](int a, int b)
+	{
+		return (m_scores[a] != m_scores[b]) ? (m_scores[a] > m_scores[b]) : (a < b);
+	};
+	if ((int)m_selectedLights.size() > MAX_UPLOADED_LIGHTS)
+	{
+		m_stats.m_numOverBudget = (int)m_selectedLights.size() - MAX_UPLOADED_LIGHTS;
+		std::partial_sort(m_selectedLights.begin(), m_selectedLights.begin() + MAX_UPLOADED_LIGHTS, m_selectedLights.end(), isBrighter);
+		m_selectedLights.resize(MAX_UPLOADED_LIGHTS);
+	}
+	else
+	{
+		std::sort(m_selectedLights.begin(), m_selectedLights.end(), isBrighter);
+	}
+	m_stats.m_numUploaded = (int)m_selectedLights.size();
+}
+
+void LightBudget::WriteLightConstants(std::vector<PointLight> const& lights, LightConstants& constants) const
+{
+	for (int i = 0; i < (int)m_selectedLights.size(); i++)
+	{
+		constants.c_pointLightList[i] = lights[m_selectedLights[i]];
+	}
+	constants.c_numPointLights = (unsigned int)m_selectedLights.size();
+}
+
+LightBudgetStats const& LightBudget::GetStats() const
+{
+	return m_stats;
+}
+
+float LightBudget::GetLightRadius(PointLight const& light)
+{
+	float radius = light.Intensity * LIGHT_RADIUS_PER_INTENSITY;
+	return (radius > .01f) ? radius : .01f;
+}
+
+bool LightBudget::IsLightInView(PointLight const& light) const
+{
+	float radius = GetLightRadius(light);
+	Vec3 toLight = light.LightPosition - m_position;
+	float depth = DotProduct3D(toLight, m_forward);
+	if (depth + radius < m_nearDistance || depth - radius > m_farDistance)
+	{
+		return false;
+	}
+
+	//Bound the sphere by its box in view space; each edge divides by whichever depth pushes it furthest out
+	float right = -DotProduct3D(toLight, m_left);
+	float up = DotProduct3D(toLight, m_up);
+	float nearDepth = (depth - radius > m_nearDistance) ? depth - radius : m_nearDistance;
+	float farDepth = (depth + radius > m_nearDistance) ? depth + radius : m_nearDistance;
+	float minX = ((right - radius) / (((right - radius) < 0.f) ? nearDepth : farDepth)) / m_tanHalfHorizontal;
+	float maxX = ((right + radius) / (((right + radius) > 0.f) ? nearDepth : farDepth)) / m_tanHalfHorizontal;
+	float minY = ((up - radius) / (((up - radius) < 0.f) ? nearDepth : farDepth)) / m_tanHalfVertical;
+	float maxY = ((up + radius) / (((up + radius) > 0.f) ? nearDepth : farDepth)) / m_tanHalfVertical;
+	return !(maxX < -1.f || minX > 1.f || maxY < -1.f || minY > 1.f);
+}
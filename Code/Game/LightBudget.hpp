@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+struct LightBudgetStats
+{
+	int		m_numLights = 0;
+	int		m_numVisible = 0;
+	int		m_numUploaded = 0;
+	int		m_numOverBudget = 0;
+};
+
+//Intensity-sorted global light budget: picks which point lights make the flat list in LightConstants for one view.
+//Lights whose reach misses the view are culled; past the buffer's capacity the dimmest, by intensity and distance to the eye, are dropped.
+class LightBudget
+{
+public:
+	LightBudget() = default;
+	~LightBudget() = default;
+
+	void						BeginView(Vec3 const& position, EulerAngles const& orientation, float fovDegrees, float aspect, float farDistance);
+	void						SelectLights(std::vector<PointLight> const& lights);
+	void						WriteLightConstants(std::vector<PointLight> const& lights, LightConstants& constants) const;
+
+	LightBudgetStats const&		GetStats() const;
+
+	static float				GetLightRadius(PointLight const& light);
+
+private:
+	bool						IsLightInView(PointLight const& light) const;
+
+	Vec3						m_position;
+	Vec3						m_forward;
+	Vec3						m_left;
+	Vec3						m_up;
+	float						m_tanHalfHorizontal = 1.f;
+	float						m_tanHalfVertical = 1.f;
+	float						m_nearDistance = .1f;
+	float						m_farDistance = 100.f;
+
+	//Scores are what the budget sorts by: brighter and closer to the eye wins
+	std::vector<float>			m_scores;
+
+	//Lights that made the upload, best first
+	std::vector<int>			m_selectedLights;
+
+	LightBudgetStats			m_stats;
+};
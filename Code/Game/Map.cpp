@@ -1,982 +1,2425 @@
-#include "Map.hpp"
-#include "Game/Game.hpp"
-#include "Engine/Renderer/Texture.hpp"
-#include "Engine/Renderer/Shader.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Renderer/VertexBuffer.hpp"
-#include "Engine/Renderer/IndexBuffer.hpp"
-#include "Engine/Renderer/ConstantBuffer.hpp"
-#include "Engine/Core/Image.hpp"
-#include "Engine/Math/MathUtils.hpp"
-#include "Engine/Core/DebugRenderSystem.hpp"
-#include "Game/MapDefinition.hpp"
-#include "Game/ActorDefinition.hpp"
-#include "AI.hpp"
-
-extern Renderer* g_theRenderer;
-extern RandomNumberGenerator* g_rng;
-
-Map::Map()
-{
-	m_definition = nullptr;
-}
-
-Map::Map(Game* game, const MapDefinition* definition)
-{
-	m_game = game;
-	m_definition = definition;
-	m_texture = definition->GetTexture();
-	m_shader = definition->GetShader();
-	CreateTiles();
-	CreateGeometry();
-	CreateBuffers();
-
-	Texture* skyBoxTexture = g_theRenderer->CreateOrGetTextureFromFile(m_definition->m_skyBoxFilePath.c_str());
-	m_skyBoxSheet = new SpriteSheet(*skyBoxTexture, IntVec2(4, 3));
-	CreateSkybox();
-}
-
-Map::~Map()
-{
-	delete m_definition;
-	m_verts.clear();
-	m_vertIndexes.clear();
-	m_tiles.clear();
-
-	for (int i = 0; i < (int)m_actors.size(); i++)
-	{
-		delete m_actors[i];
-	}
-	m_actors.clear();
-	delete m_vBuffer;
-	delete m_iBuffer;
-	delete m_lightBuffer;
-	delete m_skyBoxSheet;
-	m_game = nullptr;
-}
-
-void Map::CreateTiles()
-{
-	std::string imageFilePath = "Data/Maps/" + m_definition->GetName() + ".png";
-	Image* mapImage = g_theRenderer->CreateImageFromFile(imageFilePath.c_str());
-	m_dimensions = mapImage->GetDimensions();
-	std::vector<Rgba8> texels = mapImage->GetDataAsRgba8Vector();
-
-	for (int rows = 0; rows < m_dimensions.y; rows++)
-	{
-		for (int cols = 0; cols < m_dimensions.x; cols++)
-		{
-			int index = (rows*m_dimensions.y) + cols;
-			TileDefinition* selectedTile;
-			for (int defIndex = 0; defIndex < m_game->m_tileDefs.size(); defIndex++)
-			{
-				Rgba8 texelColor = texels[index];
-				if (m_game->m_tileDefs[defIndex]->GetMapPixelColor() == texelColor)
-				{
-					selectedTile = m_game->m_tileDefs[defIndex];
-					m_tiles.push_back(Tile(cols, rows, *selectedTile));
-					break;
-				}
-			}
-		}
-	}
-
-	delete mapImage;
-}
-
-void Map::CreateGeometry()
-{
-	for (int i = 0; i < m_tiles.size(); i++)
-	{
-		SpriteSheet* sheet = m_game->m_spriteSheet;
-		IntVec2 sheetDims = m_definition->GetSpriteCellCount();
-		AABB3 bounds = m_tiles[i].m_bounds;
-		IntVec2 spriteCoords = m_tiles[i].m_tileDef.GetWallCoords();
-		IntVec2 secondaryCoords = m_tiles[i].m_tileDef.GetSecondaryCoords();
-
-		if (spriteCoords.x != -1)
-		{
-			AddGeometryForWall(bounds, sheet->GetSpriteUVs(spriteCoords), sheet->GetSpriteUVs(secondaryCoords));
-		}
-
-		spriteCoords = m_tiles[i].m_tileDef.GetFloorCoords();
-		if (spriteCoords.x != -1)
-		{
-			AddGeometryForFloor(bounds, sheet->GetSpriteUVs(spriteCoords));
-		}
-
-		spriteCoords = m_tiles[i].m_tileDef.GetCeilingCoords();
-		if (spriteCoords.x != -1)
-		{
-			AddGeometryForCeiling(bounds, sheet->GetSpriteUVs(spriteCoords));
-		}
-	}
-}
-
-void Map::AddGeometryForWall(const AABB3& bounds, const AABB2& UVs, const AABB2& UV2s)
-{
-	for (int i = 0; i < (int)m_definition->m_ceilingHeight; i++)
-	{
-		float random = g_rng->RollRandomFloatInRange(0.f, 100.f);
-		if (random <= 33.f)
-		{
-			//Facing -y
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i + 1), bounds.m_mins + Vec3(0, 0, (float)i + 1),
-				Vec3(0, -1, 0), Rgba8::WHITE, UV2s);
-			//Facing +x
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 1, (float)i), bounds.m_maxs + Vec3(0, 0, (float)i), bounds.m_maxs + Vec3(0, -1, (float)i),
-				Vec3(1, 0, 0), Rgba8::WHITE, UV2s);
-			//Facing +y
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_maxs + Vec3(0, 0, (float)i - 1), bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 1, (float)i + 1), bounds.m_maxs + Vec3(0, 0, (float)i),
-				Vec3(0, 1, 0), Rgba8::WHITE, UV2s);
-			//Facing -x
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(0, 0, (float)i + 1), bounds.m_mins + Vec3(0, 1, (float)i + 1),
-				Vec3(-1, 0, 0), Rgba8::WHITE, UV2s);
-		}
-		else
-		{
-			//Facing -y
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i + 1), bounds.m_mins + Vec3(0, 0, (float)i + 1),
-				Vec3(0, -1, 0), Rgba8::WHITE, UVs);
-			//Facing +x
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 1, (float)i), bounds.m_maxs + Vec3(0, 0, (float)i), bounds.m_maxs + Vec3(0, -1, (float)i),
-				Vec3(1, 0, 0), Rgba8::WHITE, UVs);
-			//Facing +y
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_maxs + Vec3(0, 0, (float)i - 1), bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 1, (float)i + 1), bounds.m_maxs + Vec3(0, 0, (float)i),
-				Vec3(0, 1, 0), Rgba8::WHITE, UVs);
-			//Facing -x
-			AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(0, 0, (float)i + 1), bounds.m_mins + Vec3(0, 1, (float)i + 1),
-				Vec3(-1, 0, 0), Rgba8::WHITE, UVs);
-		}
-	}
-}
-
-void Map::AddGeometryForFloor(const AABB3& bounds, const AABB2& UVs)
-{
-	AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_mins, bounds.m_mins + Vec3(1, 0, 0), bounds.m_maxs + Vec3(0, 0, -1), bounds.m_maxs + Vec3(-1, 0, -1),
-		Vec3(0, 0, 1), Rgba8::WHITE, UVs);
-}
-
-void Map::AddGeometryForCeiling(const AABB3& bounds, const AABB2& UVs)
-{
-	AddVertsForQuad3D(m_verts, m_vertIndexes, bounds.m_maxs + Vec3(-1, 0, m_definition->m_ceilingHeight - 1), bounds.m_maxs + Vec3(0,0, m_definition->m_ceilingHeight - 1), bounds.m_mins + Vec3(1, 0, m_definition->m_ceilingHeight), bounds.m_mins + Vec3(0, 0, m_definition->m_ceilingHeight),
-		Vec3(0, 0, -1), Rgba8::WHITE, UVs);
-}
-
-void Map::CreateBuffers()
-{
-	unsigned int numVerts = static_cast<unsigned int>(m_verts.size());
-	const Vertex_PCUTBN* addressOfFirstElement = &m_verts.front();
-	m_vBuffer = g_theRenderer->CreateVertexBuffer(numVerts * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	g_theRenderer->CopyCPUToGPU(addressOfFirstElement, numVerts, m_vBuffer);
-
-	unsigned int numIndexes = static_cast<unsigned int>(m_vertIndexes.size());
-	const unsigned int* addressOfIndex = &m_vertIndexes.front();
-	m_iBuffer = g_theRenderer->CreateIndexBuffer(numIndexes);
-	g_theRenderer->CopyCPUToGPU(addressOfIndex, numIndexes, m_iBuffer);
-
-	m_lightBuffer = g_theRenderer->CreateConstantBuffer(sizeof(LightConstants));
-	LightConstants light;
-	light.c_sunDirection = m_game->m_lightDirection.GetNormalized();
-	light.c_sunIntensity = m_game->m_lightIntensity;
-	light.c_ambientIntensity = m_game->m_ambientIntensity;
-	m_lightConstants = light;
-	g_theRenderer->CopyCPUToGPU(&m_lightConstants, sizeof(LightConstants), m_lightBuffer);
-}
-
-void Map::CreateSkybox()
-{
-	m_skyBoxLocalBounds.m_mins = m_skyBoxLocalBounds.m_mins + Vec3(m_dimensions.x * .5f, m_dimensions.y * .5f, 0.f);
-	m_skyBoxLocalBounds.m_maxs = m_skyBoxLocalBounds.m_maxs + Vec3(m_dimensions.x * .5f, m_dimensions.y * .5f, 0.f);
-	AddVertsForSkyBoxAABB3D(m_skyBoxVerts, m_skyBoxLocalBounds, *m_skyBoxSheet);
-}
-
-Actor* Map::SpawnPlayer(Player* possessingPlayer, Vec3 const& location)
-{
-	//Load Marine Actor
-	SpawnInfo sp;
-	sp.m_actor = "Marine";
-	sp.m_orientation = EulerAngles();
-	
-	sp.m_position = location;
-	sp.m_velocity = Vec3();
-
-	//Spawn Marine
-	Actor* player = SpawnActor(sp);
-
-	//Set controller variables
-	possessingPlayer->m_playerCamPosition = sp.m_position;
-	possessingPlayer->m_playerCamOrientation = sp.m_orientation;
-	possessingPlayer->m_possessedActor = player->m_handle;
-	possessingPlayer->m_map = this;
-
-	//Set actor variables
-	player->m_controller = possessingPlayer;
-	player->m_isAI = false;
-	player->m_AIController = new AI();
-	player->m_AIController->m_possessedActor = player->m_handle;
-	player->m_AIController->m_map = player->m_spawnMap;
-	
-	return player;
-}
-
-void Map::KillPlayer(Player* possessingPlayer)
-{
-	m_actors[possessingPlayer->m_possessedActor.GetIndex()]->m_controller = nullptr;
-	delete m_actors[possessingPlayer->m_possessedActor.GetIndex()];
-	m_actors[possessingPlayer->m_possessedActor.GetIndex()] = nullptr;
-	possessingPlayer->m_possessedActor = ActorHandle::INVALID;
-}
-
-Actor* Map::SpawnActor(const SpawnInfo& spawnInfo)
-{
-	//Manage and check Handle
-	unsigned int index = (int)m_actors.size();
-	unsigned int uid = m_nextActorUID;
-	m_nextActorUID++;
-	if (uid >= ActorHandle::MAX_ACTOR_UID)
-	{
-		ERROR_AND_DIE("UIDs have run out of space. Error in SpawnActor");
-	}
-
-	//Find next available index. Error if out of range
-	for (int i = 0; i < (int)m_actors.size(); i++)
-	{
-		if (m_actors[i] == nullptr)
-		{
-			index = i;
-			break;
-		}
-	}
-	if (index >= ActorHandle::MAX_ACTOR_INDEX)
-	{
-		ERROR_AND_DIE("Actor vector has run out of space. Error in SpawnActor");
-	}
-	ActorHandle newHandle = ActorHandle(uid, index);
-	ActorDefinition useThis;
-	useThis.m_name = "undefined";
-	for (int i = 0; i < (int)m_game->m_actorDefs.size(); i++)
-	{
-		if (spawnInfo.m_actor == m_game->m_actorDefs[i]->m_name)
-		{
-			useThis = *m_game->m_actorDefs[i];
-		}
-	}
-	if (useThis.m_name == "undefined")
-	{
-		ERROR_AND_DIE("Error: Could not spawn actor due to invalid actor definition (SpawnActor)");
-	}
-
-	//Create the new Actor
-	Actor* newActor = new Actor(this, newHandle, useThis, spawnInfo.m_position, spawnInfo.m_orientation, spawnInfo.m_velocity);
-	if (index == (int)m_actors.size())
-	{
-		m_actors.push_back(newActor);
-	}
-	else
-	{
-		m_actors[index] = newActor;
-	}
-
-	newActor->m_owningActor = ActorHandle::INVALID;
-	return newActor;
-}
-
-void Map::KillAIActor(const ActorHandle handle)
-{
-	delete m_actors[handle.GetIndex()]->m_controller;
-	m_actors[handle.GetIndex()]->m_controller = nullptr;
-	delete m_actors[handle.GetIndex()];
-	m_actors[handle.GetIndex()] = nullptr;
-}
-
-Actor* Map::GetActorByHandle(const ActorHandle handle) const
-{
-	unsigned int index = handle.GetIndex();
-
-	if (m_actors[index] != nullptr)
-	{
-		if (handle == m_actors[index]->m_handle)
-		{
-			return m_actors[index];
-		}
-	}
-	return nullptr;
-}
-
-void Map::DeleteDestroyedActors()
-{
-	for (int i = 0; i < (int)m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr)
-		{
-			if (m_actors[i]->m_expired)
-			{
-				delete m_actors[i];
-				m_actors[i] = nullptr;
-			}
-		}
-	}
-}
-
-Actor* Map::GetClosestVisibleEnemy(Actor* searchingActor) const
-{
-	float shortestDistanceHit = 9999.f;
-	Actor* output = nullptr;
-
-	for (int i = 0; i < (int)m_actors.size(); i++)
-	{
-		//Filter nulls
-		if (m_actors[i] != nullptr)
-		{
-			//Filter same factions and invisibles
-			//
-			if (m_actors[i]->m_definition.m_visible && searchingActor->m_definition.m_AIElement.m_aiEnabled && !m_actors[i]->m_definition.m_isPickup &&
-				searchingActor->m_definition.m_faction != m_actors[i]->m_definition.m_faction &&
-				m_actors[i]->m_definition.m_faction != Faction::NEUTRAL)
-			{
-				//If the point is well outside of vision cone skip
-				Vec3 sightLine = m_actors[i]->m_position - searchingActor->GetVisionStartPoint();
-				if (IsPointInsideVisionCone(searchingActor->GetVisionStartPoint(), searchingActor->m_orientation, searchingActor->m_definition.m_AIElement.m_sightAngle, m_actors[i]->m_position))
-				{
-					Actor* detection = nullptr;
-					//std::vector<Actor*> potentialTargets = m_game->m_map->GetActorsInSector(searchingActor, searchingActor->m_definition.m_AIElement.m_sightAngle, searchingActor->m_definition.m_AIElement.m_sightRadius);
-					RaycastResult3D result = RaycastAll(searchingActor->GetVisionStartPoint(), sightLine.GetNormalized(),
-						searchingActor->m_definition.m_AIElement.m_sightRadius, detection, searchingActor);
-					//If the actor output is not null (the raycast hit the actor)
-					if (detection && result.m_impactDist <= shortestDistanceHit)
-					{
-						shortestDistanceHit = result.m_impactDist;
-						output = detection;
-					}
-				}
-			}
-		}
-	}
-
-	return output;
-}
-
-void Map::DebugPossessNext()
-{
-	for (int i = 1; i <= (int)m_actors.size(); i++)
-	{
-		int index = (m_game->m_player->m_possessedActor.GetIndex() + i) % ((int)m_actors.size());
-
-		//Filter nulls
-		if (m_actors[index] != nullptr && m_actors[index]->m_definition.m_canBePossessed && m_actors[index]->m_isAI)
-		{
-			m_game->m_player->Possess(m_actors[index]->m_handle);
-			break;
-		}
-	}
-}
-
-bool Map::IsPositionInBounds(const Vec3& position) const
-{
-	FloatRange xRange = FloatRange(0.f, (float)m_dimensions.x + 1.f);
-	FloatRange yRange = FloatRange(0.f, (float)m_dimensions.y + 1.f);
-	return xRange.IsOnRange(position.x) && yRange.IsOnRange(position.y);
-}
-
-IntVec2 Map::GetCoordFromPosition(const Vec3& position) const
-{
-	return IntVec2((int)position.x, (int)position.y);
-}
-
-bool Map::AreCoordsInBounds(int x, int y) const
-{
-	if (m_dimensions.x >= x && 0 <= x && m_dimensions.y >= y && 0 <= y)
-	{
-		return true;
-	}
-	return false;
-}
-
-const Tile* Map::GetTile(int x, int y) const
-{
-	int index = (y * m_dimensions.y) + x;
-	float maxIndex = (float)(m_dimensions.x - 1) + (float)((m_dimensions.y - 1) * (m_dimensions.y));
-	float indexF = GetClamped((float)index, 0.f, maxIndex);
-	return &m_tiles[(int)indexF];
-}
-
-void Map::Update()
-{
-	UpdateLightBuffer();
-	UpdateActors();
-	DeleteDestroyedActors();
-}
-
-void Map::UpdateLightBuffer()
-{
-	m_lightConstants.c_sunDirection = m_game->m_lightDirection.GetNormalized();
-	m_lightConstants.c_sunIntensity = m_game->m_lightIntensity;
-	m_lightConstants.c_ambientIntensity = m_game->m_ambientIntensity;
-	g_theRenderer->CopyCPUToGPU(&m_lightConstants, sizeof(LightConstants), m_lightBuffer);
-	ClearPointLights();
-}
-
-void Map::UpdateActors()
-{
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr)
-		{
-			m_actors[i]->Update();
-		}
-	}
-	CollideActors();
-	CollideActorsWithMap();
-}
-
-void Map::UpdateAllActorVerts()
-{
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr)
-		{
-			m_actors[i]->UpdateVerts();
-		}
-	}
-}
-
-void Map::CollideActors()
-{
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr && m_actors[i]->m_definition.m_collisionElement.m_collidesWithActors)
-		{
-			for (int j = 0; j < m_actors.size(); j++)
-			{
-				if (i != j && m_actors[j] != nullptr && m_actors[j]->m_definition.m_collisionElement.m_collidesWithActors)
-				{
-					CollideActors(m_actors[i], m_actors[j]);
-				}
-			}
-		}
-	}
-}
-
-void Map::CollideActors(Actor* a, Actor* b)
-{
-	bool collided = false;
-	Vec2 aCenterXY = Vec2(a->m_position.x, a->m_position.y);
-	Vec2 bCenterXY = Vec2(b->m_position.x, b->m_position.y);
-	FloatRange aRange = FloatRange(a->m_position.z, a->m_position.z + a->m_height-.001f);
-	FloatRange bRange = FloatRange(b->m_position.z, b->m_position.z + b->m_height-.001f);
-
-	bool aOwnsb = b->m_owningActor == a->m_handle;
-	bool bOwnsa = a->m_owningActor == b->m_handle;
-	bool aIsDead = a->m_isDead;
-	bool bIsDead = b->m_isDead;
-
-	if (aRange.IsOverlappingWith(bRange) && !aOwnsb && !bOwnsa && !aIsDead && !bIsDead)
-	{
-		if (a->m_isStatic && !b->m_isStatic)
-		{
-			bool thisImpact = PushDiscOutOfDisc2D(bCenterXY, b->m_radius, aCenterXY, a->m_radius);
-			b->m_position = Vec3(bCenterXY.x, bCenterXY.y, b->m_position.z);
-			if (!collided)
-			{
-				collided = thisImpact;
-			}
-		}
-		else if (!a->m_isStatic && b->m_isStatic)
-		{
-			bool thisImpact = PushDiscOutOfDisc2D(aCenterXY, a->m_radius, bCenterXY, b->m_radius);
-			a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-			if (!collided)
-			{
-				collided = thisImpact;
-			}
-		}
-		else
-		{
-			bool thisImpact = PushDiscsOutOfEachOther2D(aCenterXY, a->m_radius, bCenterXY, b->m_radius);
-			a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-			b->m_position = Vec3(bCenterXY.x, bCenterXY.y, b->m_position.z);
-			if (!collided)
-			{
-				collided = thisImpact;
-			}
-		}
-	}
-
-	if (collided)
-	{
-		a->OnCollide(b);
-		b->OnCollide(a);
-	}
-}
-
-void Map::CollideActorsWithMap()
-{
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr)
-		{
-			for (int j = 0; j < m_actors.size(); j++)
-			{
-				CollideActorWithMap(m_actors[i]);
-			}
-		}
-	}
-}
-
-void Map::CollideActorWithMap(Actor* a)
-{
-	bool didImpact = false;
-	if (!a->m_definition.m_collisionElement.m_collidesWithWorld || !IsPositionInBounds(a->m_position))
-	{
-		return;
-	}
-	IntVec2 tileCoordinate = GetCoordFromPosition(a->m_position);
-	const Tile* up = GetTile(tileCoordinate.x, tileCoordinate.y + 1);
-	const Tile* down = GetTile(tileCoordinate.x, tileCoordinate.y - 1);
-	const Tile* left = GetTile(tileCoordinate.x - 1, tileCoordinate.y);
-	const Tile* right = GetTile(tileCoordinate.x + 1, tileCoordinate.y);
-	const Tile* upLeft = GetTile(tileCoordinate.x - 1, tileCoordinate.y + 1);
-	const Tile* downLeft = GetTile(tileCoordinate.x - 1, tileCoordinate.y - 1);
-	const Tile* upRight = GetTile(tileCoordinate.x + 1, tileCoordinate.y + 1);
-	const Tile* downRight = GetTile(tileCoordinate.x + 1, tileCoordinate.y - 1);
-
-	Vec2 aCenterXY = Vec2(a->m_position.x, a->m_position.y);
-
-	if (up->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 upBoundsXY = AABB2(Vec2(up->m_bounds.m_mins.x, up->m_bounds.m_mins.y), Vec2(up->m_bounds.m_maxs.x, up->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, upBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (down->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 downBoundsXY = AABB2(Vec2(down->m_bounds.m_mins.x, down->m_bounds.m_mins.y), Vec2(down->m_bounds.m_maxs.x, down->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, downBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (left->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 leftBoundsXY = AABB2(Vec2(left->m_bounds.m_mins.x, left->m_bounds.m_mins.y), Vec2(left->m_bounds.m_maxs.x, left->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, leftBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (right->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 rightBoundsXY = AABB2(Vec2(right->m_bounds.m_mins.x, right->m_bounds.m_mins.y), Vec2(right->m_bounds.m_maxs.x, right->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, rightBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (upRight->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 upBoundsXY = AABB2(Vec2(upRight->m_bounds.m_mins.x, upRight->m_bounds.m_mins.y), Vec2(upRight->m_bounds.m_maxs.x, upRight->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, upBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (upLeft->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 downBoundsXY = AABB2(Vec2(upLeft->m_bounds.m_mins.x, upLeft->m_bounds.m_mins.y), Vec2(upLeft->m_bounds.m_maxs.x, upLeft->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, downBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (downLeft->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 leftBoundsXY = AABB2(Vec2(downLeft->m_bounds.m_mins.x, downLeft->m_bounds.m_mins.y), Vec2(downLeft->m_bounds.m_maxs.x, downLeft->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, leftBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-	if (downRight->m_tileDef.GetIsSolid())
-	{
-		bool collided;
-		AABB2 rightBoundsXY = AABB2(Vec2(downRight->m_bounds.m_mins.x, downRight->m_bounds.m_mins.y), Vec2(downRight->m_bounds.m_maxs.x, downRight->m_bounds.m_maxs.y));
-		collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, rightBoundsXY);
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-
-	FloatRange aRange = FloatRange(a->m_position.z, a->m_position.z + a->m_height);
-
-	if (aRange.IsOnRange(0.f))
-	{
-		bool collided;
-		float newZ =  0.f;
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, newZ);
-		collided = true;
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-
-	if (aRange.IsOnRange(m_definition->m_ceilingHeight))
-	{
-		bool collided;
-		float newZ = 1.f - a->m_height;
-		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, newZ);
-		collided = true;
-		if (collided)
-		{
-			didImpact = collided;
-		}
-	}
-
-	if (didImpact)
-	{
-		a->OnCollide();
-	}
-}
-
-std::vector<Actor*> Map::GetActorsInSector(Actor* actorReference, float sectorAngle, float radius)
-{
-	std::vector<Actor*> returnedActors;
-	for (int i = 0; i < (int)m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr && m_actors[i]->m_handle != actorReference->m_handle)
-		{
-			if (IsPointInsideDirectedSector2D(m_actors[i]->m_position.GetFlattenedXY(), actorReference->m_position.GetFlattenedXY(),
-				actorReference->m_orientation.GetForwardNormal().GetFlattenedXY(), sectorAngle, radius))
-			{
-				returnedActors.push_back(m_actors[i]);
-			}
-		}
-	}
-	return returnedActors;
-}
-
-void Map::Render() const
-{
-	g_theRenderer->SetDepthMode(DepthMode::DISABLED);
-	g_theRenderer->SetBlendMode(BlendMode::ADDITIVE);
-	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_theRenderer->SetStatesIfChanged();
-	g_theRenderer->BindTexture(&m_skyBoxSheet->GetTexture());
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->DrawVertexArray(m_skyBoxVerts);
-
-	Vec3 lightBasis = m_game->m_lightDirection.GetNormalized();
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-	g_theRenderer->BindTexture(m_texture);
-	g_theRenderer->BindShader(m_shader);
-	g_theRenderer->SetStatesIfChanged();
-	g_theRenderer->DrawLitIndexBuffer(m_vBuffer, m_iBuffer, m_lightBuffer, (int)m_vertIndexes.size());
-	RenderActors();
-	DebugRenderWorld(m_game->m_worldCamera);
-}
-
-void Map::RenderActors() const
-{
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr)
-		{
-			m_actors[i]->Render();
-		}
-	}
-}
-
-int Map::AddPointLightToMap(Vec3 const& location, float intensity, Rgba8 const& color)
-{
-	PointLight point;
-	float rgba[4];
-	color.GetAsFloats(rgba);
-	point.LightColor[0] = rgba[0];
-	point.LightColor[1] = rgba[1];
-	point.LightColor[2] = rgba[2];
-	point.LightColor[3] = rgba[3];
-
-	point.LightPosition = location;
-	point.Intensity = intensity;
-
-	m_lightConstants.c_pointLightList[m_lightConstants.c_numPointLights] = point;
-	m_lightConstants.c_numPointLights++;
-	return m_lightConstants.c_numPointLights - 1;
-}
-
-void Map::ClearPointLights()
-{
-	m_lightConstants.c_numPointLights = 0;
-}
-
-void Map::OnDemonKilled()
-{
-	m_game->m_enemiesRemainingOnMap--;
-	if (m_game->m_player)
-	{
-		m_game->m_player->m_kills++;
-	}
-}
-
-void Map::OnPlayerKilled()
-{
-}
-
-RaycastResult3D Map::RaycastAll(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner) const
-{
-	RaycastResult3D resultTotal;
-	resultTotal.m_didImpact = false;
-	resultTotal.m_impactPos = start + direction * distance;
-	resultTotal.m_rayMaxLength = distance;
-	resultTotal.m_impactDist = 10000.f;
-	if (distance == 0.f)
-	{
-		return resultTotal;
-	}
-	Vec3 ray3D = direction * distance;
-
-	RaycastResult3D resultWorldZ = RaycastWorldZ(start, direction, distance);
-	RaycastResult3D resultWorldXY = RaycastWorldXY(start, direction, distance);
-	Actor* temp = nullptr;
-	RaycastResult3D resultActors = RaycastWorldActors(start, direction, distance, temp, owner);
-
-	if (resultWorldZ.m_impactDist < resultWorldXY.m_impactDist)
-	{
-		resultTotal = resultWorldZ;
-	}
-	else
-	{
-		resultTotal = resultWorldXY;
-	}
-
-	if (resultActors.m_impactDist < resultTotal.m_impactDist)
-	{
-		resultTotal = resultActors;
-		hit = temp;
-	}
-
-	return resultTotal;
-}
-
-RaycastResult3D Map::RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const
-{
-	RaycastResult3D resultTotal;
-	resultTotal.m_didImpact = false;
-	Vec3 end = start + direction * distance;
-	resultTotal.m_impactPos = end;
-	resultTotal.m_rayMaxLength = distance;
-	resultTotal.m_impactDist = 9999999.f;	
-
-	Vec3 ray3D = direction * distance;
-	Vec3 ray2D = Vec3(ray3D.x, ray3D.y, 0.f);
-	Vec3 currentPos = start;
-	IntVec2 currentCoord = GetCoordFromPosition(start);
-
-	
-	if (IsPositionInBounds(currentPos) && GetTile(currentCoord.x, currentCoord.y)->m_tileDef.GetIsSolid())
-	{
-		resultTotal.m_didImpact = true;
-		resultTotal.m_impactNormal = -direction;
-		resultTotal.m_impactPos = start;
-		resultTotal.m_impactDist = 0.f;
-		return resultTotal;
-	}
-
-	float stepX;
-	float stepY;
-	float tMaxX;
-	float tMaxY;
-	if (end.x - start.x > 0.f)
-	{
-		stepX = 1.f;
-		tMaxX = RangeMap((float)currentCoord.x + stepX, start.x, end.x, 0.f, 1.f);
-	}
-	else if (end.x - start.x < 0.f)
-	{
-		stepX = -1.f;
-		tMaxX = RangeMap((float)currentCoord.x, start.x, end.x, 0.f, 1.f);
-	}
-	else
-	{
-		stepX = 0.f;
-		tMaxX = RangeMap((float)currentCoord.x, start.x, end.x, 0.f, 1.f);
-	}
-	if (end.y - start.y > 0.f)
-	{
-		stepY = 1.f;
-		tMaxY = RangeMap((float)currentCoord.y + stepY, start.y, end.y, 0.f, 1.f);
-	}
-	else if (end.y - start.y < 0.f)
-	{
-		stepY = -1.f;
-		tMaxY = RangeMap((float)currentCoord.y, start.y, end.y, 0.f, 1.f);
-	}
-	else
-	{
-		stepY = 0.f;
-		tMaxY = RangeMap((float)currentCoord.y, start.y, end.y, 0.f, 1.f);
-	}
-
-	float tDeltaX = (stepX != 0.f) ? RangeMap(start.x + stepX, start.x, end.x, 0.f, 1.f) : 9999999.f;
-	float tDeltaY = (stepY != 0.f) ? RangeMap(start.y + stepY, start.y, end.y, 0.f, 1.f) : 9999999.f;
-
-	while (tMaxX <= 1.f || tMaxY <= 1.f)
-	{
-		if (tMaxX < tMaxY)
-		{
-			if (stepX == 0.f)
-			{
-				break;
-			}
-			currentPos = currentPos + Vec3(stepX, 0.f, 0.f);
-			currentCoord = GetCoordFromPosition(currentPos);
-			if (IsPositionInBounds(currentPos) && GetTile(currentCoord.x, currentCoord.y)->m_tileDef.GetIsSolid())
-			{
-				resultTotal.m_didImpact = true;
-				resultTotal.m_impactNormal = Vec3(-stepX, 0.f, 0.f);
-				resultTotal.m_impactPos = (tMaxX * ray3D) + start;
-				resultTotal.m_impactDist = (tMaxX * ray3D).GetLength();
-				return resultTotal;
-			}
-			tMaxX = tMaxX + (tDeltaX);	
-		}
-		else
-		{
-			if (stepY == 0.f)
-			{
-				break;
-			}
-			currentPos = currentPos + Vec3(0.f, stepY, 0.f);
-			currentCoord = GetCoordFromPosition(currentPos);
-			if (IsPositionInBounds(currentPos) && GetTile(currentCoord.x, currentCoord.y)->m_tileDef.GetIsSolid())
-			{
-				resultTotal.m_didImpact = true;
-				resultTotal.m_impactNormal = Vec3(0.f, -stepY, 0.f);
-				resultTotal.m_impactPos = (tMaxY * ray3D) + start;
-				resultTotal.m_impactDist = (tMaxY * ray3D).GetLength();
-				return resultTotal;
-			}
-			tMaxY = tMaxY + (tDeltaY);
-		}
-	}
-
-	return resultTotal;
-}
-
-RaycastResult3D Map::RaycastWorldZ(const Vec3& start, const Vec3& direction, float distance) const
-{
-	RaycastResult3D resultTotal;
-	resultTotal.m_didImpact = false;
-	resultTotal.m_impactPos = start + direction * distance;
-	resultTotal.m_rayMaxLength = distance;
-	resultTotal.m_impactDist = 9999999.f;
-
-	if (direction.z == 0.f)
-	{
-		return resultTotal;
-	}
-	
-	Vec3 ray3D = direction * distance;
-
-	if (direction.z > 0.f) //Check Ceiling
-	{
-		float t = RangeMap(1.f, start.z, resultTotal.m_impactPos.z, 0.f, m_definition->m_ceilingHeight);
-		if (t > 1.f)
-		{
-			return resultTotal;
-		}
-		else
-		{
-			Vec3 position = start + direction * (distance * t);
-			if (!IsPositionInBounds(position))
-			{
-				return resultTotal;
-			}
-			resultTotal.m_didImpact = true;
-			resultTotal.m_impactPos = position;
-			resultTotal.m_rayMaxLength = distance;
-			resultTotal.m_impactDist = (distance * t);
-			resultTotal.m_impactNormal = Vec3(0.f, 0.f, -1.f);
-			return resultTotal;
-		}
-	}
-	else //Check Floor
-	{
-		float t = RangeMap(0.f, start.z, resultTotal.m_impactPos.z, 0.f, 1.f);
-		if (t > 1.f)
-		{
-			return resultTotal;
-		}
-		else
-		{
-			Vec3 position = start + direction * (distance * t);
-			if (!IsPositionInBounds(position))
-			{
-				return resultTotal;
-			}
-			resultTotal.m_didImpact = true;
-			resultTotal.m_impactPos = position;
-			resultTotal.m_rayMaxLength = distance;
-			resultTotal.m_impactDist = (distance * t);
-			resultTotal.m_impactNormal = Vec3(0.f, 0.f, 1.f);
-			return resultTotal;
-		}
-	}
-}
-
-RaycastResult3D Map::RaycastWorldActors(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner) const
-{
-	RaycastResult3D resultTotal;
-	resultTotal.m_didImpact = false;
-	resultTotal.m_impactPos = start + direction * distance;
-	resultTotal.m_rayMaxLength = distance;
-	resultTotal.m_impactDist = 9999999.f;
-
-	Vec3 ray3D = direction * distance;
-
-	for (int i = 0; i < m_actors.size(); i++)
-	{
-		if (m_actors[i] != nullptr && (m_actors[i] != owner || owner == nullptr))
-		{
-			RaycastResult3D result = RaycastVsCylinderZ3D(start, direction, distance,
-				m_actors[i]->m_position + Vec3(0.f, 0.f, m_actors[i]->m_height * .5f), 
-				FloatRange(m_actors[i]->m_position.z, m_actors[i]->m_position.z + m_actors[i]->m_height), 
-				m_actors[i]->m_radius);
-
-			if (result.m_didImpact && result.m_impactDist < resultTotal.m_impactDist)
-			{
-				resultTotal = result;
-				hit = m_actors[i];
-			}
-		}
-	}
-	return resultTotal;
-}
+#include "Map.hpp"
+#include "Game/Game.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/DebugRenderSystem.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "AI.hpp"
+#include "Game/ProjectileSystem.hpp"
+#include "Game/EffectSystem.hpp"
+#include "Game/DecalSystem.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/ViewCuller.hpp"
+#include "Game/LightBudget.hpp"
+#include "Game/MapChunk.hpp"
+#include "Game/MapChunkFile.hpp"
+#include "Game/DistanceField.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderThread.hpp"
+#include "Game/WorkerPool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <cfloat>
+#include <functional>
+#include <iterator>
+
+extern Renderer* g_theRenderer;
+extern RandomNumberGenerator* g_rng;
+extern NamedStrings* g_gameConfigBlackboard;
+extern DevConsole* g_theDevConsole;
+
+constexpr float CULL_FAR_DISTANCE = 100.f;
+constexpr int ACTOR_VERTS_BATCH_SIZE = 16;
+constexpr int SPHERE_TRACE_MAX_STEPS = 8;
+constexpr float SPHERE_TRACE_MIN_STEP = .05f;
+
+static float GetDistanceToChunk(Vec2 const& point, MapChunk const& chunk)
+{
+	float dx = fmaxf(fmaxf((float)chunk.m_mins.x - point.x, point.x - (float)chunk.m_maxs.x), 0.f);
+	float dy = fmaxf(fmaxf((float)chunk.m_mins.y - point.y, point.y - (float)chunk.m_maxs.y), 0.f);
+	return sqrtf((dx * dx) + (dy * dy));
+}
+
+Map::Map()
+{
+	m_definition = nullptr;
+}
+
+Map::Map(Game* game, const MapDefinition* definition, bool isPreloading)
+{
+	//Buffer creation uploads directly, which must not overlap a frame still drawing on the render thread.
+	//A preloading map runs this on a loader thread and leaves every GPU call to FinishLoading.
+	m_isPreloading = isPreloading;
+	if (g_theRenderThread != nullptr && !m_isPreloading)
+	{
+		g_theRenderThread->Flush();
+	}
+
+	m_game = game;
+	m_definition = definition;
+	m_texture = definition->GetTexture();
+	m_shader = definition->GetShader();
+	m_isLightingBaked = g_gameConfigBlackboard->GetValue("bakeMapLighting", true);
+	m_isStreamed = definition->m_isStreamed;
+	m_streamingViewDistance = g_gameConfigBlackboard->GetValue("mapStreamingViewDistance", 48.f);
+	m_streamingBudgetBytes = (size_t)g_gameConfigBlackboard->GetValue("mapStreamingBudgetKB", 16384) * 1024;
+	m_maxChunkLoads = g_gameConfigBlackboard->GetValue("mapStreamingMaxLoads", 4);
+	m_chunkBuilder = new MapChunkBuilder();
+	CreateTiles();
+	CreateDistanceField();
+	CreateChunks();
+	m_projectiles = new ProjectileSystem(this);
+	m_effects = new EffectSystem(this);
+	m_decals = new DecalSystem(this);
+	m_viewCuller = new ViewCuller(this);
+	m_lightBudget = new LightBudget();
+
+	if (!m_isPreloading)
+	{
+		FinishLoading();
+	}
+}
+
+void Map::FinishLoading()
+{
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->Flush();
+	}
+	m_compactShader = g_theRenderer->CreateOrGetShader("Data/Shaders/MapCompact", VertexType::PCU);
+	for (int i = 0; i < (int)m_pendingUploads.size(); i++)
+	{
+		UploadChunk(m_pendingUploads[i]);
+	}
+	m_pendingUploads.clear();
+	CreateBuffers();
+
+	//Textures come from the renderer's cache by path, which only the main thread may touch; maps normally share a skybox already loaded
+	Texture* skyBoxTexture = g_theRenderer->CreateOrGetTextureFromFile(m_definition->m_skyBoxFilePath.c_str());
+	m_skyBoxSheet = new SpriteSheet(*skyBoxTexture, IntVec2(4, 3));
+	CreateSkybox();
+
+	m_isPreloading = false;
+	for (int i = 0; i < (int)m_pendingMessages.size(); i++)
+	{
+		g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, m_pendingMessages[i]);
+	}
+	m_pendingMessages.clear();
+}
+
+void Map::LogMapMessage(std::string const& message)
+{
+	//The dev console belongs to the main thread; a preloading map holds its messages until it is handed over
+	if (m_isPreloading)
+	{
+		m_pendingMessages.push_back(message);
+		return;
+	}
+	g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, message);
+}
+
+Map::~Map()
+{
+	//Published snapshots still point at this map's buffers
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->Flush();
+	}
+
+	//Joins the build thread first, since queued builds reference the map's sprite sheet
+	delete m_chunkBuilder;
+	delete m_definition;
+
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		delete m_actors[i];
+	}
+	m_actors.clear();
+	delete m_projectiles;
+	delete m_effects;
+	delete m_decals;
+	delete m_viewCuller;
+	delete m_lightBudget;
+	delete m_distanceField;
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		delete m_chunks[i].m_vertexBuffer;
+		delete m_chunks[i].m_indexBuffer;
+	}
+	m_chunks.clear();
+	delete m_lightBuffer;
+	delete m_bakedLightBuffer;
+	delete m_vertexFrameBuffer;
+	delete m_skyBoxSheet;
+	m_game = nullptr;
+}
+
+void Map::CreateTiles()
+{
+	m_chunkSize = g_gameConfigBlackboard->GetValue("mapChunkSize", 16);
+	m_chunkSize = (m_chunkSize > 1) ? m_chunkSize : 1;
+
+	//A streamed map already split from this image starts from its manifest alone; no tiles load until a player is near
+	std::string imageFilePath = m_definition->GetImageFilePath();
+	if (m_isStreamed && ReadCurrentChunkManifest(imageFilePath))
+	{
+		m_dimensions = m_manifest.m_dimensions;
+		CreateChunkLayout();
+		CreateTileDefRemap();
+		m_solidity.Initialize(m_dimensions, 1);
+		return;
+	}
+
+	Image* mapImage = g_theRenderer->CreateImageFromFile(imageFilePath.c_str());
+	m_dimensions = mapImage->GetDimensions();
+	std::vector<Rgba8> texels = mapImage->GetDataAsRgba8Vector();
+
+	//A texel that matches no tile definition stays an open tile with nothing to draw
+	Grid<unsigned char> tileDefIndexes(m_dimensions, NO_TILE_DEFINITION);
+	for (int rows = 0; rows < m_dimensions.y; rows++)
+	{
+		for (int cols = 0; cols < m_dimensions.x; cols++)
+		{
+			int index = (rows * m_dimensions.x) + cols;
+			for (int defIndex = 0; defIndex < (int)m_game->m_tileDefs.size() && defIndex < NO_TILE_DEFINITION; defIndex++)
+			{
+				Rgba8 texelColor = texels[index];
+				if (m_game->m_tileDefs[defIndex]->GetMapPixelColor() == texelColor)
+				{
+					tileDefIndexes.Set(cols, rows, (unsigned char)defIndex);
+					break;
+				}
+			}
+		}
+	}
+	delete mapImage;
+	CreateChunkLayout();
+
+	if (m_isStreamed)
+	{
+		if (WriteChunkFiles(tileDefIndexes))
+		{
+			CreateTileDefRemap();
+			m_solidity.Initialize(m_dimensions, 1);
+			return;
+		}
+		LogMapMessage(Stringf("Could not write chunk files for %s; loading it whole", m_definition->GetName().c_str()));
+		m_isStreamed = false;
+	}
+
+	m_solidity.Initialize(m_dimensions, 0);
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		MapChunk& chunk = m_chunks[i];
+		chunk.m_tileDefIndexes.Initialize(IntVec2(chunk.m_maxs.x - chunk.m_mins.x, chunk.m_maxs.y - chunk.m_mins.y), NO_TILE_DEFINITION);
+		tileDefIndexes.ForEachInRange(chunk.m_mins, chunk.m_maxs, [this, &chunk](int x, int y, unsigned char tileDefIndex)
+		{
+			chunk.m_tileDefIndexes.Set(x - chunk.m_mins.x, y - chunk.m_mins.y, tileDefIndex);
+			m_solidity.Set(x, y, (tileDefIndex != NO_TILE_DEFINITION && m_game->m_tileDefs[tileDefIndex]->GetIsSolid()) ? 1 : 0);
+		});
+		chunk.m_isResident = true;
+	}
+}
+
+void Map::CreateChunkLayout()
+{
+	m_numChunks = IntVec2((m_dimensions.x + m_chunkSize - 1) / m_chunkSize, (m_dimensions.y + m_chunkSize - 1) / m_chunkSize);
+	m_chunks.resize(m_numChunks.x * m_numChunks.y);
+	for (int chunkY = 0; chunkY < m_numChunks.y; chunkY++)
+	{
+		for (int chunkX = 0; chunkX < m_numChunks.x; chunkX++)
+		{
+			MapChunk& chunk = m_chunks[(chunkY * m_numChunks.x) + chunkX];
+			chunk.m_mins = IntVec2(chunkX * m_chunkSize, chunkY * m_chunkSize);
+			chunk.m_maxs = IntVec2(chunk.m_mins.x + m_chunkSize, chunk.m_mins.y + m_chunkSize);
+			chunk.m_maxs.x = (chunk.m_maxs.x < m_dimensions.x) ? chunk.m_maxs.x : m_dimensions.x;
+			chunk.m_maxs.y = (chunk.m_maxs.y < m_dimensions.y) ? chunk.m_maxs.y : m_dimensions.y;
+		}
+	}
+}
+
+bool Map::ReadCurrentChunkManifest(std::string const& imageFilePath)
+{
+	std::string manifestPath = GetMapChunkManifestPath(m_definition->GetName());
+	if (!ReadMapChunkManifest(manifestPath, m_manifest) || m_manifest.m_chunkSize != m_chunkSize)
+	{
+		return false;
+	}
+
+	//Maps can ship as chunk files alone; with the image present, an edit to it means splitting again
+	std::error_code error;
+	if (!std::filesystem::exists(imageFilePath, error))
+	{
+		return true;
+	}
+	return std::filesystem::last_write_time(manifestPath, error) >= std::filesystem::last_write_time(imageFilePath, error) && !error;
+}
+
+bool Map::WriteChunkFiles(Grid<unsigned char> const& tileDefIndexes)
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	m_manifest.m_dimensions = m_dimensions;
+	m_manifest.m_chunkSize = m_chunkSize;
+	m_manifest.m_tileDefNames.clear();
+	for (int defIndex = 0; defIndex < (int)m_game->m_tileDefs.size() && defIndex < NO_TILE_DEFINITION; defIndex++)
+	{
+		m_manifest.m_tileDefNames.push_back(m_game->m_tileDefs[defIndex]->GetName());
+	}
+
+	if (!WriteMapChunkFiles(m_definition->GetName(), m_manifest, tileDefIndexes))
+	{
+		return false;
+	}
+	LogMapMessage(Stringf("Split %s into %i chunk files in %.1f ms",
+		m_definition->GetName().c_str(), (int)m_chunks.size(), (GetCurrentTimeSeconds() - startSeconds) * 1000.0));
+	return true;
+}
+
+void Map::CreateTileDefRemap()
+{
+	m_tileDefRemap.assign(m_manifest.m_tileDefNames.size(), NO_TILE_DEFINITION);
+	for (int i = 0; i < (int)m_manifest.m_tileDefNames.size(); i++)
+	{
+		for (int defIndex = 0; defIndex < (int)m_game->m_tileDefs.size() && defIndex < NO_TILE_DEFINITION; defIndex++)
+		{
+			if (m_game->m_tileDefs[defIndex]->GetName() == m_manifest.m_tileDefNames[i])
+			{
+				m_tileDefRemap[i] = (unsigned char)defIndex;
+				break;
+			}
+		}
+	}
+}
+
+void Map::CreateDistanceField()
+{
+	//The field is built over the whole map at once, which a streamed map never has loaded; collision and sweeps fall back to tile tests
+	if (m_isStreamed)
+	{
+		return;
+	}
+	m_distanceField = new DistanceField(g_gameConfigBlackboard->GetValue("distanceFieldSamplesPerTile", 4), g_gameConfigBlackboard->GetValue("distanceFieldMaxDistance", 4.f));
+	m_distanceField->Build(m_solidity);
+
+	DistanceFieldStats const& stats = m_distanceField->GetStats();
+	LogMapMessage(Stringf("Built wall distance field: %ix%i samples, %.1f KB in %.2f ms",
+		stats.m_numSamples.x, stats.m_numSamples.y, (float)stats.m_numBytes / 1024.f, stats.m_seconds * 1000.0));
+}
+
+void Map::CreateChunks()
+{
+	if (m_isStreamed)
+	{
+		LogMapMessage(Stringf("Streaming %s: %ix%i tiles in %i chunks, view distance %.0f, budget %.1f MB",
+			m_definition->GetName().c_str(), m_dimensions.x, m_dimensions.y, (int)m_chunks.size(), m_streamingViewDistance, (float)m_streamingBudgetBytes / (1024.f * 1024.f)));
+		return;
+	}
+
+	std::vector<int> chunkIndexes(m_chunks.size());
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		chunkIndexes[i] = i;
+	}
+	BuildChunksNow(chunkIndexes);
+}
+
+void Map::BuildChunksNow(std::vector<int> const& chunkIndexes)
+{
+	double startSeconds = GetCurrentTimeSeconds();
+
+	//Streamed chunks read their tiles first, all of them before any bake, so no chunk in the batch sees another as an unloaded wall
+	std::vector<int> loadIndexes;
+	for (int i = 0; i < (int)chunkIndexes.size(); i++)
+	{
+		if (!m_chunks[chunkIndexes[i]].m_isResident)
+		{
+			loadIndexes.push_back(chunkIndexes[i]);
+		}
+	}
+	//The worker pool is the main thread's, so a map preloading on the loader thread runs every job there in turn
+	auto runJobs = [this](int numJobs, std::function<void(int, int, int)> const& job)
+	{
+		if (m_isPreloading)
+		{
+			job(0, numJobs, 0);
+			return;
+		}
+		g_theWorkerPool->ParallelFor(numJobs, 1, job);
+	};
+
+	std::vector<Grid<unsigned char>> loadedTiles(loadIndexes.size());
+	runJobs((int)loadIndexes.size(), [this, &loadIndexes, &loadedTiles](int begin, int end, int workerIndex)
+	{
+		UNUSED(workerIndex);
+		for (int i = begin; i < end; i++)
+		{
+			MapChunk const& chunk = m_chunks[loadIndexes[i]];
+			std::string path = GetMapChunkFilePath(m_definition->GetName(), IntVec2(loadIndexes[i] % m_numChunks.x, loadIndexes[i] / m_numChunks.x));
+			MapChunkBuilder::ReadChunkTiles(path, m_tileDefRemap, IntVec2(chunk.m_maxs.x - chunk.m_mins.x, chunk.m_maxs.y - chunk.m_mins.y), loadedTiles[i]);
+		}
+	});
+	for (int i = 0; i < (int)loadIndexes.size(); i++)
+	{
+		InstallChunkTiles(loadIndexes[i], loadedTiles[i]);
+		m_chunks[loadIndexes[i]].m_isBuilding = true;
+	}
+
+	//Resident neighbours baked against these as walls; the batch itself is held as building so it only builds below
+	int bakeMargin = GetBakeMargin();
+	for (int i = 0; i < (int)loadIndexes.size(); i++)
+	{
+		MapChunk const& chunk = m_chunks[loadIndexes[i]];
+		DirtyChunksInArea(IntVec2(chunk.m_mins.x - bakeMargin, chunk.m_mins.y - bakeMargin), IntVec2(chunk.m_maxs.x + bakeMargin, chunk.m_maxs.y + bakeMargin));
+	}
+
+	//One chunk per worker batch, each baking serially inside its own chunk
+	std::vector<MapChunkBuildResult> results(chunkIndexes.size());
+	runJobs((int)chunkIndexes.size(), [this, &chunkIndexes, &results](int begin, int end, int workerIndex)
+	{
+		UNUSED(workerIndex);
+		for (int i = begin; i < end; i++)
+		{
+			MapChunkBuildInput* input = CreateChunkBuildInput(chunkIndexes[i]);
+			MapChunkBuilder::BuildChunk(*input, results[i], nullptr);
+			delete input;
+		}
+	});
+
+	int numVerts = 0;
+	int numRays = 0;
+	size_t numBytes = 0;
+	size_t numUncompressedBytes = 0;
+	for (int i = 0; i < (int)results.size(); i++)
+	{
+		numRays += results[i].m_bakeStats.m_numRays;
+		if (results[i].m_isCompact)
+		{
+			numVerts += results[i].m_compactMesh.GetNumVerts();
+			numBytes += results[i].m_compactMesh.GetNumGPUBytes();
+			numUncompressedBytes += results[i].m_compactMesh.GetNumUncompressedBytes();
+		}
+		else
+		{
+			numVerts += (int)results[i].m_verts.size();
+			numBytes += results[i].m_verts.size() * sizeof(Vertex_PCUTBN);
+			numUncompressedBytes += results[i].m_verts.size() * sizeof(Vertex_PCUTBN);
+		}
+	}
+	for (int i = 0; i < (int)loadIndexes.size(); i++)
+	{
+		m_chunks[loadIndexes[i]].m_isBuilding = false;
+	}
+	if (m_isPreloading)
+	{
+		m_pendingUploads.insert(m_pendingUploads.end(), std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+	}
+	else
+	{
+		for (int i = 0; i < (int)results.size(); i++)
+		{
+			UploadChunk(results[i]);
+		}
+	}
+	LogMapMessage(Stringf("Built %i map chunks of %i tiles (%i loaded): %i verts, %.1f KB of vertex buffers (%.1f KB as full vertices), %i bake rays in %.1f ms on %i workers",
+		(int)chunkIndexes.size(), m_chunkSize, (int)loadIndexes.size(), numVerts, (float)numBytes / 1024.f, (float)numUncompressedBytes / 1024.f, numRays,
+		(GetCurrentTimeSeconds() - startSeconds) * 1000.0, m_isPreloading ? 1 : g_theWorkerPool->GetNumWorkers()));
+}
+
+void Map::InstallChunkTiles(int chunkIndex, Grid<unsigned char>& tileDefIndexes)
+{
+	MapChunk& chunk = m_chunks[chunkIndex];
+	chunk.m_tileDefIndexes = std::move(tileDefIndexes);
+	chunk.m_isResident = true;
+	for (int y = chunk.m_mins.y; y < chunk.m_maxs.y; y++)
+	{
+		for (int x = chunk.m_mins.x; x < chunk.m_maxs.x; x++)
+		{
+			unsigned char tileDefIndex = chunk.m_tileDefIndexes.Get(x - chunk.m_mins.x, y - chunk.m_mins.y);
+			m_solidity.Set(x, y, (tileDefIndex != NO_TILE_DEFINITION && m_game->m_tileDefs[tileDefIndex]->GetIsSolid()) ? 1 : 0);
+		}
+	}
+	chunk.m_numBytes = chunk.m_tileDefIndexes.GetCells().size();
+	m_residentBytes += chunk.m_numBytes;
+}
+
+void Map::CreateBuffers()
+{
+	m_lightBuffer = g_theRenderBackend->CreateConstantBuffer(sizeof(LightConstants));
+	m_lightConstants = LightConstants();
+	UpdateLightBuffer();
+	g_theRenderBackend->CopyCPUToGPU(&m_lightConstants, sizeof(LightConstants), m_lightBuffer);
+	m_uploadedLightConstants = m_lightConstants;
+
+	if (m_isLightingBaked)
+	{
+		m_bakedLightBuffer = g_theRenderBackend->CreateConstantBuffer(sizeof(LightConstants));
+		LightConstants bakedConstants = GetBakedLightConstants(m_lightConstants);
+		g_theRenderBackend->CopyCPUToGPU(&bakedConstants, sizeof(LightConstants), m_bakedLightBuffer);
+	}
+}
+
+LightConstants Map::GetBakedLightConstants(LightConstants const& constants)
+{
+	//The shader only adds point lights on top of the baked colours
+	LightConstants bakedConstants = constants;
+	bakedConstants.c_sunIntensity = 0.f;
+	bakedConstants.c_ambientIntensity = 1.f;
+	return bakedConstants;
+}
+
+MapChunkBuildInput* Map::CreateChunkBuildInput(int chunkIndex) const
+{
+	MapChunk const& chunk = m_chunks[chunkIndex];
+	MapChunkBuildInput* input = new MapChunkBuildInput();
+	input->m_chunkIndex = chunkIndex;
+	input->m_version = chunk.m_version;
+	input->m_mins = chunk.m_mins;
+	input->m_maxs = chunk.m_maxs;
+	input->m_tileDefs = &m_game->m_tileDefs;
+	if (chunk.m_isResident)
+	{
+		input->m_tileDefIndexes = chunk.m_tileDefIndexes;
+	}
+	else
+	{
+		input->m_chunkFilePath = GetMapChunkFilePath(m_definition->GetName(), IntVec2(chunkIndex % m_numChunks.x, chunkIndex / m_numChunks.x));
+		input->m_tileDefRemap = m_tileDefRemap;
+	}
+
+	//Only the solidity the bake can reach from this chunk, so a job costs the same on any size of map
+	int bakeMargin = GetBakeMargin();
+	IntVec2 solidityMins = IntVec2(chunk.m_mins.x - bakeMargin, chunk.m_mins.y - bakeMargin);
+	IntVec2 solidityMaxs = IntVec2(chunk.m_maxs.x + bakeMargin, chunk.m_maxs.y + bakeMargin);
+	solidityMins.x = (solidityMins.x > 0) ? solidityMins.x : 0;
+	solidityMins.y = (solidityMins.y > 0) ? solidityMins.y : 0;
+	solidityMaxs.x = (solidityMaxs.x < m_dimensions.x) ? solidityMaxs.x : m_dimensions.x;
+	solidityMaxs.y = (solidityMaxs.y < m_dimensions.y) ? solidityMaxs.y : m_dimensions.y;
+	input->m_solidityOrigin = solidityMins;
+	input->m_solidity.Initialize(IntVec2(solidityMaxs.x - solidityMins.x, solidityMaxs.y - solidityMins.y), 0);
+	m_solidity.ForEachInRange(solidityMins, solidityMaxs, [input, &solidityMins](int x, int y, unsigned char solid)
+	{
+		input->m_solidity.Set(x - solidityMins.x, y - solidityMins.y, solid);
+	});
+	input->m_sheet = m_game->m_spriteSheet;
+	input->m_ceilingHeight = m_definition->m_ceilingHeight;
+
+	input->m_bakeLighting = m_isLightingBaked;
+	input->m_sunDirection = m_game->m_lightDirection;
+	input->m_sunIntensity = m_game->m_lightIntensity;
+	input->m_ambientIntensity = m_game->m_ambientIntensity;
+	input->m_staticLights = m_definition->m_staticLights;
+	input->m_optimizeMesh = g_gameConfigBlackboard->GetValue("optimizeMapMesh", true);
+	input->m_vertexCacheSize = g_gameConfigBlackboard->GetValue("vertexCacheSize", 16);
+	input->m_compactVertices = g_gameConfigBlackboard->GetValue("compactMapVertices", true);
+	return input;
+}
+
+void Map::UploadChunk(MapChunkBuildResult const& result)
+{
+	MapChunk& chunk = m_chunks[result.m_chunkIndex];
+	delete chunk.m_vertexBuffer;
+	delete chunk.m_indexBuffer;
+	chunk.m_vertexBuffer = nullptr;
+	chunk.m_indexBuffer = nullptr;
+	chunk.m_numIndexes = (int)result.m_indexes.size();
+	chunk.m_builtVersion = result.m_version;
+	chunk.m_isCompact = false;
+
+	//What the streaming budget counts: the chunk's tiles plus its mesh as uploaded
+	m_residentBytes -= chunk.m_numBytes;
+	chunk.m_numBytes = chunk.m_tileDefIndexes.GetCells().size() + (result.m_indexes.size() * sizeof(unsigned int));
+	if (result.m_indexes.empty())
+	{
+		m_residentBytes += chunk.m_numBytes;
+		return;
+	}
+
+	std::vector<unsigned char> frameRemap;
+	if (result.m_isCompact && AddVertexFrames(result.m_compactMesh, frameRemap))
+	{
+		std::vector<Vertex_PCU> verts;
+		result.m_compactMesh.GetGPUVerts(frameRemap, verts);
+		unsigned int numVerts = (unsigned int)verts.size();
+		chunk.m_vertexBuffer = g_theRenderBackend->CreateVertexBuffer(numVerts * sizeof(Vertex_PCU), sizeof(Vertex_PCU));
+		g_theRenderBackend->CopyCPUToGPU(verts.data(), numVerts, chunk.m_vertexBuffer);
+		chunk.m_numBytes += numVerts * sizeof(Vertex_PCU);
+		chunk.m_isCompact = true;
+	}
+	else if (result.m_isCompact)
+	{
+		std::vector<Vertex_PCUTBN> verts;
+		result.m_compactMesh.Decode(verts);
+		unsigned int numVerts = (unsigned int)verts.size();
+		chunk.m_vertexBuffer = g_theRenderBackend->CreateVertexBuffer(numVerts * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+		g_theRenderBackend->CopyCPUToGPU(verts.data(), numVerts, chunk.m_vertexBuffer);
+		chunk.m_numBytes += numVerts * sizeof(Vertex_PCUTBN);
+	}
+	else
+	{
+		unsigned int numVerts = (unsigned int)result.m_verts.size();
+		chunk.m_vertexBuffer = g_theRenderBackend->CreateVertexBuffer(numVerts * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+		g_theRenderBackend->CopyCPUToGPU(result.m_verts.data(), numVerts, chunk.m_vertexBuffer);
+		chunk.m_numBytes += numVerts * sizeof(Vertex_PCUTBN);
+	}
+	m_residentBytes += chunk.m_numBytes;
+	chunk.m_indexBuffer = g_theRenderBackend->CreateIndexBuffer((unsigned int)result.m_indexes.size());
+	g_theRenderBackend->CopyCPUToGPU(result.m_indexes.data(), (unsigned int)result.m_indexes.size(), chunk.m_indexBuffer);
+}
+
+bool Map::AddVertexFrames(CompactMapMesh const& mesh, std::vector<unsigned char>& out_frameRemap)
+{
+	std::vector<MapVertexFrame> const& frames = mesh.GetFrames();
+	int numOldFrames = (int)m_vertexFrames.size();
+	out_frameRemap.resize(frames.size());
+	for (int i = 0; i < (int)frames.size(); i++)
+	{
+		MapVertexFrame const& frame = frames[i];
+		int mapIndex = -1;
+		for (int j = 0; j < (int)m_vertexFrames.size() && mapIndex < 0; j++)
+		{
+			MapVertexFrame const& mapFrame = m_vertexFrames[j];
+			if (mapFrame.m_normal == frame.m_normal && mapFrame.m_tangent == frame.m_tangent && mapFrame.m_bitangent == frame.m_bitangent)
+			{
+				mapIndex = j;
+			}
+		}
+		if (mapIndex < 0)
+		{
+			if ((int)m_vertexFrames.size() >= MAX_MAP_VERTEX_FRAMES)
+			{
+				m_vertexFrames.resize(numOldFrames);
+				return false;
+			}
+			mapIndex = (int)m_vertexFrames.size();
+			m_vertexFrames.push_back(frame);
+		}
+		out_frameRemap[i] = (unsigned char)mapIndex;
+	}
+	if ((int)m_vertexFrames.size() == numOldFrames && m_vertexFrameBuffer != nullptr)
+	{
+		return true;
+	}
+
+	//Only grows on the main thread as chunks land, so every chunk already drawn keeps its indexes
+	auto setRow = [](float* row, Vec3 const& vector)
+	{
+		row[0] = vector.x;
+		row[1] = vector.y;
+		row[2] = vector.z;
+	};
+	MapVertexFrameConstants constants;
+	for (int i = 0; i < (int)m_vertexFrames.size(); i++)
+	{
+		setRow(constants.c_tangents[i], m_vertexFrames[i].m_tangent);
+		setRow(constants.c_bitangents[i], m_vertexFrames[i].m_bitangent);
+		setRow(constants.c_normals[i], m_vertexFrames[i].m_normal);
+	}
+	if (m_vertexFrameBuffer == nullptr)
+	{
+		m_vertexFrameBuffer = g_theRenderBackend->CreateConstantBuffer(sizeof(MapVertexFrameConstants));
+	}
+	g_theRenderBackend->CopyCPUToGPU(&constants, sizeof(MapVertexFrameConstants), m_vertexFrameBuffer);
+	return true;
+}
+
+void Map::CreateSkybox()
+{
+	m_skyBoxLocalBounds.m_mins = m_skyBoxLocalBounds.m_mins + Vec3(m_dimensions.x * .5f, m_dimensions.y * .5f, 0.f);
+	m_skyBoxLocalBounds.m_maxs = m_skyBoxLocalBounds.m_maxs + Vec3(m_dimensions.x * .5f, m_dimensions.y * .5f, 0.f);
+	AddVertsForSkyBoxAABB3D(m_skyBoxVerts, m_skyBoxLocalBounds, *m_skyBoxSheet);
+}
+
+Actor* Map::SpawnPlayer(Player* possessingPlayer, Vec3 const& location)
+{
+	//Load Marine Actor
+	SpawnInfo sp;
+	sp.m_actor = "Marine";
+	sp.m_orientation = EulerAngles();
+	
+	sp.m_position = location;
+	sp.m_velocity = Vec3();
+
+	//Everything in view has to be there on the first frame, or the player spawns boxed in by unloaded walls
+	LoadChunksNear(location);
+
+	//Spawn Marine
+	Actor* player = SpawnActor(sp);
+
+	//Set controller variables
+	possessingPlayer->m_playerCamPosition = sp.m_position;
+	possessingPlayer->m_playerCamOrientation = sp.m_orientation;
+	possessingPlayer->m_possessedActor = player->m_handle;
+	possessingPlayer->m_map = this;
+
+	//Set actor variables
+	player->m_controller = possessingPlayer;
+	player->m_isAI = false;
+	player->m_AIController = new AI();
+	player->m_AIController->m_possessedActor = player->m_handle;
+	player->m_AIController->m_map = player->m_spawnMap;
+	
+	return player;
+}
+
+void Map::KillPlayer(Player* possessingPlayer)
+{
+	m_actors[possessingPlayer->m_possessedActor.GetIndex()]->m_controller = nullptr;
+	delete m_actors[possessingPlayer->m_possessedActor.GetIndex()];
+	m_actors[possessingPlayer->m_possessedActor.GetIndex()] = nullptr;
+	possessingPlayer->m_possessedActor = ActorHandle::INVALID;
+}
+
+Actor* Map::SpawnActor(const SpawnInfo& spawnInfo)
+{
+	//Manage and check Handle
+	unsigned int index = (int)m_actors.size();
+	unsigned int uid = m_nextActorUID;
+	m_nextActorUID++;
+	if (uid >= ActorHandle::MAX_ACTOR_UID)
+	{
+		ERROR_AND_DIE("UIDs have run out of space. Error in SpawnActor");
+	}
+
+	//Find next available index. Error if out of range
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		if (m_actors[i] == nullptr)
+		{
+			index = i;
+			break;
+		}
+	}
+	if (index >= ActorHandle::MAX_ACTOR_INDEX)
+	{
+		ERROR_AND_DIE("Actor vector has run out of space. Error in SpawnActor");
+	}
+	ActorHandle newHandle = ActorHandle(uid, index);
+	ActorDefinition useThis;
+	useThis.m_name = "undefined";
+	for (int i = 0; i < (int)m_game->m_actorDefs.size(); i++)
+	{
+		if (spawnInfo.m_actor == m_game->m_actorDefs[i]->m_name)
+		{
+			useThis = *m_game->m_actorDefs[i];
+		}
+	}
+	if (useThis.m_name == "undefined")
+	{
+		ERROR_AND_DIE("Error: Could not spawn actor due to invalid actor definition (SpawnActor)");
+	}
+
+	//Create the new Actor
+	Actor* newActor = new Actor(this, newHandle, useThis, spawnInfo.m_position, spawnInfo.m_orientation, spawnInfo.m_velocity);
+	if (index == (int)m_actors.size())
+	{
+		m_actors.push_back(newActor);
+	}
+	else
+	{
+		m_actors[index] = newActor;
+	}
+
+	newActor->m_owningActor = ActorHandle::INVALID;
+	return newActor;
+}
+
+bool Map::SpawnProjectile(const ProjectileSpawnInfo& spawnInfo)
+{
+	return m_projectiles->SpawnProjectile(spawnInfo);
+}
+
+void Map::SpawnEffect(const ActorDefinition* definition, Vec3 const& position)
+{
+	m_effects->SpawnEffect(definition, position);
+}
+
+void Map::AddDecal(const ActorDefinition* definition, Vec3 const& position, Vec3 const& normal)
+{
+	m_decals->AddDecal(definition, position, normal);
+}
+
+const ActorDefinition* Map::FindActorDefinition(std::string const& name) const
+{
+	for (int i = 0; i < (int)m_game->m_actorDefs.size(); i++)
+	{
+		if (name == m_game->m_actorDefs[i]->m_name)
+		{
+			return m_game->m_actorDefs[i];
+		}
+	}
+	return nullptr;
+}
+
+void Map::KillAIActor(const ActorHandle handle)
+{
+	delete m_actors[handle.GetIndex()]->m_controller;
+	m_actors[handle.GetIndex()]->m_controller = nullptr;
+	delete m_actors[handle.GetIndex()];
+	m_actors[handle.GetIndex()] = nullptr;
+}
+
+Actor* Map::GetActorByHandle(const ActorHandle handle) const
+{
+	unsigned int index = handle.GetIndex();
+	if (index >= (unsigned int)m_actors.size())
+	{
+		return nullptr;
+	}
+
+	if (m_actors[index] != nullptr)
+	{
+		if (handle == m_actors[index]->m_handle)
+		{
+			return m_actors[index];
+		}
+	}
+	return nullptr;
+}
+
+void Map::DeleteDestroyedActors()
+{
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr)
+		{
+			if (m_actors[i]->m_expired)
+			{
+				delete m_actors[i];
+				m_actors[i] = nullptr;
+			}
+		}
+	}
+}
+
+Actor* Map::GetClosestVisibleEnemy(Actor* searchingActor) const
+{
+	float shortestDistanceHit = 9999.f;
+	Actor* output = nullptr;
+
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		//Filter nulls
+		if (m_actors[i] != nullptr)
+		{
+			//Filter same factions and invisibles
+			//
+			if (m_actors[i]->m_definition.m_visible && searchingActor->m_definition.m_AIElement.m_aiEnabled && !m_actors[i]->m_definition.m_isPickup &&
+				searchingActor->m_definition.m_faction != m_actors[i]->m_definition.m_faction &&
+				m_actors[i]->m_definition.m_faction != Faction::NEUTRAL)
+			{
+				//If the point is well outside of vision cone skip
+				Vec3 sightLine = m_actors[i]->m_position - searchingActor->GetVisionStartPoint();
+				if (IsPointInsideVisionCone(searchingActor->GetVisionStartPoint(), searchingActor->m_orientation, searchingActor->m_definition.m_AIElement.m_sightAngle, m_actors[i]->m_position))
+				{
+					Actor* detection = nullptr;
+					//std::vector<Actor*> potentialTargets = m_game->m_map->GetActorsInSector(searchingActor, searchingActor->m_definition.m_AIElement.m_sightAngle, searchingActor->m_definition.m_AIElement.m_sightRadius);
+					RaycastResult3D result = RaycastAll(searchingActor->GetVisionStartPoint(), sightLine.GetNormalized(),
+						searchingActor->m_definition.m_AIElement.m_sightRadius, detection, searchingActor);
+					//If the actor output is not null (the raycast hit the actor)
+					if (detection && result.m_impactDist <= shortestDistanceHit)
+					{
+						shortestDistanceHit = result.m_impactDist;
+						output = detection;
+					}
+				}
+			}
+		}
+	}
+
+	return output;
+}
+
+void Map::DebugPossessNext()
+{
+	for (int i = 1; i <= (int)m_actors.size(); i++)
+	{
+		int index = (m_game->m_player->m_possessedActor.GetIndex() + i) % ((int)m_actors.size());
+
+		//Filter nulls
+		if (m_actors[index] != nullptr && m_actors[index]->m_definition.m_canBePossessed && m_actors[index]->m_isAI)
+		{
+			m_game->m_player->Possess(m_actors[index]->m_handle);
+			break;
+		}
+	}
+}
+
+bool Map::IsPositionInBounds(const Vec3& position) const
+{
+	FloatRange xRange = FloatRange(0.f, (float)m_dimensions.x + 1.f);
+	FloatRange yRange = FloatRange(0.f, (float)m_dimensions.y + 1.f);
+	return xRange.IsOnRange(position.x) && yRange.IsOnRange(position.y);
+}
+
+IntVec2 Map::GetCoordFromPosition(const Vec3& position) const
+{
+	return IntVec2((int)position.x, (int)position.y);
+}
+
+bool Map::AreCoordsInBounds(int x, int y) const
+{
+	return m_solidity.IsInBounds(x, y);
+}
+
+int Map::GetChunkIndex(int x, int y) const
+{
+	return ((y / m_chunkSize) * m_numChunks.x) + (x / m_chunkSize);
+}
+
+bool Map::IsPositionResident(Vec3 const& position) const
+{
+	IntVec2 coords = GetCoordFromPosition(position);
+	if (!m_isStreamed || !m_solidity.IsInBounds(coords.x, coords.y))
+	{
+		return true;
+	}
+	return m_chunks[GetChunkIndex(coords.x, coords.y)].m_isResident;
+}
+
+const TileDefinition* Map::GetTileDefinition(int x, int y) const
+{
+	if (!m_solidity.IsInBounds(x, y))
+	{
+		return nullptr;
+	}
+	MapChunk const& chunk = m_chunks[GetChunkIndex(x, y)];
+	if (!chunk.m_isResident)
+	{
+		return nullptr;
+	}
+	unsigned char tileDefIndex = chunk.m_tileDefIndexes.Get(x - chunk.m_mins.x, y - chunk.m_mins.y);
+	return (tileDefIndex != NO_TILE_DEFINITION) ? m_game->m_tileDefs[tileDefIndex] : nullptr;
+}
+
+bool Map::IsTileSolid(int x, int y) const
+{
+	return m_solidity.GetOrDefault(x, y, 0) != 0;
+}
+
+float Map::GetWallDistance(Vec2 const& positionXY) const
+{
+	//Streamed maps have no field; reporting open space turns off wall avoidance rather than steering off stale data
+	if (m_distanceField == nullptr)
+	{
+		return FLT_MAX;
+	}
+	return m_distanceField->GetDistance(positionXY);
+}
+
+Vec2 Map::GetWallGradient(Vec2 const& positionXY) const
+{
+	if (m_distanceField == nullptr)
+	{
+		return Vec2();
+	}
+	return m_distanceField->GetGradient(positionXY);
+}
+
+bool Map::SetTile(int x, int y, int tileDefIndex)
+{
+	if (!m_solidity.IsInBounds(x, y))
+	{
+		return false;
+	}
+	if (tileDefIndex < 0 || tileDefIndex >= (int)m_game->m_tileDefs.size() || tileDefIndex >= NO_TILE_DEFINITION)
+	{
+		return false;
+	}
+
+	//Chunk files are never written back: an unloaded chunk can't take edits, and an edited one is never evicted
+	MapChunk& chunk = m_chunks[GetChunkIndex(x, y)];
+	if (!chunk.m_isResident)
+	{
+		return false;
+	}
+	chunk.m_isEdited = true;
+
+	TileDefinition const* tileDef = m_game->m_tileDefs[tileDefIndex];
+	chunk.m_tileDefIndexes.Set(x - chunk.m_mins.x, y - chunk.m_mins.y, (unsigned char)tileDefIndex);
+	m_solidity.Set(x, y, tileDef->GetIsSolid() ? 1 : 0);
+
+	//Collision trusts the field to skip tile tests, so it can't lag a frame behind; only the window the field's max distance reaches is redone
+	if (m_distanceField != nullptr)
+	{
+		m_distanceField->RebuildAroundTile(m_solidity, IntVec2(x, y));
+	}
+
+	//The tile's own geometry only lives in its chunk, but its shadow and occlusion reach further in the bake
+	float reach = 0.f;
+	Vec2 shadowOffset;
+	if (m_isLightingBaked)
+	{
+		reach = g_gameConfigBlackboard->GetValue("bakeOcclusionDistance", 1.5f);
+		Vec3 toSun = -m_game->m_lightDirection.GetNormalized();
+		if (toSun.z > 0.f)
+		{
+			//Surfaces this far down-sun can have a ray to the sun cross the tile below the wall tops
+			float shadowLength = m_definition->m_ceilingHeight / toSun.z;
+			shadowOffset = Vec2(-toSun.x * shadowLength, -toSun.y * shadowLength);
+		}
+	}
+	float minX = (float)x - reach + ((shadowOffset.x < 0.f) ? shadowOffset.x : 0.f);
+	float minY = (float)y - reach + ((shadowOffset.y < 0.f) ? shadowOffset.y : 0.f);
+	float maxX = (float)(x + 1) + reach + ((shadowOffset.x > 0.f) ? shadowOffset.x : 0.f);
+	float maxY = (float)(y + 1) + reach + ((shadowOffset.y > 0.f) ? shadowOffset.y : 0.f);
+	DirtyChunksInArea(IntVec2((int)floorf(minX), (int)floorf(minY)), IntVec2((int)ceilf(maxX), (int)ceilf(maxY)));
+
+	//Static lights whose reach covers the tile can now be blocked, or unblocked, anywhere inside that reach
+	if (m_isLightingBaked)
+	{
+		for (int i = 0; i < (int)m_definition->m_staticLights.size(); i++)
+		{
+			StaticLightInfo const& staticLight = m_definition->m_staticLights[i];
+			float closestX = GetClamped(staticLight.m_position.x, (float)x, (float)(x + 1));
+			float closestY = GetClamped(staticLight.m_position.y, (float)y, (float)(y + 1));
+			float dx = closestX - staticLight.m_position.x;
+			float dy = closestY - staticLight.m_position.y;
+			if ((dx * dx) + (dy * dy) < staticLight.m_radius * staticLight.m_radius)
+			{
+				DirtyChunksInArea(IntVec2((int)floorf(staticLight.m_position.x - staticLight.m_radius), (int)floorf(staticLight.m_position.y - staticLight.m_radius)),
+					IntVec2((int)ceilf(staticLight.m_position.x + staticLight.m_radius), (int)ceilf(staticLight.m_position.y + staticLight.m_radius)));
+			}
+		}
+	}
+	return true;
+}
+
+void Map::DirtyChunksInArea(IntVec2 const& mins, IntVec2 const& maxs, int ignoreChunkIndex)
+{
+	//Tile range [mins, maxs) to the chunks that hold any of it
+	int chunkMinX = (mins.x > 0) ? (mins.x / m_chunkSize) : 0;
+	int chunkMinY = (mins.y > 0) ? (mins.y / m_chunkSize) : 0;
+	int chunkMaxX = (maxs.x - 1) / m_chunkSize;
+	int chunkMaxY = (maxs.y - 1) / m_chunkSize;
+	chunkMaxX = (chunkMaxX < m_numChunks.x - 1) ? chunkMaxX : m_numChunks.x - 1;
+	chunkMaxY = (chunkMaxY < m_numChunks.y - 1) ? chunkMaxY : m_numChunks.y - 1;
+	for (int chunkY = chunkMinY; chunkY <= chunkMaxY; chunkY++)
+	{
+		for (int chunkX = chunkMinX; chunkX <= chunkMaxX; chunkX++)
+		{
+			int chunkIndex = (chunkY * m_numChunks.x) + chunkX;
+			MapChunk& chunk = m_chunks[chunkIndex];
+
+			//Unloaded chunks build from scratch when they load; one loading now lands stale and is built again
+			if (chunkIndex == ignoreChunkIndex || (!chunk.m_isResident && !chunk.m_isBuilding))
+			{
+				continue;
+			}
+			chunk.m_version++;
+
+			//A chunk already building is sent again when that build lands, so it never has two in flight
+			if (!chunk.m_isBuilding)
+			{
+				chunk.m_isBuilding = true;
+				m_chunkBuilder->Enqueue(CreateChunkBuildInput(chunkIndex));
+			}
+		}
+	}
+}
+
+int Map::GetBakeMargin() const
+{
+	if (!m_isLightingBaked)
+	{
+		return 0;
+	}
+
+	//Farthest any bake ray travels over the tiles: an occlusion ray, a sun ray climbing to the wall tops, or a ray to a static light
+	float reach = g_gameConfigBlackboard->GetValue("bakeOcclusionDistance", 1.5f);
+	Vec3 toSun = -m_game->m_lightDirection.GetNormalized();
+	if (toSun.z > 0.f)
+	{
+		float shadowLength = m_definition->m_ceilingHeight / toSun.z;
+		reach = (reach > fabsf(toSun.x * shadowLength)) ? reach : fabsf(toSun.x * shadowLength);
+		reach = (reach > fabsf(toSun.y * shadowLength)) ? reach : fabsf(toSun.y * shadowLength);
+	}
+	for (int i = 0; i < (int)m_definition->m_staticLights.size(); i++)
+	{
+		reach = (reach > m_definition->m_staticLights[i].m_radius) ? reach : m_definition->m_staticLights[i].m_radius;
+	}
+	return (int)ceilf(reach) + 1;
+}
+
+void Map::Update()
+{
+	UpdateChunks();
+	UpdateStreaming();
+	UpdateLightBuffer();
+
+	//Weapons fire during actor updates, so those queries need this frame's buckets; rebuilt after movement for projectiles and blasts
+	BuildActorGrid();
+	UpdateActors();
+	BuildActorGrid();
+	m_projectiles->Update((float)g_theGameClock->GetDeltaSeconds());
+	m_effects->Update((float)g_theGameClock->GetDeltaSeconds());
+	ResolveExplosions();
+	DeleteDestroyedActors();
+}
+
+void Map::UpdateChunks()
+{
+	MapChunkBuildResult* result = m_chunkBuilder->PopFinished();
+	if (result == nullptr)
+	{
+		return;
+	}
+
+	//Swapping buffers is a direct upload, so the render thread has to be done with the old ones first
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->Flush();
+	}
+	int bakeMargin = GetBakeMargin();
+	while (result != nullptr)
+	{
+		MapChunk& chunk = m_chunks[result->m_chunkIndex];
+		chunk.m_isBuilding = false;
+		if (result->m_isTileLoad)
+		{
+			m_numChunkLoads--;
+			if (result->m_didLoadFail)
+			{
+				g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, Stringf("Could not read map chunk %i of %s", result->m_chunkIndex, m_definition->GetName().c_str()));
+			}
+			InstallChunkTiles(result->m_chunkIndex, result->m_tileDefIndexes);
+
+			//Neighbours baked with this chunk as a wall of unloaded tiles
+			DirtyChunksInArea(IntVec2(chunk.m_mins.x - bakeMargin, chunk.m_mins.y - bakeMargin), IntVec2(chunk.m_maxs.x + bakeMargin, chunk.m_maxs.y + bakeMargin), result->m_chunkIndex);
+		}
+
+		if (result->m_version == chunk.m_version)
+		{
+			UploadChunk(*result);
+		}
+		else
+		{
+			//Tiles changed again while it was building; the result is already stale
+			chunk.m_isBuilding = true;
+			m_chunkBuilder->Enqueue(CreateChunkBuildInput(result->m_chunkIndex));
+		}
+		delete result;
+		result = m_chunkBuilder->PopFinished();
+	}
+}
+
+void Map::UpdateStreaming()
+{
+	if (!m_isStreamed)
+	{
+		return;
+	}
+
+	std::vector<Vec2> viewers;
+	for (int i = 0; i < (int)m_game->m_playerList.size(); i++)
+	{
+		if (m_game->m_playerList[i] != nullptr)
+		{
+			viewers.push_back(m_game->m_playerList[i]->m_playerCamPosition.GetFlattenedXY());
+		}
+	}
+	if (viewers.empty())
+	{
+		return;
+	}
+
+	//Unloaded chunks within the view distance of any player, nearest first
+	m_streamingCandidates.clear();
+	for (int viewerIndex = 0; viewerIndex < (int)viewers.size(); viewerIndex++)
+	{
+		Vec2 const& viewer = viewers[viewerIndex];
+		int chunkMinX = (int)floorf((viewer.x - m_streamingViewDistance) / (float)m_chunkSize);
+		int chunkMinY = (int)floorf((viewer.y - m_streamingViewDistance) / (float)m_chunkSize);
+		int chunkMaxX = (int)floorf((viewer.x + m_streamingViewDistance) / (float)m_chunkSize);
+		int chunkMaxY = (int)floorf((viewer.y + m_streamingViewDistance) / (float)m_chunkSize);
+		chunkMinX = (chunkMinX > 0) ? chunkMinX : 0;
+		chunkMinY = (chunkMinY > 0) ? chunkMinY : 0;
+		chunkMaxX = (chunkMaxX < m_numChunks.x - 1) ? chunkMaxX : m_numChunks.x - 1;
+		chunkMaxY = (chunkMaxY < m_numChunks.y - 1) ? chunkMaxY : m_numChunks.y - 1;
+		for (int chunkY = chunkMinY; chunkY <= chunkMaxY; chunkY++)
+		{
+			for (int chunkX = chunkMinX; chunkX <= chunkMaxX; chunkX++)
+			{
+				int chunkIndex = (chunkY * m_numChunks.x) + chunkX;
+				MapChunk const& chunk = m_chunks[chunkIndex];
+				if (chunk.m_isResident || chunk.m_isBuilding)
+				{
+					continue;
+				}
+				float distance = GetDistanceToChunk(viewer, chunk);
+				if (distance <= m_streamingViewDistance)
+				{
+					m_streamingCandidates.push_back(std::make_pair(distance, chunkIndex));
+				}
+			}
+		}
+	}
+	std::sort(m_streamingCandidates.begin(), m_streamingCandidates.end());
+
+	//Only a few loads in flight, so a player who turns around isn't stuck behind a queue of chunks they walked away from
+	for (int i = 0; i < (int)m_streamingCandidates.size() && m_numChunkLoads < m_maxChunkLoads; i++)
+	{
+		MapChunk& chunk = m_chunks[m_streamingCandidates[i].second];
+		if (chunk.m_isBuilding)
+		{
+			continue;
+		}
+		chunk.m_isBuilding = true;
+		m_numChunkLoads++;
+		m_chunkBuilder->Enqueue(CreateChunkBuildInput(m_streamingCandidates[i].second));
+	}
+
+	if (m_residentBytes <= m_streamingBudgetBytes)
+	{
+		return;
+	}
+
+	//Over budget: drop the farthest chunks, keeping a chunk of slack past the view distance so walking along the edge doesn't thrash.
+	//Edited chunks stay, since reloading one from its file would undo the edits.
+	m_streamingCandidates.clear();
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		MapChunk const& chunk = m_chunks[chunkIndex];
+		if (!chunk.m_isResident || chunk.m_isBuilding || chunk.m_isEdited)
+		{
+			continue;
+		}
+		float nearestDistance = FLT_MAX;
+		for (int viewerIndex = 0; viewerIndex < (int)viewers.size(); viewerIndex++)
+		{
+			float distance = GetDistanceToChunk(viewers[viewerIndex], chunk);
+			nearestDistance = (distance < nearestDistance) ? distance : nearestDistance;
+		}
+		if (nearestDistance > m_streamingViewDistance + (float)m_chunkSize)
+		{
+			m_streamingCandidates.push_back(std::make_pair(-nearestDistance, chunkIndex));
+		}
+	}
+	std::sort(m_streamingCandidates.begin(), m_streamingCandidates.end());
+	for (int i = 0; i < (int)m_streamingCandidates.size() && m_residentBytes > m_streamingBudgetBytes; i++)
+	{
+		EvictChunk(m_streamingCandidates[i].second);
+	}
+}
+
+void Map::LoadChunksNear(Vec3 const& position)
+{
+	if (!m_isStreamed)
+	{
+		return;
+	}
+
+	//Chunks already loading in the background are left to land on their own
+	std::vector<int> chunkIndexes;
+	Vec2 positionXY = position.GetFlattenedXY();
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		MapChunk const& chunk = m_chunks[chunkIndex];
+		if (chunk.m_isResident || chunk.m_isBuilding)
+		{
+			continue;
+		}
+		if (GetDistanceToChunk(positionXY, chunk) <= m_streamingViewDistance)
+		{
+			chunkIndexes.push_back(chunkIndex);
+		}
+	}
+	if (chunkIndexes.empty())
+	{
+		return;
+	}
+
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->Flush();
+	}
+	BuildChunksNow(chunkIndexes);
+}
+
+void Map::EvictChunk(int chunkIndex)
+{
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->Flush();
+	}
+
+	MapChunk& chunk = m_chunks[chunkIndex];
+	delete chunk.m_vertexBuffer;
+	delete chunk.m_indexBuffer;
+	chunk.m_vertexBuffer = nullptr;
+	chunk.m_indexBuffer = nullptr;
+	chunk.m_numIndexes = 0;
+	chunk.m_isCompact = false;
+	chunk.m_tileDefIndexes = Grid<unsigned char>();
+	chunk.m_isResident = false;
+	chunk.m_version++;
+	m_residentBytes -= chunk.m_numBytes;
+	chunk.m_numBytes = 0;
+
+	//Neighbours keep their bake; they are as far out as this chunk was, and rebuild when it loads again
+	for (int y = chunk.m_mins.y; y < chunk.m_maxs.y; y++)
+	{
+		for (int x = chunk.m_mins.x; x < chunk.m_maxs.x; x++)
+		{
+			m_solidity.Set(x, y, 1);
+		}
+	}
+}
+
+void Map::UpdateLightBuffer()
+{
+	m_lightConstants.c_sunDirection = m_game->m_lightDirection.GetNormalized();
+	m_lightConstants.c_sunIntensity = m_game->m_lightIntensity;
+	m_lightConstants.c_ambientIntensity = m_game->m_ambientIntensity;
+	ClearPointLights();
+}
+
+void Map::UpdateActors()
+{
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr)
+		{
+			//Parked actors would walk into unloaded tiles that only look like walls, so they wait for the chunk instead
+			m_actors[i]->m_isParked = !IsPositionResident(m_actors[i]->m_position);
+			if (!m_actors[i]->m_isParked)
+			{
+				m_actors[i]->Update();
+			}
+		}
+	}
+	CollideActors();
+	CollideActorsWithMap();
+}
+
+void Map::UpdateAllActorVerts(BillboardView const& view)
+{
+	//Rebuilt per view, since billboards face the current camera
+	m_billboardBatch.Begin(view.m_cameraTransform);
+	m_viewCuller->BeginView(view.m_cameraPosition, view.m_cameraOrientation, view.m_fovDegrees, view.m_aspect, CULL_FAR_DISTANCE);
+	m_visibleActors.clear();
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		Actor* actor = m_actors[i];
+		if (actor == nullptr || !m_viewCuller->IsCylinderVisible(actor->m_position, actor->m_radius, actor->m_height))
+		{
+			continue;
+		}
+		m_visibleActors.push_back(actor);
+	}
+
+	int numWorkers = g_theWorkerPool->GetNumWorkers();
+	if ((int)m_workerBatches.size() < numWorkers)
+	{
+		m_workerBatches.resize(numWorkers);
+		m_workerScratchVerts.resize(numWorkers);
+	}
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_workerBatches[i].Begin(view.m_cameraTransform);
+	}
+	g_theWorkerPool->ParallelFor((int)m_visibleActors.size(), ACTOR_VERTS_BATCH_SIZE, [this, &view](int begin, int end, int workerIndex)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			m_visibleActors[i]->AddVertsForView(view, m_workerBatches[workerIndex], m_workerScratchVerts[workerIndex]);
+		}
+	});
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_billboardBatch.Append(m_workerBatches[i]);
+	}
+
+	m_projectiles->UpdateVerts(view.m_cameraTransform, m_billboardBatch);
+	m_effects->UpdateVerts(view.m_cameraTransform, m_billboardBatch);
+	m_billboardBatch.End();
+}
+
+void Map::UpdateLightsForView(BillboardView const& view)
+{
+	m_lightBudget->BeginView(view.m_cameraPosition, view.m_cameraOrientation, view.m_fovDegrees, view.m_aspect, CULL_FAR_DISTANCE);
+	m_lightBudget->SelectLights(m_pointLights);
+	m_lightBudget->WriteLightConstants(m_pointLights, m_lightConstants);
+
+	//With no dynamic lights around, the buffer usually already holds exactly this
+	if (memcmp(&m_lightConstants, &m_uploadedLightConstants, sizeof(LightConstants)) == 0)
+	{
+		return;
+	}
+	g_theRenderQueue->SubmitUpload(m_lightBuffer, &m_lightConstants, sizeof(LightConstants));
+	if (m_bakedLightBuffer != nullptr)
+	{
+		LightConstants bakedConstants = GetBakedLightConstants(m_lightConstants);
+		g_theRenderQueue->SubmitUpload(m_bakedLightBuffer, &bakedConstants, sizeof(LightConstants));
+	}
+	m_uploadedLightConstants = m_lightConstants;
+}
+
+CullStats const& Map::GetActorCullStats() const
+{
+	return m_viewCuller->GetStats();
+}
+
+LightBudgetStats const& Map::GetLightBudgetStats() const
+{
+	return m_lightBudget->GetStats();
+}
+
+void Map::CollideActors()
+{
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && !m_actors[i]->m_isParked && m_actors[i]->m_definition.m_collisionElement.m_collidesWithActors)
+		{
+			for (int j = 0; j < m_actors.size(); j++)
+			{
+				if (i != j && m_actors[j] != nullptr && !m_actors[j]->m_isParked && m_actors[j]->m_definition.m_collisionElement.m_collidesWithActors)
+				{
+					CollideActors(m_actors[i], m_actors[j]);
+				}
+			}
+		}
+	}
+}
+
+void Map::CollideActors(Actor* a, Actor* b)
+{
+	bool collided = false;
+	Vec2 aCenterXY = Vec2(a->m_position.x, a->m_position.y);
+	Vec2 bCenterXY = Vec2(b->m_position.x, b->m_position.y);
+	FloatRange aRange = FloatRange(a->m_position.z, a->m_position.z + a->m_height-.001f);
+	FloatRange bRange = FloatRange(b->m_position.z, b->m_position.z + b->m_height-.001f);
+
+	bool aOwnsb = b->m_owningActor == a->m_handle;
+	bool bOwnsa = a->m_owningActor == b->m_handle;
+	bool aIsDead = a->m_isDead;
+	bool bIsDead = b->m_isDead;
+
+	if (aRange.IsOverlappingWith(bRange) && !aOwnsb && !bOwnsa && !aIsDead && !bIsDead)
+	{
+		if (a->m_isStatic && !b->m_isStatic)
+		{
+			bool thisImpact = PushDiscOutOfDisc2D(bCenterXY, b->m_radius, aCenterXY, a->m_radius);
+			b->m_position = Vec3(bCenterXY.x, bCenterXY.y, b->m_position.z);
+			if (!collided)
+			{
+				collided = thisImpact;
+			}
+		}
+		else if (!a->m_isStatic && b->m_isStatic)
+		{
+			bool thisImpact = PushDiscOutOfDisc2D(aCenterXY, a->m_radius, bCenterXY, b->m_radius);
+			a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
+			if (!collided)
+			{
+				collided = thisImpact;
+			}
+		}
+		else
+		{
+			bool thisImpact = PushDiscsOutOfEachOther2D(aCenterXY, a->m_radius, bCenterXY, b->m_radius);
+			a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
+			b->m_position = Vec3(bCenterXY.x, bCenterXY.y, b->m_position.z);
+			if (!collided)
+			{
+				collided = thisImpact;
+			}
+		}
+	}
+
+	if (collided)
+	{
+		a->OnCollide(b);
+		b->OnCollide(a);
+	}
+}
+
+void Map::CollideActorsWithMap()
+{
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && !m_actors[i]->m_isParked)
+		{
+			for (int j = 0; j < m_actors.size(); j++)
+			{
+				CollideActorWithMap(m_actors[i]);
+			}
+		}
+	}
+}
+
+void Map::CollideActorWithMap(Actor* a)
+{
+	bool didImpact = false;
+	if (!a->m_definition.m_collisionElement.m_collidesWithWorld || !IsPositionInBounds(a->m_position))
+	{
+		return;
+	}
+	Vec2 aCenterXY = Vec2(a->m_position.x, a->m_position.y);
+
+	//Nothing solid within the radius means none of the eight neighbour tests can push, so only floor and ceiling remain
+	if (m_distanceField == nullptr || m_distanceField->GetDistanceLowerBound(aCenterXY) < a->m_radius)
+	{
+		//Edge neighbours first, then corners; each push moves the disc before the next tile is tested
+		IntVec2 tileCoordinate = GetCoordFromPosition(a->m_position);
+		m_solidity.ForEachNeighbor8(tileCoordinate.x, tileCoordinate.y, [a, &aCenterXY, &didImpact](int x, int y, unsigned char solid)
+		{
+			if (solid == 0)
+			{
+				return;
+			}
+			AABB2 tileBoundsXY = AABB2(Vec2((float)x, (float)y), Vec2((float)(x + 1), (float)(y + 1)));
+			bool collided = PushDiscOutOfAABB2D(aCenterXY, a->m_radius, tileBoundsXY);
+			a->m_position = Vec3(aCenterXY.x, aCenterXY.y, a->m_position.z);
+			if (collided)
+			{
+				didImpact = collided;
+			}
+		});
+	}
+
+	FloatRange aRange = FloatRange(a->m_position.z, a->m_position.z + a->m_height);
+
+	if (aRange.IsOnRange(0.f))
+	{
+		bool collided;
+		float newZ =  0.f;
+		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, newZ);
+		collided = true;
+		if (collided)
+		{
+			didImpact = collided;
+		}
+	}
+
+	if (aRange.IsOnRange(m_definition->m_ceilingHeight))
+	{
+		bool collided;
+		float newZ = 1.f - a->m_height;
+		a->m_position = Vec3(aCenterXY.x, aCenterXY.y, newZ);
+		collided = true;
+		if (collided)
+		{
+			didImpact = collided;
+		}
+	}
+
+	if (didImpact)
+	{
+		a->OnCollide();
+	}
+}
+
+std::vector<Actor*> Map::GetActorsInSector(Actor* actorReference, float sectorAngle, float radius)
+{
+	std::vector<Actor*> returnedActors;
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && m_actors[i]->m_handle != actorReference->m_handle)
+		{
+			if (IsPointInsideDirectedSector2D(m_actors[i]->m_position.GetFlattenedXY(), actorReference->m_position.GetFlattenedXY(),
+				actorReference->m_orientation.GetForwardNormal().GetFlattenedXY(), sectorAngle, radius))
+			{
+				returnedActors.push_back(m_actors[i]);
+			}
+		}
+	}
+	return returnedActors;
+}
+
+void Map::BuildActorGrid()
+{
+	m_actorGridCellStarts.Initialize(m_dimensions, 0);
+	m_actorGridCellCounts.Initialize(m_dimensions, 0);
+	m_actorGridEntries.clear();
+	if (m_actorQueryStamps.size() < m_actors.size())
+	{
+		m_actorQueryStamps.resize(m_actors.size(), 0);
+	}
+
+	//Count how many entries land in each cell
+	IntVec2 mins;
+	IntVec2 maxs;
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && GetCellRangeForDisc(m_actors[i]->m_position, m_actors[i]->m_radius, mins, maxs))
+		{
+			for (int y = mins.y; y <= maxs.y; y++)
+			{
+				for (int x = mins.x; x <= maxs.x; x++)
+				{
+					m_actorGridCellCounts.Get(x, y)++;
+				}
+			}
+		}
+	}
+
+	//Prefix sum in storage order so each cell knows where its entries begin
+	std::vector<int>& starts = m_actorGridCellStarts.GetCells();
+	std::vector<int>& counts = m_actorGridCellCounts.GetCells();
+	int numEntries = 0;
+	for (int cell = 0; cell < (int)counts.size(); cell++)
+	{
+		starts[cell] = numEntries;
+		numEntries += counts[cell];
+		counts[cell] = 0;
+	}
+	m_actorGridEntries.resize(numEntries);
+
+	//Fill, counting each cell back up as its cursor
+	for (int i = 0; i < (int)m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && GetCellRangeForDisc(m_actors[i]->m_position, m_actors[i]->m_radius, mins, maxs))
+		{
+			for (int y = mins.y; y <= maxs.y; y++)
+			{
+				for (int x = mins.x; x <= maxs.x; x++)
+				{
+					int& count = m_actorGridCellCounts.Get(x, y);
+					m_actorGridEntries[m_actorGridCellStarts.Get(x, y) + count] = i;
+					count++;
+				}
+			}
+		}
+	}
+}
+
+bool Map::GetCellRangeForDisc(Vec3 const& center, float radius, IntVec2& out_mins, IntVec2& out_maxs) const
+{
+	int minX = (int)floorf(center.x - radius);
+	int minY = (int)floorf(center.y - radius);
+	int maxX = (int)floorf(center.x + radius);
+	int maxY = (int)floorf(center.y + radius);
+	if (maxX < 0 || maxY < 0 || minX >= m_dimensions.x || minY >= m_dimensions.y)
+	{
+		return false;
+	}
+
+	out_mins = IntVec2((minX < 0) ? 0 : minX, (minY < 0) ? 0 : minY);
+	out_maxs = IntVec2((maxX >= m_dimensions.x) ? m_dimensions.x - 1 : maxX, (maxY >= m_dimensions.y) ? m_dimensions.y - 1 : maxY);
+	return true;
+}
+
+void Map::BeginActorQuery() const
+{
+	//Actors are stored in every cell they touch, so queries stamp them to report each one once
+	m_actorQueryStamp++;
+	if (m_actorQueryStamp == 0)
+	{
+		std::fill(m_actorQueryStamps.begin(), m_actorQueryStamps.end(), 0);
+		m_actorQueryStamp = 1;
+	}
+}
+
+void Map::GetActorsInRadius(Vec3 const& center, float radius, std::vector<Actor*>& out_actors) const
+{
+	out_actors.clear();
+	IntVec2 mins;
+	IntVec2 maxs;
+	if (m_actorGridCellStarts.GetCells().empty() || !GetCellRangeForDisc(center, radius, mins, maxs))
+	{
+		return;
+	}
+
+	BeginActorQuery();
+	Vec2 centerXY = center.GetFlattenedXY();
+	for (int y = mins.y; y <= maxs.y; y++)
+	{
+		for (int x = mins.x; x <= maxs.x; x++)
+		{
+			int firstEntry = m_actorGridCellStarts.Get(x, y);
+			int endEntry = firstEntry + m_actorGridCellCounts.Get(x, y);
+			for (int entry = firstEntry; entry < endEntry; entry++)
+			{
+				int slot = m_actorGridEntries[entry];
+				if (m_actorQueryStamps[slot] == m_actorQueryStamp)
+				{
+					continue;
+				}
+				m_actorQueryStamps[slot] = m_actorQueryStamp;
+
+				Actor* actor = m_actors[slot];
+				if (actor == nullptr)
+				{
+					continue;
+				}
+				float reach = radius + actor->m_radius;
+				if ((actor->m_position.GetFlattenedXY() - centerXY).GetLengthSquared() <= reach * reach)
+				{
+					out_actors.push_back(actor);
+				}
+			}
+		}
+	}
+}
+
+bool Map::IsLineOfSightClearXY(Vec3 const& start, Vec3 const& end) const
+{
+	//Tile-only DDA; actors never block line of sight here
+	float deltaX = end.x - start.x;
+	float deltaY = end.y - start.y;
+	int tileX = (int)floorf(start.x);
+	int tileY = (int)floorf(start.y);
+	int endTileX = (int)floorf(end.x);
+	int endTileY = (int)floorf(end.y);
+
+	int stepX = (deltaX > 0.f) ? 1 : -1;
+	int stepY = (deltaY > 0.f) ? 1 : -1;
+	float tDeltaX = (deltaX != 0.f) ? fabsf(1.f / deltaX) : 9999999.f;
+	float tDeltaY = (deltaY != 0.f) ? fabsf(1.f / deltaY) : 9999999.f;
+	float tMaxX = (deltaX > 0.f) ? ((float)(tileX + 1) - start.x) * tDeltaX : (start.x - (float)tileX) * tDeltaX;
+	float tMaxY = (deltaY > 0.f) ? ((float)(tileY + 1) - start.y) * tDeltaY : (start.y - (float)tileY) * tDeltaY;
+
+	int numSteps = abs(endTileX - tileX) + abs(endTileY - tileY);
+	for (int step = 0; step <= numSteps; step++)
+	{
+		if (IsTileSolid(tileX, tileY))
+		{
+			return false;
+		}
+
+		if (tMaxX < tMaxY)
+		{
+			tMaxX += tDeltaX;
+			tileX += stepX;
+		}
+		else
+		{
+			tMaxY += tDeltaY;
+			tileY += stepY;
+		}
+	}
+	return true;
+}
+
+void Map::AddExplosion(ExplosionInfo const& explosion)
+{
+	if (explosion.m_radius > 0.f)
+	{
+		m_pendingExplosions.push_back(explosion);
+	}
+}
+
+void Map::ResolveExplosions()
+{
+	//Explosions set off while delivering damage (chained projectiles) resolve on the next pass
+	constexpr int MAX_CHAIN_PASSES = 8;
+	for (int pass = 0; pass < MAX_CHAIN_PASSES && !m_pendingExplosions.empty(); pass++)
+	{
+		m_resolvingExplosions.swap(m_pendingExplosions);
+		m_pendingExplosions.clear();
+		m_explosionHits.clear();
+
+		//Gather every explosion/actor pair from the grid
+		for (int i = 0; i < (int)m_resolvingExplosions.size(); i++)
+		{
+			ExplosionInfo const& explosion = m_resolvingExplosions[i];
+			GetActorsInRadius(explosion.m_position, explosion.m_radius, m_explosionCandidates);
+			for (int j = 0; j < (int)m_explosionCandidates.size(); j++)
+			{
+				Actor* target = m_explosionCandidates[j];
+				if (target->m_isDead)
+				{
+					continue;
+				}
+
+				//Distance to the closest point on the target's cylinder
+				float horizontal = (target->m_position.GetFlattenedXY() - explosion.m_position.GetFlattenedXY()).GetLength() - target->m_radius;
+				horizontal = GetClamped(horizontal, 0.f, explosion.m_radius);
+				float vertical = 0.f;
+				if (explosion.m_position.z < target->m_position.z)
+				{
+					vertical = target->m_position.z - explosion.m_position.z;
+				}
+				else if (explosion.m_position.z > target->m_position.z + target->m_height)
+				{
+					vertical = explosion.m_position.z - (target->m_position.z + target->m_height);
+				}
+				float distance = sqrtf((horizontal * horizontal) + (vertical * vertical));
+				if (distance >= explosion.m_radius)
+				{
+					continue;
+				}
+
+				ExplosionHit hit;
+				hit.m_explosionIndex = i;
+				hit.m_target = target;
+				hit.m_falloff = 1.f - (distance / explosion.m_radius);
+				m_explosionHits.push_back(hit);
+			}
+		}
+
+		//Occlusion against the tile grid for the whole batch
+		for (int i = 0; i < (int)m_explosionHits.size(); i++)
+		{
+			ExplosionHit& hit = m_explosionHits[i];
+			if (!IsLineOfSightClearXY(m_resolvingExplosions[hit.m_explosionIndex].m_position, hit.m_target->m_position))
+			{
+				hit.m_falloff = 0.f;
+			}
+		}
+
+		//Deliver damage and impulse
+		for (int i = 0; i < (int)m_explosionHits.size(); i++)
+		{
+			ExplosionHit const& hit = m_explosionHits[i];
+			if (hit.m_falloff <= 0.f)
+			{
+				continue;
+			}
+
+			ExplosionInfo const& explosion = m_resolvingExplosions[hit.m_explosionIndex];
+			Actor* source = nullptr;
+			if (explosion.m_source != ActorHandle::INVALID)
+			{
+				source = GetActorByHandle(explosion.m_source);
+			}
+
+			Vec3 targetCenter = hit.m_target->m_position + Vec3(0.f, 0.f, hit.m_target->m_height * .5f);
+			Vec3 direction = targetCenter - explosion.m_position;
+			if (direction == Vec3())
+			{
+				direction = Vec3(0.f, 0.f, 1.f);
+			}
+			hit.m_target->TakeDamage(source, explosion.m_damage * hit.m_falloff);
+			hit.m_target->AddImpulse(direction.GetNormalized() * (explosion.m_impulse * hit.m_falloff));
+		}
+	}
+	m_resolvingExplosions.clear();
+}
+
+void Map::Render() const
+{
+	RenderCommand skyCommand;
+	skyCommand.m_pass = RenderPass::SKY;
+	skyCommand.m_texture = &m_skyBoxSheet->GetTexture();
+	skyCommand.m_blendMode = BlendMode::ADDITIVE;
+	skyCommand.m_depthMode = DepthMode::DISABLED;
+	skyCommand.m_verts = &m_skyBoxVerts;
+	g_theRenderQueue->Submit(skyCommand);
+
+	for (int i = 0; i < (int)m_chunks.size(); i++)
+	{
+		MapChunk const& chunk = m_chunks[i];
+		if (chunk.m_numIndexes == 0)
+		{
+			continue;
+		}
+		RenderCommand worldCommand;
+		worldCommand.m_pass = RenderPass::WORLD;
+		worldCommand.m_type = RenderCommandType::LIT_INDEX_BUFFER;
+		worldCommand.m_texture = m_texture;
+		worldCommand.m_shader = m_shader;
+		if (chunk.m_isCompact)
+		{
+			worldCommand.m_shader = m_compactShader;
+			worldCommand.m_modelTransform = Mat44::MakeTranslation3D(Vec3((float)chunk.m_mins.x, (float)chunk.m_mins.y, 0.f));
+			worldCommand.m_vertexFrameBuffer = m_vertexFrameBuffer;
+		}
+		worldCommand.m_vertexBuffer = chunk.m_vertexBuffer;
+		worldCommand.m_indexBuffer = chunk.m_indexBuffer;
+		worldCommand.m_lightBuffer = (m_bakedLightBuffer != nullptr) ? m_bakedLightBuffer : m_lightBuffer;
+		worldCommand.m_count = chunk.m_numIndexes;
+		g_theRenderQueue->Submit(worldCommand);
+	}
+
+	m_decals->Submit(*g_theRenderQueue, m_lightBuffer);
+	RenderActors();
+}
+
+void Map::RenderActors() const
+{
+	m_billboardBatch.Submit(*g_theRenderQueue, m_lightBuffer);
+}
+
+int Map::AddPointLightToMap(Vec3 const& location, float intensity, Rgba8 const& color)
+{
+	//No cap here: the light budget ranks every light by intensity per view, so dropping by submission order would skip that
+	PointLight point;
+	float rgba[4];
+	color.GetAsFloats(rgba);
+	point.LightColor[0] = rgba[0];
+	point.LightColor[1] = rgba[1];
+	point.LightColor[2] = rgba[2];
+	point.LightColor[3] = rgba[3];
+
+	point.LightPosition = location;
+	point.Intensity = intensity;
+
+	m_pointLights.push_back(point);
+	return (int)m_pointLights.size() - 1;
+}
+
+void Map::ClearPointLights()
+{
+	m_pointLights.clear();
+}
+
+void Map::OnDemonKilled()
+{
+	m_game->m_enemiesRemainingOnMap--;
+	if (m_game->m_player)
+	{
+		m_game->m_player->m_kills++;
+	}
+}
+
+void Map::OnPlayerKilled()
+{
+}
+
+RaycastResult3D Map::RaycastAll(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner) const
+{
+	RaycastResult3D resultTotal;
+	resultTotal.m_didImpact = false;
+	resultTotal.m_impactPos = start + direction * distance;
+	resultTotal.m_rayMaxLength = distance;
+	resultTotal.m_impactDist = 10000.f;
+	if (distance == 0.f)
+	{
+		return resultTotal;
+	}
+	Vec3 ray3D = direction * distance;
+
+	RaycastResult3D resultWorldZ = RaycastWorldZ(start, direction, distance);
+	RaycastResult3D resultWorldXY = RaycastWorldXY(start, direction, distance);
+	Actor* temp = nullptr;
+	RaycastResult3D resultActors = RaycastWorldActors(start, direction, distance, temp, owner);
+
+	if (resultWorldZ.m_impactDist < resultWorldXY.m_impactDist)
+	{
+		resultTotal = resultWorldZ;
+	}
+	else
+	{
+		resultTotal = resultWorldXY;
+	}
+
+	if (resultActors.m_impactDist < resultTotal.m_impactDist)
+	{
+		resultTotal = resultActors;
+		hit = temp;
+	}
+
+	return resultTotal;
+}
+
+RaycastResult3D Map::RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const
+{
+	RaycastResult3D resultTotal;
+	resultTotal.m_didImpact = false;
+	Vec3 end = start + direction * distance;
+	resultTotal.m_impactPos = end;
+	resultTotal.m_rayMaxLength = distance;
+	resultTotal.m_impactDist = 9999999.f;	
+
+	Vec3 ray3D = direction * distance;
+	Vec3 ray2D = Vec3(ray3D.x, ray3D.y, 0.f);
+	Vec3 currentPos = start;
+	IntVec2 currentCoord = GetCoordFromPosition(start);
+
+	
+	if (IsTileSolid(currentCoord.x, currentCoord.y))
+	{
+		resultTotal.m_didImpact = true;
+		resultTotal.m_impactNormal = -direction;
+		resultTotal.m_impactPos = start;
+		resultTotal.m_impactDist = 0.f;
+		return resultTotal;
+	}
+
+	float stepX;
+	float stepY;
+	float tMaxX;
+	float tMaxY;
+	if (end.x - start.x > 0.f)
+	{
+		stepX = 1.f;
+		tMaxX = RangeMap((float)currentCoord.x + stepX, start.x, end.x, 0.f, 1.f);
+	}
+	else if (end.x - start.x < 0.f)
+	{
+		stepX = -1.f;
+		tMaxX = RangeMap((float)currentCoord.x, start.x, end.x, 0.f, 1.f);
+	}
+	else
+	{
+		stepX = 0.f;
+		tMaxX = RangeMap((float)currentCoord.x, start.x, end.x, 0.f, 1.f);
+	}
+	if (end.y - start.y > 0.f)
+	{
+		stepY = 1.f;
+		tMaxY = RangeMap((float)currentCoord.y + stepY, start.y, end.y, 0.f, 1.f);
+	}
+	else if (end.y - start.y < 0.f)
+	{
+		stepY = -1.f;
+		tMaxY = RangeMap((float)currentCoord.y, start.y, end.y, 0.f, 1.f);
+	}
+	else
+	{
+		stepY = 0.f;
+		tMaxY = RangeMap((float)currentCoord.y, start.y, end.y, 0.f, 1.f);
+	}
+
+	float tDeltaX = (stepX != 0.f) ? RangeMap(start.x + stepX, start.x, end.x, 0.f, 1.f) : 9999999.f;
+	float tDeltaY = (stepY != 0.f) ? RangeMap(start.y + stepY, start.y, end.y, 0.f, 1.f) : 9999999.f;
+
+	while (tMaxX <= 1.f || tMaxY <= 1.f)
+	{
+		if (tMaxX < tMaxY)
+		{
+			if (stepX == 0.f)
+			{
+				break;
+			}
+			currentPos = currentPos + Vec3(stepX, 0.f, 0.f);
+			currentCoord = GetCoordFromPosition(currentPos);
+			if (IsTileSolid(currentCoord.x, currentCoord.y))
+			{
+				resultTotal.m_didImpact = true;
+				resultTotal.m_impactNormal = Vec3(-stepX, 0.f, 0.f);
+				resultTotal.m_impactPos = (tMaxX * ray3D) + start;
+				resultTotal.m_impactDist = (tMaxX * ray3D).GetLength();
+				return resultTotal;
+			}
+			tMaxX = tMaxX + (tDeltaX);	
+		}
+		else
+		{
+			if (stepY == 0.f)
+			{
+				break;
+			}
+			currentPos = currentPos + Vec3(0.f, stepY, 0.f);
+			currentCoord = GetCoordFromPosition(currentPos);
+			if (IsTileSolid(currentCoord.x, currentCoord.y))
+			{
+				resultTotal.m_didImpact = true;
+				resultTotal.m_impactNormal = Vec3(0.f, -stepY, 0.f);
+				resultTotal.m_impactPos = (tMaxY * ray3D) + start;
+				resultTotal.m_impactDist = (tMaxY * ray3D).GetLength();
+				return resultTotal;
+			}
+			tMaxY = tMaxY + (tDeltaY);
+		}
+	}
+
+	return resultTotal;
+}
+
+RaycastResult3D Map::RaycastWorldZ(const Vec3& start, const Vec3& direction, float distance) const
+{
+	RaycastResult3D resultTotal;
+	resultTotal.m_didImpact = false;
+	resultTotal.m_impactPos = start + direction * distance;
+	resultTotal.m_rayMaxLength = distance;
+	resultTotal.m_impactDist = 9999999.f;
+
+	if (direction.z == 0.f)
+	{
+		return resultTotal;
+	}
+	
+	Vec3 ray3D = direction * distance;
+
+	if (direction.z > 0.f) //Check Ceiling
+	{
+		float t = RangeMap(1.f, start.z, resultTotal.m_impactPos.z, 0.f, m_definition->m_ceilingHeight);
+		if (t > 1.f)
+		{
+			return resultTotal;
+		}
+		else
+		{
+			Vec3 position = start + direction * (distance * t);
+			if (!IsPositionInBounds(position))
+			{
+				return resultTotal;
+			}
+			resultTotal.m_didImpact = true;
+			resultTotal.m_impactPos = position;
+			resultTotal.m_rayMaxLength = distance;
+			resultTotal.m_impactDist = (distance * t);
+			resultTotal.m_impactNormal = Vec3(0.f, 0.f, -1.f);
+			return resultTotal;
+		}
+	}
+	else //Check Floor
+	{
+		float t = RangeMap(0.f, start.z, resultTotal.m_impactPos.z, 0.f, 1.f);
+		if (t > 1.f)
+		{
+			return resultTotal;
+		}
+		else
+		{
+			Vec3 position = start + direction * (distance * t);
+			if (!IsPositionInBounds(position))
+			{
+				return resultTotal;
+			}
+			resultTotal.m_didImpact = true;
+			resultTotal.m_impactPos = position;
+			resultTotal.m_rayMaxLength = distance;
+			resultTotal.m_impactDist = (distance * t);
+			resultTotal.m_impactNormal = Vec3(0.f, 0.f, 1.f);
+			return resultTotal;
+		}
+	}
+}
+
+RaycastResult3D Map::RaycastWorldActors(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner) const
+{
+	RaycastResult3D resultTotal;
+	resultTotal.m_didImpact = false;
+	resultTotal.m_impactPos = start + direction * distance;
+	resultTotal.m_rayMaxLength = distance;
+	resultTotal.m_impactDist = 9999999.f;
+
+	Vec3 ray3D = direction * distance;
+
+	for (int i = 0; i < m_actors.size(); i++)
+	{
+		if (m_actors[i] != nullptr && (m_actors[i] != owner || owner == nullptr))
+		{
+			RaycastResult3D result = RaycastVsCylinderZ3D(start, direction, distance,
+				m_actors[i]->m_position + Vec3(0.f, 0.f, m_actors[i]->m_height * .5f), 
+				FloatRange(m_actors[i]->m_position.z, m_actors[i]->m_position.z + m_actors[i]->m_height), 
+				m_actors[i]->m_radius);
+
+			if (result.m_didImpact && result.m_impactDist < resultTotal.m_impactDist)
+			{
+				resultTotal = result;
+				hit = m_actors[i];
+			}
+		}
+	}
+	return resultTotal;
+}
+
+RaycastResult3D Map::SweepSphereVsWorld(const Vec3& start, const Vec3& direction, float distance, float radius) const
+{
+	RaycastResult3D result;
+	result.m_didImpact = false;
+	result.m_rayMaxLength = distance;
+	result.m_impactDist = distance;
+	result.m_impactPos = start + direction * distance;
+	float bestDist = distance;
+
+	//Floor and ceiling, pulled in by the radius
+	float ceiling = m_definition->m_ceilingHeight;
+	if (direction.z < 0.f || start.z - radius <= 0.f)
+	{
+		float dist = (start.z - radius <= 0.f) ? 0.f : (start.z - radius) / -direction.z;
+		if (dist <= bestDist)
+		{
+			bestDist = dist;
+			result.m_didImpact = true;
+			result.m_impactNormal = Vec3(0.f, 0.f, 1.f);
+		}
+	}
+	if (direction.z > 0.f || start.z + radius >= ceiling)
+	{
+		float dist = (start.z + radius >= ceiling) ? 0.f : (ceiling - radius - start.z) / direction.z;
+		if (dist <= bestDist)
+		{
+			bestDist = dist;
+			result.m_didImpact = true;
+			result.m_impactNormal = Vec3(0.f, 0.f, -1.f);
+		}
+	}
+
+	//Sphere-trace the open space first: no wall is within the radius of the center line before tracedDist
+	Vec2 startXY = start.GetFlattenedXY();
+	Vec2 directionXY = direction.GetFlattenedXY();
+	float speedXY = directionXY.GetLength();
+	float tracedDist = 0.f;
+	for (int step = 0; m_distanceField != nullptr && step < SPHERE_TRACE_MAX_STEPS && tracedDist <= bestDist; step++)
+	{
+		float clearance = m_distanceField->GetDistanceLowerBound(startXY + (directionXY * tracedDist)) - radius;
+		if (clearance < SPHERE_TRACE_MIN_STEP)
+		{
+			break;
+		}
+		if (speedXY <= 0.f)
+		{
+			tracedDist = bestDist + 1.f;
+			break;
+		}
+		tracedDist += clearance / speedXY;
+	}
+
+	//Walk the tiles under the rest of the center line; any solid tile within the radius (<= 1) neighbours a visited tile
+	Vec2 walkStartXY = startXY + (directionXY * tracedDist);
+	int tileX = (int)floorf(walkStartXY.x);
+	int tileY = (int)floorf(walkStartXY.y);
+	int stepX = (direction.x > 0.f) ? 1 : -1;
+	int stepY = (direction.y > 0.f) ? 1 : -1;
+	float tDeltaX = (direction.x != 0.f) ? fabsf(1.f / direction.x) : 9999999.f;
+	float tDeltaY = (direction.y != 0.f) ? fabsf(1.f / direction.y) : 9999999.f;
+	float tMaxX = tracedDist + ((direction.x > 0.f) ? ((float)(tileX + 1) - walkStartXY.x) * tDeltaX : (walkStartXY.x - (float)tileX) * tDeltaX);
+	float tMaxY = tracedDist + ((direction.y > 0.f) ? ((float)(tileY + 1) - walkStartXY.y) * tDeltaY : (walkStartXY.y - (float)tileY) * tDeltaY);
+	float cellEntryDist = tracedDist;
+
+	while (cellEntryDist <= bestDist)
+	{
+		for (int y = tileY - 1; y <= tileY + 1; y++)
+		{
+			for (int x = tileX - 1; x <= tileX + 1; x++)
+			{
+				if (!IsTileSolid(x, y))
+				{
+					continue;
+				}
+
+				//Slab test of the center line against the tile grown by the radius
+				AABB2 box = AABB2(Vec2((float)x - radius, (float)y - radius), Vec2((float)x + 1.f + radius, (float)y + 1.f + radius));
+				float enterDist = 0.f;
+				float exitDist = bestDist;
+				Vec2 normal = -directionXY;
+				bool isMissed = false;
+				for (int axis = 0; axis < 2 && !isMissed; axis++)
+				{
+					float origin = (axis == 0) ? startXY.x : startXY.y;
+					float dir = (axis == 0) ? directionXY.x : directionXY.y;
+					float minEdge = (axis == 0) ? box.m_mins.x : box.m_mins.y;
+					float maxEdge = (axis == 0) ? box.m_maxs.x : box.m_maxs.y;
+					if (dir == 0.f)
+					{
+						isMissed = origin < minEdge || origin > maxEdge;
+						continue;
+					}
+					float nearDist = (((dir > 0.f) ? minEdge : maxEdge) - origin) / dir;
+					float farDist = (((dir > 0.f) ? maxEdge : minEdge) - origin) / dir;
+					if (nearDist > enterDist)
+					{
+						enterDist = nearDist;
+						normal = (axis == 0) ? Vec2((dir > 0.f) ? -1.f : 1.f, 0.f) : Vec2(0.f, (dir > 0.f) ? -1.f : 1.f);
+					}
+					if (farDist < exitDist)
+					{
+						exitDist = farDist;
+					}
+					isMissed = enterDist > exitDist;
+				}
+				if (!isMissed && enterDist <= bestDist)
+				{
+					bestDist = enterDist;
+					result.m_didImpact = true;
+					result.m_impactNormal = Vec3(normal.x, normal.y, 0.f).GetNormalized();
+				}
+			}
+		}
+
+		if (tMaxX < tMaxY)
+		{
+			cellEntryDist = tMaxX;
+			tMaxX += tDeltaX;
+			tileX += stepX;
+		}
+		else
+		{
+			cellEntryDist = tMaxY;
+			tMaxY += tDeltaY;
+			tileY += stepY;
+		}
+	}
+
+	if (result.m_didImpact)
+	{
+		result.m_impactDist = bestDist;
+		result.m_impactPos = start + direction * bestDist;
+	}
+	return result;
+}
+
+RaycastResult3D Map::SweepSphereVsActors(const Vec3& start, const Vec3& direction, float distance, float radius, Actor*& hit, ActorHandle ignore, ActorHandle alsoIgnore) const
+{
+	RaycastResult3D closest;
+	closest.m_didImpact = false;
+	closest.m_rayMaxLength = distance;
+	closest.m_impactDist = distance;
+	closest.m_impactPos = start + direction * distance;
+	hit = nullptr;
+
+	//Every actor the swept sphere can touch is within this disc around the midpoint
+	float halfDistance = distance * .5f;
+	GetActorsInRadius(start + direction * halfDistance, halfDistance + radius, m_sweepCandidates);
+	for (int i = 0; i < (int)m_sweepCandidates.size(); i++)
+	{
+		Actor* actor = m_sweepCandidates[i];
+		if (actor->m_handle == ignore || actor->m_handle == alsoIgnore || actor->m_isDead || actor->m_definition.m_isPickup || !actor->m_definition.m_collisionElement.m_collidesWithActors)
+		{
+			continue;
+		}
+
+		//Sphere vs cylinder becomes a ray vs the cylinder grown by the radius
+		FloatRange grownRange = FloatRange(actor->m_position.z - radius, actor->m_position.z + actor->m_height + radius);
+		float grownRadius = actor->m_radius + radius;
+		RaycastResult3D result;
+		bool isStartInside = grownRange.IsOnRange(start.z) && (start.GetFlattenedXY() - actor->m_position.GetFlattenedXY()).GetLengthSquared() < grownRadius * grownRadius;
+		if (isStartInside)
+		{
+			result.m_didImpact = true;
+			result.m_impactDist = 0.f;
+			result.m_impactPos = start;
+			result.m_impactNormal = -direction;
+		}
+		else
+		{
+			result = RaycastVsCylinderZ3D(start, direction, distance, actor->m_position + Vec3(0.f, 0.f, actor->m_height * .5f), grownRange, grownRadius);
+		}
+
+		if (result.m_didImpact && result.m_impactDist <= closest.m_impactDist)
+		{
+			closest = result;
+			closest.m_rayMaxLength = distance;
+			hit = actor;
+		}
+	}
+	return closest;
+}
+
+int Map::RaycastActorsUntilWall(const Vec3& start, const Vec3& direction, float distance, ActorRaycastHit* out_hits, int maxHits, RaycastResult3D& out_wallResult, Actor* owner) const
+{
+	//Floor and ceiling are planes, so they only cap how far the traversal goes
+	out_wallResult = RaycastWorldZ(start, direction, distance);
+	float maxDist = out_wallResult.m_didImpact ? out_wallResult.m_impactDist : distance;
+	int numHits = 0;
+	if (distance <= 0.f)
+	{
+		return 0;
+	}
+
+	//Walls are always traced; actors only when there is room for hits and a grid to find them in
+	bool isVisitingActors = maxHits > 0 && !m_actorGridCellStarts.GetCells().empty() && m_actorGridCellStarts.GetNumCells() == (m_dimensions.x * m_dimensions.y);
+	if (isVisitingActors)
+	{
+		BeginActorQuery();
+	}
+
+	int tileX = (int)floorf(start.x);
+	int tileY = (int)floorf(start.y);
+	int stepX = (direction.x > 0.f) ? 1 : -1;
+	int stepY = (direction.y > 0.f) ? 1 : -1;
+	float tDeltaX = (direction.x != 0.f) ? fabsf(1.f / direction.x) : 9999999.f;
+	float tDeltaY = (direction.y != 0.f) ? fabsf(1.f / direction.y) : 9999999.f;
+	float tMaxX = (direction.x > 0.f) ? ((float)(tileX + 1) - start.x) * tDeltaX : (start.x - (float)tileX) * tDeltaX;
+	float tMaxY = (direction.y > 0.f) ? ((float)(tileY + 1) - start.y) * tDeltaY : (start.y - (float)tileY) * tDeltaY;
+	float cellEntryDist = 0.f;
+	Vec3 entryNormal = -direction;
+
+	//Walk the tiles along the ray once, testing the actors bucketed in each one until a wall stops it
+	while (cellEntryDist <= maxDist)
+	{
+		bool isInBounds = tileX >= 0 && tileY >= 0 && tileX < m_dimensions.x && tileY < m_dimensions.y;
+		if (isInBounds)
+		{
+			if (IsTileSolid(tileX, tileY))
+			{
+				out_wallResult.m_didImpact = true;
+				out_wallResult.m_impactDist = cellEntryDist;
+				out_wallResult.m_impactPos = start + direction * cellEntryDist;
+				out_wallResult.m_impactNormal = entryNormal;
+				out_wallResult.m_rayMaxLength = distance;
+				maxDist = cellEntryDist;
+				break;
+			}
+
+			if (isVisitingActors)
+			{
+				int firstEntry = m_actorGridCellStarts.Get(tileX, tileY);
+				int endEntry = firstEntry + m_actorGridCellCounts.Get(tileX, tileY);
+				for (int entry = firstEntry; entry < endEntry; entry++)
+				{
+					int slot = m_actorGridEntries[entry];
+					if (m_actorQueryStamps[slot] == m_actorQueryStamp)
+					{
+						continue;
+					}
+					m_actorQueryStamps[slot] = m_actorQueryStamp;
+
+					//Corpses, pickups and actors that don't collide can't use up a penetration slot
+					Actor* actor = m_actors[slot];
+					if (actor == nullptr || actor == owner || actor->m_isDead || actor->m_definition.m_isPickup || !actor->m_definition.m_collisionElement.m_collidesWithActors)
+					{
+						continue;
+					}
+					RaycastResult3D result = RaycastVsCylinderZ3D(start, direction, distance,
+						actor->m_position + Vec3(0.f, 0.f, actor->m_height * .5f),
+						FloatRange(actor->m_position.z, actor->m_position.z + actor->m_height),
+						actor->m_radius);
+					if (!result.m_didImpact || result.m_impactDist > maxDist)
+					{
+						continue;
+					}
+
+					//Insertion into the sorted buffer, dropping the farthest hit once it is full
+					int insertAt = numHits;
+					while (insertAt > 0 && out_hits[insertAt - 1].m_result.m_impactDist > result.m_impactDist)
+					{
+						insertAt--;
+					}
+					if (insertAt < maxHits)
+					{
+						int last = (numHits < maxHits) ? numHits : maxHits - 1;
+						for (int k = last; k > insertAt; k--)
+						{
+							out_hits[k] = out_hits[k - 1];
+						}
+						out_hits[insertAt].m_actor = actor;
+						out_hits[insertAt].m_result = result;
+						if (numHits < maxHits)
+						{
+							numHits++;
+						}
+					}
+				}
+			}
+		}
+		else if ((tileX < 0 && stepX < 0) || (tileX >= m_dimensions.x && stepX > 0) || (tileY < 0 && stepY < 0) || (tileY >= m_dimensions.y && stepY > 0))
+		{
+			break;
+		}
+
+		//Full buffer and every remaining cell starts past the farthest hit
+		if (isVisitingActors && numHits == maxHits && out_hits[numHits - 1].m_result.m_impactDist < cellEntryDist)
+		{
+			break;
+		}
+
+		if (tMaxX < tMaxY)
+		{
+			cellEntryDist = tMaxX;
+			tMaxX += tDeltaX;
+			tileX += stepX;
+			entryNormal = Vec3(-(float)stepX, 0.f, 0.f);
+		}
+		else
+		{
+			cellEntryDist = tMaxY;
+			tMaxY += tDeltaY;
+			tileY += stepY;
+			entryNormal = Vec3(0.f, -(float)stepY, 0.f);
+		}
+	}
+
+	//Actors overlapping into the wall tile can report hits behind it
+	while (numHits > 0 && out_hits[numHits - 1].m_result.m_impactDist > maxDist)
+	{
+		numHits--;
+	}
+	return numHits;
+}
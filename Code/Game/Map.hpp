@@ -1,115 +1,257 @@
-#pragma once
-#include <vector>
-#include "Engine/Math/IntVec2.hpp"
-#include "Engine/Math/RaycastUtils.hpp"
-#include "Engine/Renderer/SpriteSheet.hpp"
-#include "Engine/Renderer/SpriteDefinition.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Game/MapDefinition.hpp"
-#include "Game/Tile.hpp"
-#include "Game/ActorHandle.hpp"
-#include "Engine/Math/EulerAngles.hpp"
-#include "Engine/Core/Vertex_PCUTBN.hpp"
-
-class Tile;
-class Texture;
-class Shader;
-class VertexBuffer;
-class IndexBuffer;
-class ConstantBuffer;
-class MapDefinition;
-class Game;
-class Actor;
-struct AABB3;
-struct AABB2;
-struct Vec3;
-class Player;
-class Actor;
-
-class Map
-{
-public:
-	Map();
-	Map(Game* game, const MapDefinition* definition);
-	~Map();
-
-	//Creation Functions
-	void CreateTiles();
-	void CreateGeometry();
-	void AddGeometryForWall(const AABB3& bounds, const AABB2& UVs, const AABB2& UV2s);
-	void AddGeometryForFloor(const AABB3& bounds, const AABB2& UVs);
-	void AddGeometryForCeiling(const AABB3& bounds, const AABB2& UVs);
-	void CreateSkybox();
-	void CreateBuffers();
-
-	//Actor Functions
-	Actor* SpawnPlayer(Player* possessingPlayer, Vec3 const& location);
-	void   KillPlayer(Player* possessingPlayer);
-	Actor* SpawnActor(const SpawnInfo& spawnInfo);
-	void   KillAIActor(const ActorHandle handle);
-	Actor* GetActorByHandle(const ActorHandle handle) const;
-	void   DeleteDestroyedActors();
-	Actor* GetClosestVisibleEnemy(Actor* searchingActor) const;
-	void   DebugPossessNext();
-
-	//Tile Functions
-	bool		IsPositionInBounds(const Vec3& position) const;
-	IntVec2		GetCoordFromPosition(const Vec3& position) const;
-	bool		AreCoordsInBounds(int x, int y) const;
-	const Tile* GetTile(int x, int y) const;
-
-	//Updates
-	void Update();
-	void UpdateLightBuffer();
-	void UpdateActors();
-	void UpdateAllActorVerts();
-
-	//Renders
-	void Render() const;
-	void RenderActors() const;
-	int  AddPointLightToMap(Vec3 const& location, float intensity, Rgba8 const& color);
-	void ClearPointLights();
-
-	//Events
-	void OnDemonKilled();
-	void OnPlayerKilled();
-
-	//Collision
-	void CollideActors();
-	void CollideActors(Actor* a, Actor* b);
-	void CollideActorsWithMap();
-	void CollideActorWithMap(Actor* a);
-	std::vector<Actor*> GetActorsInSector(Actor* actorReference, float sectorAngle, float radius);
-
-	//Raycasts
-	RaycastResult3D RaycastAll(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner = nullptr) const;
-	RaycastResult3D RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const;
-	RaycastResult3D RaycastWorldZ(const Vec3& start, const Vec3& direction, float distance) const;
-	RaycastResult3D RaycastWorldActors(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner = nullptr) const;
-
-	//Game Management
-	Game* m_game = nullptr;
-	const MapDefinition* m_definition;
-
-	//Skybox Stuff
-	SpriteSheet* m_skyBoxSheet = nullptr;
-	std::vector<Vertex_PCU> m_skyBoxVerts;
-	AABB3		 m_skyBoxLocalBounds = AABB3(Vec3(-35.f, -35.f, -35.f), Vec3(35.f, 35.f, 35.f));
-
-
-protected:
-	std::vector<Tile>		m_tiles;
-	IntVec2					m_dimensions;
-
-	std::vector<Actor*>		m_actors;
-	unsigned int			m_nextActorUID = 0;
-
-	std::vector<Vertex_PCUTBN> m_verts;
-	std::vector<unsigned int> m_vertIndexes;
-	Texture* m_texture = nullptr;
-	Shader* m_shader = nullptr;
-	VertexBuffer* m_vBuffer = nullptr;
-	IndexBuffer* m_iBuffer = nullptr;
-	ConstantBuffer* m_lightBuffer = nullptr;
-	LightConstants m_lightConstants;
+#pragma once
+#include <vector>
+#include <string>
+#include <utility>
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+#include "Engine/Renderer/SpriteDefinition.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/Tile.hpp"
+#include "Game/ActorHandle.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Game/BillboardBatch.hpp"
+#include "Game/MapChunk.hpp"
+#include "Game/Grid.hpp"
+
+class Tile;
+class Texture;
+class Shader;
+class VertexBuffer;
+class IndexBuffer;
+class ConstantBuffer;
+class MapDefinition;
+class Game;
+class Actor;
+struct AABB3;
+struct AABB2;
+struct Vec3;
+class Player;
+class Actor;
+class ProjectileSystem;
+class EffectSystem;
+class DecalSystem;
+class ViewCuller;
+struct CullStats;
+class LightBudget;
+class DistanceField;
+struct LightBudgetStats;
+struct ProjectileSpawnInfo;
+
+struct ExplosionInfo
+{
+	Vec3		m_position = Vec3();
+	float		m_radius = 0.f;
+	float		m_damage = 0.f;
+	float		m_impulse = 0.f;
+	ActorHandle	m_source = ActorHandle::INVALID;
+};
+
+struct ExplosionHit
+{
+	int		m_explosionIndex = -1;
+	Actor*	m_target = nullptr;
+	float	m_falloff = 0.f;
+};
+
+struct ActorRaycastHit
+{
+	Actor*			m_actor = nullptr;
+	RaycastResult3D	m_result;
+};
+
+class Map
+{
+public:
+	Map();
+	Map(Game* game, const MapDefinition* definition, bool isPreloading = false);
+	~Map();
+
+	//Preloading maps defer everything that touches the GPU or the dev console to this, called on the main thread
+	void FinishLoading();
+	void LogMapMessage(std::string const& message);
+
+	//Creation Functions
+	void CreateTiles();
+	void CreateChunkLayout();
+	bool ReadCurrentChunkManifest(std::string const& imageFilePath);
+	bool WriteChunkFiles(Grid<unsigned char> const& tileDefIndexes);
+	void CreateTileDefRemap();
+	void CreateDistanceField();
+	void CreateChunks();
+	void CreateSkybox();
+	void CreateBuffers();
+	MapChunkBuildInput* CreateChunkBuildInput(int chunkIndex) const;
+	void BuildChunksNow(std::vector<int> const& chunkIndexes);
+	void InstallChunkTiles(int chunkIndex, Grid<unsigned char>& tileDefIndexes);
+	void UploadChunk(MapChunkBuildResult const& result);
+
+	//Actor Functions
+	Actor* SpawnPlayer(Player* possessingPlayer, Vec3 const& location);
+	void   KillPlayer(Player* possessingPlayer);
+	Actor* SpawnActor(const SpawnInfo& spawnInfo);
+	bool   SpawnProjectile(const ProjectileSpawnInfo& spawnInfo);
+	void   SpawnEffect(const ActorDefinition* definition, Vec3 const& position);
+	void   AddDecal(const ActorDefinition* definition, Vec3 const& position, Vec3 const& normal);
+	const ActorDefinition* FindActorDefinition(std::string const& name) const;
+	void   KillAIActor(const ActorHandle handle);
+	Actor* GetActorByHandle(const ActorHandle handle) const;
+	void   DeleteDestroyedActors();
+	Actor* GetClosestVisibleEnemy(Actor* searchingActor) const;
+	void   DebugPossessNext();
+
+	//Tile Functions
+	bool		IsPositionInBounds(const Vec3& position) const;
+	IntVec2		GetCoordFromPosition(const Vec3& position) const;
+	bool		AreCoordsInBounds(int x, int y) const;
+	int			GetChunkIndex(int x, int y) const;
+	bool		IsPositionResident(Vec3 const& position) const;
+	const TileDefinition* GetTileDefinition(int x, int y) const;
+	bool		IsTileSolid(int x, int y) const;
+	float		GetWallDistance(Vec2 const& positionXY) const;
+	Vec2		GetWallGradient(Vec2 const& positionXY) const;
+	bool		SetTile(int x, int y, int tileDefIndex);
+	bool		AddVertexFrames(CompactMapMesh const& mesh, std::vector<unsigned char>& out_frameRemap);
+	void		DirtyChunksInArea(IntVec2 const& mins, IntVec2 const& maxs, int ignoreChunkIndex = -1);
+	int			GetBakeMargin() const;
+
+	//Updates
+	void Update();
+	void UpdateChunks();
+	void UpdateStreaming();
+	void LoadChunksNear(Vec3 const& position);
+	void EvictChunk(int chunkIndex);
+	void UpdateLightBuffer();
+	static LightConstants GetBakedLightConstants(LightConstants const& constants);
+	void UpdateActors();
+	void UpdateAllActorVerts(BillboardView const& view);
+	void UpdateLightsForView(BillboardView const& view);
+	CullStats const& GetActorCullStats() const;
+	LightBudgetStats const& GetLightBudgetStats() const;
+
+	//Renders
+	void Render() const;
+	void RenderActors() const;
+	int  AddPointLightToMap(Vec3 const& location, float intensity, Rgba8 const& color);
+	void ClearPointLights();
+
+	//Events
+	void OnDemonKilled();
+	void OnPlayerKilled();
+
+	//Collision
+	void CollideActors();
+	void CollideActors(Actor* a, Actor* b);
+	void CollideActorsWithMap();
+	void CollideActorWithMap(Actor* a);
+	std::vector<Actor*> GetActorsInSector(Actor* actorReference, float sectorAngle, float radius);
+
+	//Spatial Index
+	void BuildActorGrid();
+	bool GetCellRangeForDisc(Vec3 const& center, float radius, IntVec2& out_mins, IntVec2& out_maxs) const;
+	void BeginActorQuery() const;
+	void GetActorsInRadius(Vec3 const& center, float radius, std::vector<Actor*>& out_actors) const;
+	bool IsLineOfSightClearXY(Vec3 const& start, Vec3 const& end) const;
+
+	//Explosions
+	void AddExplosion(ExplosionInfo const& explosion);
+	void ResolveExplosions();
+
+	//Raycasts
+	RaycastResult3D RaycastAll(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner = nullptr) const;
+	RaycastResult3D RaycastWorldXY(const Vec3& start, const Vec3& direction, float distance) const;
+	RaycastResult3D RaycastWorldZ(const Vec3& start, const Vec3& direction, float distance) const;
+	RaycastResult3D RaycastWorldActors(const Vec3& start, const Vec3& direction, float distance, Actor*& hit, Actor* owner = nullptr) const;
+	RaycastResult3D SweepSphereVsWorld(const Vec3& start, const Vec3& direction, float distance, float radius) const;
+	RaycastResult3D SweepSphereVsActors(const Vec3& start, const Vec3& direction, float distance, float radius, Actor*& hit, ActorHandle ignore, ActorHandle alsoIgnore = ActorHandle::INVALID) const;
+	int				RaycastActorsUntilWall(const Vec3& start, const Vec3& direction, float distance, ActorRaycastHit* out_hits, int maxHits, RaycastResult3D& out_wallResult, Actor* owner = nullptr) const;
+
+	//Game Management
+	Game* m_game = nullptr;
+	const MapDefinition* m_definition;
+
+	//Skybox Stuff
+	SpriteSheet* m_skyBoxSheet = nullptr;
+	std::vector<Vertex_PCU> m_skyBoxVerts;
+	AABB3		 m_skyBoxLocalBounds = AABB3(Vec3(-35.f, -35.f, -35.f), Vec3(35.f, 35.f, 35.f));
+
+
+protected:
+	IntVec2					m_dimensions;
+
+	//One byte per tile, patched by SetTile; read by collision, raycasts and the light bake.
+	//Kept for the whole map even when streamed, with unloaded tiles counted as solid.
+	Grid<unsigned char>			m_solidity;
+	DistanceField*				m_distanceField = nullptr;
+
+	std::vector<Actor*>		m_actors;
+	unsigned int			m_nextActorUID = 0;
+
+	//Actor grid: one cell per tile, entries are actor slot indexes for every cell an actor's disc touches.
+	//A cell's entries are the m_actorGridCellCounts entries starting at its m_actorGridCellStarts
+	Grid<int>							m_actorGridCellStarts;
+	Grid<int>							m_actorGridCellCounts;
+	std::vector<int>					m_actorGridEntries;
+	mutable std::vector<unsigned int>	m_actorQueryStamps;
+	mutable unsigned int				m_actorQueryStamp = 0;
+
+	std::vector<ExplosionInfo>	m_pendingExplosions;
+	std::vector<ExplosionInfo>	m_resolvingExplosions;
+	std::vector<ExplosionHit>	m_explosionHits;
+	std::vector<Actor*>			m_explosionCandidates;
+	mutable std::vector<Actor*>	m_sweepCandidates;
+
+	ProjectileSystem*			m_projectiles = nullptr;
+	EffectSystem*				m_effects = nullptr;
+	DecalSystem*				m_decals = nullptr;
+	ViewCuller*					m_viewCuller = nullptr;
+	LightBudget*				m_lightBudget = nullptr;
+	BillboardBatch				m_billboardBatch;
+
+	//Per-view actor verts: the visible list is split across the worker pool and each worker fills its own batch
+	std::vector<Actor*>						m_visibleActors;
+	std::vector<BillboardBatch>				m_workerBatches;
+	std::vector<std::vector<Vertex_PCUTBN>>	m_workerScratchVerts;
+
+	//Static geometry in square chunks of tiles, so a changed tile only rebuilds the chunks it can affect
+	std::vector<MapChunk> m_chunks;
+	IntVec2 m_numChunks;
+	int m_chunkSize = 16;
+	MapChunkBuilder* m_chunkBuilder = nullptr;
+
+	//Streaming: chunks within the view distance of a player load in the background, the farthest beyond it are dropped over the budget
+	bool m_isStreamed = false;
+	MapChunkManifest m_manifest;
+	std::vector<unsigned char> m_tileDefRemap;
+	float m_streamingViewDistance = 48.f;
+	size_t m_streamingBudgetBytes = 0;
+	int m_maxChunkLoads = 4;
+	int m_numChunkLoads = 0;
+	size_t m_residentBytes = 0;
+	std::vector<std::pair<float, int>> m_streamingCandidates;
+	Texture* m_texture = nullptr;
+	Shader* m_shader = nullptr;
+	ConstantBuffer* m_lightBuffer = nullptr;
+	LightConstants m_lightConstants;
+	LightConstants m_uploadedLightConstants;
+	bool m_isLightingBaked = false;
+
+	//Baked chunks already hold sun and ambient in their vertex colours, so they draw with these constants instead;
+	//everything else still gets the real sun and ambient from m_lightBuffer
+	ConstantBuffer* m_bakedLightBuffer = nullptr;
+
+	//Tangent frames shared by every compact chunk, appended as chunks land; a chunk that doesn't fit uploads full vertices
+	Shader* m_compactShader = nullptr;
+	std::vector<MapVertexFrame> m_vertexFrames;
+	ConstantBuffer* m_vertexFrameBuffer = nullptr;
+
+	//Built off the main thread and waiting for FinishLoading
+	bool m_isPreloading = false;
+	std::vector<MapChunkBuildResult> m_pendingUploads;
+	std::vector<std::string> m_pendingMessages;
+
+	//Every light asked for this frame; each view uploads the ones its clusters keep
+	std::vector<PointLight> m_pointLights;
 };
\ No newline at end of file
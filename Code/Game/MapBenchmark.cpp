@@ -0,0 +1,90 @@
+#include "MapBenchmark.hpp"
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/MapGenerator.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include <cstdint>
+#include <cmath>
+
+extern DevConsole* g_theDevConsole;
+
+constexpr int MAP_BENCHMARK_MIN_SIZE = 64;
+constexpr int MAP_BENCHMARK_MAX_WHOLE_SIZE = 1024;
+constexpr int MAP_BENCHMARK_SPAWN_POINTS = 64;
+constexpr float MAP_BENCHMARK_RAY_DISTANCE = 32.f;
+constexpr float MAP_BENCHMARK_SWEEP_RADIUS = .25f;
+
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+void RunMapBenchmarks(Game* game, int maxSize, int numRays, unsigned int seed)
+{
+	maxSize = (maxSize > MAP_BENCHMARK_MIN_SIZE) ? maxSize : MAP_BENCHMARK_MIN_SIZE;
+	numRays = (numRays > 1) ? numRays : 1;
+	g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, Stringf("Map benchmarks: up to %ix%i tiles, %i rays each, seed %u", maxSize, maxSize, numRays, seed));
+
+	for (int size = MAP_BENCHMARK_MIN_SIZE; size <= maxSize; size *= 4)
+	{
+		//Past the whole-map size the map streams: no full distance field or chunk build, only the chunks around the ray origins load.
+		//Sweeps there fall back to tile tests, like any streamed map.
+		bool isStreamed = size > MAP_BENCHMARK_MAX_WHOLE_SIZE;
+		MapGeneratorSettings settings;
+		settings.m_dimensions = IntVec2(size, size);
+		settings.m_seed = seed;
+		settings.m_numSpawnPoints = MAP_BENCHMARK_SPAWN_POINTS;
+		MapDefinition* definition = game->GenerateMap(Stringf("Benchmark%i", size), settings, isStreamed);
+		if (definition == nullptr)
+		{
+			return;
+		}
+
+		//A map deletes its definition along with itself, so it gets a copy of the registered one
+		std::vector<SpawnInfo*> const& origins = definition->m_spawnInfo;
+		double startSeconds = GetCurrentTimeSeconds();
+		Map* map = new Map(game, new MapDefinition(*definition));
+		for (int i = 0; isStreamed && i < (int)origins.size(); i++)
+		{
+			map->LoadChunksNear(origins[i]->m_position);
+		}
+		double loadSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+		//Rays start on the spawn points, which are always open floor, and head off in seeded directions
+		uint32_t state = (seed * 2654435761u) | 1u;
+		int numHits = 0;
+		startSeconds = GetCurrentTimeSeconds();
+		for (int i = 0; i < numRays; i++)
+		{
+			float radians = (float)(NextRandom(state) % 3600u) * (6.2831853f / 3600.f);
+			Vec3 start = origins[NextRandom(state) % (uint32_t)origins.size()]->m_position + Vec3(0.f, 0.f, .5f);
+			RaycastResult3D result = map->RaycastWorldXY(start, Vec3(cosf(radians), sinf(radians), 0.f), MAP_BENCHMARK_RAY_DISTANCE);
+			numHits += result.m_didImpact ? 1 : 0;
+		}
+		double raycastSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+		startSeconds = GetCurrentTimeSeconds();
+		for (int i = 0; i < numRays; i++)
+		{
+			float radians = (float)(NextRandom(state) % 3600u) * (6.2831853f / 3600.f);
+			Vec3 start = origins[NextRandom(state) % (uint32_t)origins.size()]->m_position + Vec3(0.f, 0.f, .5f);
+			RaycastResult3D result = map->SweepSphereVsWorld(start, Vec3(cosf(radians), sinf(radians), 0.f), MAP_BENCHMARK_RAY_DISTANCE, MAP_BENCHMARK_SWEEP_RADIUS);
+			numHits += result.m_didImpact ? 1 : 0;
+		}
+		double sweepSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+		startSeconds = GetCurrentTimeSeconds();
+		delete map;
+		double releaseSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+		g_theDevConsole->AddText(g_theDevConsole->INFO_MAJOR, Stringf("  %5ix%-5i load %9.1f ms  raycast %7.1f ns  sweep %7.1f ns  release %7.1f ms  (%i hits)%s",
+			size, size, loadSeconds * 1000.0, (raycastSeconds * 1e9) / (double)numRays, (sweepSeconds * 1e9) / (double)numRays, releaseSeconds * 1000.0, numHits,
+			isStreamed ? "  streamed" : ""));
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+class Game;
+
+//Generates maps from 64x64 up to maxSize (x4 each step, 4096 by default) with a fixed seed, then times loading each one and casting rays through it.
+//Maps past 1024 are generated and loaded streamed. The generated files stay in the cache as the corpus.
+//Results go to the dev console; run from the "benchmarkmaps" command.
+void RunMapBenchmarks(Game* game, int maxSize, int numRays, unsigned int seed);
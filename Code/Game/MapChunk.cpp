@@ -0,0 +1,253 @@
+#include "MapChunk.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/VertexUtils.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
+#include <cstdint>
+
+constexpr int SECONDARY_WALL_PERCENT = 33;
+
+MapChunkBuilder::MapChunkBuilder()
+{
+	m_thread = std::thread(&MapChunkBuilder::ThreadMain, this);
+}
+
+MapChunkBuilder::~MapChunkBuilder()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_workCondition.notify_all();
+	m_thread.join();
+
+	for (int i = 0; i < (int)m_pending.size(); i++)
+	{
+		delete m_pending[i];
+	}
+	for (int i = 0; i < (int)m_finished.size(); i++)
+	{
+		delete m_finished[i];
+	}
+}
+
+void MapChunkBuilder::BuildChunk(MapChunkBuildInput const& input, MapChunkBuildResult& out_result, WorkerPool* bakePool)
+{
+	out_result.m_chunkIndex = input.m_chunkIndex;
+	out_result.m_version = input.m_version;
+	out_result.m_verts.clear();
+	out_result.m_indexes.clear();
+	out_result.m_compactMesh.Clear();
+	out_result.m_isCompact = false;
+
+	IntVec2 const& chunkDimensions = input.m_tileDefIndexes.GetDimensions();
+	for (int localY = 0; localY < chunkDimensions.y; localY++)
+	{
+		for (int localX = 0; localX < chunkDimensions.x; localX++)
+		{
+			unsigned char tileDefIndex = input.m_tileDefIndexes.Get(localX, localY);
+			if (tileDefIndex == NO_TILE_DEFINITION)
+			{
+				continue;
+			}
+			TileDefinition const& tileDef = *(*input.m_tileDefs)[tileDefIndex];
+			IntVec2 coords = IntVec2(input.m_mins.x + localX, input.m_mins.y + localY);
+			AABB3 bounds = AABB3(Vec3((float)coords.x, (float)coords.y, 0.f), Vec3((float)(coords.x + 1), (float)(coords.y + 1), 1.f));
+			IntVec2 spriteCoords = tileDef.GetWallCoords();
+			if (spriteCoords.x != -1)
+			{
+				AddGeometryForWall(out_result, coords, bounds, input.m_sheet->GetSpriteUVs(spriteCoords), input.m_sheet->GetSpriteUVs(tileDef.GetSecondaryCoords()), input.m_ceilingHeight);
+			}
+
+			spriteCoords = tileDef.GetFloorCoords();
+			if (spriteCoords.x != -1)
+			{
+				AddGeometryForFloor(out_result, bounds, input.m_sheet->GetSpriteUVs(spriteCoords));
+			}
+
+			spriteCoords = tileDef.GetCeilingCoords();
+			if (spriteCoords.x != -1)
+			{
+				AddGeometryForCeiling(out_result, bounds, input.m_sheet->GetSpriteUVs(spriteCoords), input.m_ceilingHeight);
+			}
+		}
+	}
+
+	if (out_result.m_verts.empty())
+	{
+		return;
+	}
+
+	//Same order as the whole-map path: bake first so welding only merges vertices that also lit the same
+	if (input.m_bakeLighting)
+	{
+		LightBaker baker(input.m_solidity, input.m_solidityOrigin, input.m_ceilingHeight);
+		baker.Bake(out_result.m_verts, input.m_sunDirection, input.m_sunIntensity, input.m_ambientIntensity, input.m_staticLights, bakePool);
+		out_result.m_bakeStats = baker.GetStats();
+	}
+	if (input.m_optimizeMesh)
+	{
+		MeshOptimizer optimizer(input.m_vertexCacheSize);
+		optimizer.Optimize(out_result.m_verts, out_result.m_indexes);
+		out_result.m_optimizeStats = optimizer.GetStats();
+	}
+	if (input.m_compactVertices)
+	{
+		out_result.m_isCompact = out_result.m_compactMesh.Encode(out_result.m_verts, Vec3((float)input.m_mins.x, (float)input.m_mins.y, 0.f));
+	}
+}
+
+bool MapChunkBuilder::ReadChunkTiles(std::string const& path, std::vector<unsigned char> const& tileDefRemap, IntVec2 const& chunkDimensions, Grid<unsigned char>& out_tileDefIndexes)
+{
+	if (!ReadMapChunkTiles(path, out_tileDefIndexes) ||
+		out_tileDefIndexes.GetDimensions().x != chunkDimensions.x || out_tileDefIndexes.GetDimensions().y != chunkDimensions.y)
+	{
+		//A missing or damaged chunk loads as open tiles with nothing to draw, rather than leaving a hole the streamer keeps retrying
+		out_tileDefIndexes.Initialize(chunkDimensions, NO_TILE_DEFINITION);
+		return false;
+	}
+
+	//Files index the manifest's definition list
+	for (int localY = 0; localY < chunkDimensions.y; localY++)
+	{
+		for (int localX = 0; localX < chunkDimensions.x; localX++)
+		{
+			unsigned char fileIndex = out_tileDefIndexes.Get(localX, localY);
+			out_tileDefIndexes.Set(localX, localY, (fileIndex < (int)tileDefRemap.size()) ? tileDefRemap[fileIndex] : NO_TILE_DEFINITION);
+		}
+	}
+	return true;
+}
+
+void MapChunkBuilder::LoadAndBuildChunk(MapChunkBuildInput& input, MapChunkBuildResult& out_result, WorkerPool* bakePool)
+{
+	if (input.m_chunkFilePath.empty())
+	{
+		BuildChunk(input, out_result, bakePool);
+		return;
+	}
+
+	IntVec2 chunkDimensions = IntVec2(input.m_maxs.x - input.m_mins.x, input.m_maxs.y - input.m_mins.y);
+	out_result.m_isTileLoad = true;
+	out_result.m_didLoadFail = !ReadChunkTiles(input.m_chunkFilePath, input.m_tileDefRemap, chunkDimensions, input.m_tileDefIndexes);
+
+	//The map still counts the chunk's own tiles as solid until the result lands, so the bake has to see them from here
+	for (int localY = 0; localY < chunkDimensions.y; localY++)
+	{
+		for (int localX = 0; localX < chunkDimensions.x; localX++)
+		{
+			int solidityX = input.m_mins.x + localX - input.m_solidityOrigin.x;
+			int solidityY = input.m_mins.y + localY - input.m_solidityOrigin.y;
+			if (!input.m_solidity.IsInBounds(solidityX, solidityY))
+			{
+				continue;
+			}
+			unsigned char tileDefIndex = input.m_tileDefIndexes.Get(localX, localY);
+			bool isSolid = (tileDefIndex != NO_TILE_DEFINITION) && (*input.m_tileDefs)[tileDefIndex]->GetIsSolid();
+			input.m_solidity.Set(solidityX, solidityY, isSolid ? 1 : 0);
+		}
+	}
+
+	BuildChunk(input, out_result, bakePool);
+	out_result.m_tileDefIndexes = std::move(input.m_tileDefIndexes);
+}
+
+void MapChunkBuilder::Enqueue(MapChunkBuildInput* input)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.push_back(input);
+	}
+	m_workCondition.notify_all();
+}
+
+MapChunkBuildResult* MapChunkBuilder::PopFinished()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_finished.empty())
+	{
+		return nullptr;
+	}
+	MapChunkBuildResult* result = m_finished.front();
+	m_finished.pop_front();
+	return result;
+}
+
+int MapChunkBuilder::GetNumPending() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (int)m_pending.size() + m_numBuilding;
+}
+
+void MapChunkBuilder::AddGeometryForWall(MapChunkBuildResult& result, IntVec2 const& coords, AABB3 const& bounds, AABB2 const& UVs, AABB2 const& UV2s, float ceilingHeight)
+{
+	for (int i = 0; i < (int)ceilingHeight; i++)
+	{
+		AABB2 const& levelUVs = IsSecondaryWallLevel(coords, i) ? UV2s : UVs;
+
+		//Facing -y
+		AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 0, (float)i + 1), bounds.m_mins + Vec3(0, 0, (float)i + 1),
+			Vec3(0, -1, 0), Rgba8::WHITE, levelUVs);
+		//Facing +x
+		AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_mins + Vec3(1, 0, (float)i), bounds.m_mins + Vec3(1, 1, (float)i), bounds.m_maxs + Vec3(0, 0, (float)i), bounds.m_maxs + Vec3(0, -1, (float)i),
+			Vec3(1, 0, 0), Rgba8::WHITE, levelUVs);
+		//Facing +y
+		AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_maxs + Vec3(0, 0, (float)i - 1), bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 1, (float)i + 1), bounds.m_maxs + Vec3(0, 0, (float)i),
+			Vec3(0, 1, 0), Rgba8::WHITE, levelUVs);
+		//Facing -x
+		AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_mins + Vec3(0, 1, (float)i), bounds.m_mins + Vec3(0, 0, (float)i), bounds.m_mins + Vec3(0, 0, (float)i + 1), bounds.m_mins + Vec3(0, 1, (float)i + 1),
+			Vec3(-1, 0, 0), Rgba8::WHITE, levelUVs);
+	}
+}
+
+void MapChunkBuilder::AddGeometryForFloor(MapChunkBuildResult& result, AABB3 const& bounds, AABB2 const& UVs)
+{
+	AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_mins, bounds.m_mins + Vec3(1, 0, 0), bounds.m_maxs + Vec3(0, 0, -1), bounds.m_maxs + Vec3(-1, 0, -1),
+		Vec3(0, 0, 1), Rgba8::WHITE, UVs);
+}
+
+void MapChunkBuilder::AddGeometryForCeiling(MapChunkBuildResult& result, AABB3 const& bounds, AABB2 const& UVs, float ceilingHeight)
+{
+	AddVertsForQuad3D(result.m_verts, result.m_indexes, bounds.m_maxs + Vec3(-1, 0, ceilingHeight - 1), bounds.m_maxs + Vec3(0, 0, ceilingHeight - 1), bounds.m_mins + Vec3(1, 0, ceilingHeight), bounds.m_mins + Vec3(0, 0, ceilingHeight),
+		Vec3(0, 0, -1), Rgba8::WHITE, UVs);
+}
+
+bool MapChunkBuilder::IsSecondaryWallLevel(IntVec2 const& coords, int level)
+{
+	//Hashed from the tile instead of rolled, so a rebuilt chunk keeps its look and builds can run off the main thread
+	uint32_t hash = ((uint32_t)coords.x * 73856093u) ^ ((uint32_t)coords.y * 19349663u) ^ ((uint32_t)level * 83492791u);
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bu;
+	hash ^= hash >> 16;
+	return (int)(hash % 100u) < SECONDARY_WALL_PERCENT;
+}
+
+void MapChunkBuilder::ThreadMain()
+{
+	for (;;)
+	{
+		MapChunkBuildInput* input = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workCondition.wait(lock, [this]() { return !m_pending.empty() || m_isQuitting; });
+			if (m_isQuitting)
+			{
+				break;
+			}
+			input = m_pending.front();
+			m_pending.pop_front();
+			m_numBuilding++;
+		}
+
+		//The pool belongs to the main thread, so background builds bake serially
+		MapChunkBuildResult* result = new MapChunkBuildResult();
+		LoadAndBuildChunk(*input, *result, nullptr);
+		delete input;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_finished.push_back(result);
+			m_numBuilding--;
+		}
+	}
+}
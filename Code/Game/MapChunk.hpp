@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/TileDefinition.hpp"
+#include "Game/Grid.hpp"
+#include "Game/MapChunkFile.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/CompactMapMesh.hpp"
+#include "Game/LightBaker.hpp"
+#include "Game/MeshOptimizer.hpp"
+
+class SpriteSheet;
+class VertexBuffer;
+class IndexBuffer;
+class WorkerPool;
+struct AABB2;
+struct AABB3;
+
+//A square block of tiles with its own buffers, so changing a tile only rebuilds the blocks around it
+struct MapChunk
+{
+	IntVec2			m_mins;
+	IntVec2			m_maxs;
+	VertexBuffer*	m_vertexBuffer = nullptr;
+	IndexBuffer*	m_indexBuffer = nullptr;
+	int				m_numIndexes = 0;
+
+	//Compact chunks hold PCU-layout verts relative to m_mins and draw with the map's compact shader
+	bool			m_isCompact = false;
+
+	//Bumped whenever a tile the chunk's mesh depends on changes; a finished build only lands if it was started from the latest
+	unsigned int	m_version = 0;
+	unsigned int	m_builtVersion = 0;
+	bool			m_isBuilding = false;
+
+	//Tile definition indexes for the chunk's own tiles; empty while a streamed chunk is unloaded
+	Grid<unsigned char>	m_tileDefIndexes;
+	bool			m_isResident = false;
+	size_t			m_numBytes = 0;
+
+	//Chunk files are a cache of the source map, so an edited chunk is pinned resident instead of written back
+	bool			m_isEdited = false;
+};
+
+//Everything a chunk build reads, copied so the map can keep changing while the build runs
+struct MapChunkBuildInput
+{
+	int								m_chunkIndex = 0;
+	unsigned int					m_version = 0;
+	IntVec2							m_mins;
+	IntVec2							m_maxs;
+	Grid<unsigned char>				m_tileDefIndexes;
+	std::vector<TileDefinition*> const*	m_tileDefs = nullptr;
+
+	//Solidity around the chunk out to the bake's reach, with its own origin in map coords
+	Grid<unsigned char>				m_solidity;
+	IntVec2							m_solidityOrigin;
+
+	//Set for streamed chunks that aren't loaded: tiles are read from here first, through the manifest-to-definition remap
+	std::string						m_chunkFilePath;
+	std::vector<unsigned char>		m_tileDefRemap;
+	SpriteSheet const*				m_sheet = nullptr;
+	float							m_ceilingHeight = 1.f;
+
+	bool							m_bakeLighting = true;
+	Vec3							m_sunDirection;
+	float							m_sunIntensity = 0.f;
+	float							m_ambientIntensity = 0.f;
+	std::vector<StaticLightInfo>	m_staticLights;
+	bool							m_optimizeMesh = true;
+	int								m_vertexCacheSize = 16;
+	bool							m_compactVertices = true;
+};
+
+struct MapChunkBuildResult
+{
+	int							m_chunkIndex = 0;
+	unsigned int				m_version = 0;
+	std::vector<Vertex_PCUTBN>	m_verts;
+	std::vector<unsigned int>	m_indexes;
+	CompactMapMesh				m_compactMesh;
+	bool						m_isCompact = false;
+	LightBakeStats				m_bakeStats;
+	MeshOptimizeStats			m_optimizeStats;
+
+	//Tiles read by a load; handed to the chunk when the result lands
+	bool						m_isTileLoad = false;
+	bool						m_didLoadFail = false;
+	Grid<unsigned char>			m_tileDefIndexes;
+};
+
+//Builds chunk meshes: geometry, light bake, cache optimisation and compaction, after reading the tiles from disk for streamed loads.
+//Builds queued here run on one background thread; the map swaps the results in from the main thread.
+class MapChunkBuilder
+{
+public:
+	MapChunkBuilder();
+	~MapChunkBuilder();
+
+	static void				BuildChunk(MapChunkBuildInput const& input, MapChunkBuildResult& out_result, WorkerPool* bakePool);
+	static void				LoadAndBuildChunk(MapChunkBuildInput& input, MapChunkBuildResult& out_result, WorkerPool* bakePool);
+	static bool				ReadChunkTiles(std::string const& path, std::vector<unsigned char> const& tileDefRemap, IntVec2 const& chunkDimensions, Grid<unsigned char>& out_tileDefIndexes);
+
+	void					Enqueue(MapChunkBuildInput* input);
+	MapChunkBuildResult*	PopFinished();
+	int						GetNumPending() const;
+
+private:
+	static void				AddGeometryForWall(MapChunkBuildResult& result, IntVec2 const& coords, AABB3 const& bounds, AABB2 const& UVs, AABB2 const& UV2s, float ceilingHeight);
+	static void				AddGeometryForFloor(MapChunkBuildResult& result, AABB3 const& bounds, AABB2 const& UVs);
+	static void				AddGeometryForCeiling(MapChunkBuildResult& result, AABB3 const& bounds, AABB2 const& UVs, float ceilingHeight);
+	static bool				IsSecondaryWallLevel(IntVec2 const& coords, int level);
+
+	void					ThreadMain();
+
+	std::thread							m_thread;
+	mutable std::mutex					m_mutex;
+	std::condition_variable				m_workCondition;
+	bool								m_isQuitting = false;
+	std::deque<MapChunkBuildInput*>		m_pending;
+	std::deque<MapChunkBuildResult*>	m_finished;
+	int									m_numBuilding = 0;
+};
@@ -0,0 +1,189 @@
+#include "MapChunkFile.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+constexpr uint32_t MAP_CHUNK_MANIFEST_MAGIC = 0x4D434D44;	//"DMCM"
+constexpr uint32_t MAP_CHUNK_TILES_MAGIC = 0x54434D44;		//"DMCT"
+constexpr uint32_t MAP_CHUNK_FILE_VERSION = 1;
+
+template <typename T>
+static void WriteValue(std::ofstream& file, T const& value)
+{
+	file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& out_value)
+{
+	file.read(reinterpret_cast<char*>(&out_value), sizeof(T));
+	return file.good();
+}
+
+static bool ReadHeader(std::ifstream& file, uint32_t expectedMagic)
+{
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	return ReadValue(file, magic) && ReadValue(file, version) && magic == expectedMagic && version == MAP_CHUNK_FILE_VERSION;
+}
+
+std::string GetMapChunkDirectory(std::string const& mapName)
+{
+	return g_gameConfigBlackboard->GetValue("mapChunkDirectory", "Data/Cache/Maps") + "/" + mapName;
+}
+
+std::string GetMapChunkManifestPath(std::string const& mapName)
+{
+	return GetMapChunkDirectory(mapName) + "/Manifest.bin";
+}
+
+std::string GetMapChunkFilePath(std::string const& mapName, IntVec2 const& chunkCoords)
+{
+	return GetMapChunkDirectory(mapName) + "/Chunk_" + std::to_string(chunkCoords.x) + "_" + std::to_string(chunkCoords.y) + ".bin";
+}
+
+bool WriteMapChunkManifest(std::string const& path, MapChunkManifest const& manifest)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	WriteValue(file, MAP_CHUNK_MANIFEST_MAGIC);
+	WriteValue(file, MAP_CHUNK_FILE_VERSION);
+	WriteValue(file, (int32_t)manifest.m_dimensions.x);
+	WriteValue(file, (int32_t)manifest.m_dimensions.y);
+	WriteValue(file, (int32_t)manifest.m_chunkSize);
+	WriteValue(file, (uint32_t)manifest.m_tileDefNames.size());
+	for (int i = 0; i < (int)manifest.m_tileDefNames.size(); i++)
+	{
+		WriteValue(file, (uint32_t)manifest.m_tileDefNames[i].size());
+		file.write(manifest.m_tileDefNames[i].data(), manifest.m_tileDefNames[i].size());
+	}
+	return file.good();
+}
+
+bool ReadMapChunkManifest(std::string const& path, MapChunkManifest& out_manifest)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open() || !ReadHeader(file, MAP_CHUNK_MANIFEST_MAGIC))
+	{
+		return false;
+	}
+	int32_t dimensionsX = 0;
+	int32_t dimensionsY = 0;
+	int32_t chunkSize = 0;
+	uint32_t numNames = 0;
+	if (!ReadValue(file, dimensionsX) || !ReadValue(file, dimensionsY) || !ReadValue(file, chunkSize) || !ReadValue(file, numNames))
+	{
+		return false;
+	}
+	if (dimensionsX <= 0 || dimensionsY <= 0 || chunkSize <= 0 || numNames >= NO_TILE_DEFINITION)
+	{
+		return false;
+	}
+
+	out_manifest.m_dimensions = IntVec2(dimensionsX, dimensionsY);
+	out_manifest.m_chunkSize = chunkSize;
+	out_manifest.m_tileDefNames.resize(numNames);
+	for (uint32_t i = 0; i < numNames; i++)
+	{
+		uint32_t length = 0;
+		if (!ReadValue(file, length) || length > 1024)
+		{
+			return false;
+		}
+		out_manifest.m_tileDefNames[i].resize(length);
+		file.read(&out_manifest.m_tileDefNames[i][0], length);
+	}
+	return file.good();
+}
+
+bool WriteMapChunkTiles(std::string const& path, Grid<unsigned char> const& tileDefIndexes)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	IntVec2 const& dimensions = tileDefIndexes.GetDimensions();
+	WriteValue(file, MAP_CHUNK_TILES_MAGIC);
+	WriteValue(file, MAP_CHUNK_FILE_VERSION);
+	WriteValue(file, (int32_t)dimensions.x);
+	WriteValue(file, (int32_t)dimensions.y);
+
+	//Row by row, so the file doesn't depend on the grid's layout in memory
+	for (int y = 0; y < dimensions.y; y++)
+	{
+		for (int x = 0; x < dimensions.x; x++)
+		{
+			WriteValue(file, tileDefIndexes.Get(x, y));
+		}
+	}
+	return file.good();
+}
+
+bool ReadMapChunkTiles(std::string const& path, Grid<unsigned char>& out_tileDefIndexes)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open() || !ReadHeader(file, MAP_CHUNK_TILES_MAGIC))
+	{
+		return false;
+	}
+	int32_t dimensionsX = 0;
+	int32_t dimensionsY = 0;
+	if (!ReadValue(file, dimensionsX) || !ReadValue(file, dimensionsY) || dimensionsX <= 0 || dimensionsY <= 0)
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> cells(dimensionsX * dimensionsY);
+	file.read(reinterpret_cast<char*>(cells.data()), cells.size());
+	if (!file.good())
+	{
+		return false;
+	}
+	out_tileDefIndexes.Initialize(IntVec2(dimensionsX, dimensionsY), NO_TILE_DEFINITION);
+	for (int y = 0; y < dimensionsY; y++)
+	{
+		for (int x = 0; x < dimensionsX; x++)
+		{
+			out_tileDefIndexes.Set(x, y, cells[(y * dimensionsX) + x]);
+		}
+	}
+	return true;
+}
+
+bool WriteMapChunkFiles(std::string const& mapName, MapChunkManifest const& manifest, Grid<unsigned char> const& tileDefIndexes)
+{
+	std::error_code error;
+	std::filesystem::create_directories(GetMapChunkDirectory(mapName), error);
+
+	IntVec2 numChunks((manifest.m_dimensions.x + manifest.m_chunkSize - 1) / manifest.m_chunkSize, (manifest.m_dimensions.y + manifest.m_chunkSize - 1) / manifest.m_chunkSize);
+	Grid<unsigned char> chunkTiles;
+	for (int chunkY = 0; chunkY < numChunks.y; chunkY++)
+	{
+		for (int chunkX = 0; chunkX < numChunks.x; chunkX++)
+		{
+			IntVec2 mins(chunkX * manifest.m_chunkSize, chunkY * manifest.m_chunkSize);
+			IntVec2 maxs(mins.x + manifest.m_chunkSize, mins.y + manifest.m_chunkSize);
+			maxs.x = (maxs.x < manifest.m_dimensions.x) ? maxs.x : manifest.m_dimensions.x;
+			maxs.y = (maxs.y < manifest.m_dimensions.y) ? maxs.y : manifest.m_dimensions.y;
+			chunkTiles.Initialize(IntVec2(maxs.x - mins.x, maxs.y - mins.y), NO_TILE_DEFINITION);
+			tileDefIndexes.ForEachInRange(mins, maxs, [&chunkTiles, &mins](int x, int y, unsigned char tileDefIndex)
+			{
+				chunkTiles.Set(x - mins.x, y - mins.y, tileDefIndex);
+			});
+			if (!WriteMapChunkTiles(GetMapChunkFilePath(mapName, IntVec2(chunkX, chunkY)), chunkTiles))
+			{
+				return false;
+			}
+		}
+	}
+
+	//Written last, so a split cut short is never mistaken for a complete one
+	return WriteMapChunkManifest(GetMapChunkManifestPath(mapName), manifest);
+}
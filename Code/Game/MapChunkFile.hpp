@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/Grid.hpp"
+
+//Tile definition index for a cell no definition matched, or one not loaded
+constexpr unsigned char NO_TILE_DEFINITION = 255;
+
+//What a split map needs before any chunk loads: its size, how it was cut, and the tile definitions the chunk files index into.
+//Definitions are stored by name so the files survive reordering MapDefinitions.xml.
+struct MapChunkManifest
+{
+	IntVec2						m_dimensions;
+	int							m_chunkSize = 16;
+	std::vector<std::string>	m_tileDefNames;
+};
+
+std::string	GetMapChunkDirectory(std::string const& mapName);
+std::string	GetMapChunkManifestPath(std::string const& mapName);
+std::string	GetMapChunkFilePath(std::string const& mapName, IntVec2 const& chunkCoords);
+
+bool		WriteMapChunkManifest(std::string const& path, MapChunkManifest const& manifest);
+bool		ReadMapChunkManifest(std::string const& path, MapChunkManifest& out_manifest);
+bool		WriteMapChunkTiles(std::string const& path, Grid<unsigned char> const& tileDefIndexes);
+bool		ReadMapChunkTiles(std::string const& path, Grid<unsigned char>& out_tileDefIndexes);
+
+//Cuts a whole map's tiles into the manifest's chunks and writes every file, manifest last
+bool		WriteMapChunkFiles(std::string const& mapName, MapChunkManifest const& manifest, Grid<unsigned char> const& tileDefIndexes);
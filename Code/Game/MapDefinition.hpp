@@ -1,43 +1,63 @@
-#pragma once
-#include <string>
-#include <vector>
-#include "Engine/Math/IntVec2.hpp"
-#include "Engine/Math/EulerAngles.hpp"
-#include "Engine/Math/Vec3.hpp"
-
-class Image;
-class Shader;
-class Texture;
-struct IntVec2;
-
-struct SpawnInfo
-{
-	std::string m_actor = "default spawn";
-	Vec3 m_position = Vec3();
-	EulerAngles m_orientation = EulerAngles();
-	Vec3 m_velocity = Vec3();
-};
-
-class MapDefinition
-{
-public:
-	MapDefinition() :
-		m_name("default"),
-		m_spriteSheetCellCount(IntVec2())
-	{};
-	MapDefinition(std::string const& name, Shader* shader, Texture* sheetTexture, IntVec2 cellCount);
-	~MapDefinition();
-
-	Texture* GetTexture() const;
-	Shader* GetShader() const;
-	std::string GetName() const;
-	IntVec2 GetSpriteCellCount() const;
-
-	std::string m_name;
-	std::string m_skyBoxFilePath;
-	Shader* m_shader = nullptr;
-	Texture* m_spriteSheetTexture = nullptr;
-	IntVec2 m_spriteSheetCellCount;
-	float m_ceilingHeight;
-	std::vector<SpawnInfo*>	m_spawnInfo;
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/Rgba8.hpp"
+
+class Image;
+class Shader;
+class Texture;
+struct IntVec2;
+
+struct SpawnInfo
+{
+	std::string m_actor = "default spawn";
+	Vec3 m_position = Vec3();
+	EulerAngles m_orientation = EulerAngles();
+	Vec3 m_velocity = Vec3();
+};
+
+//A light that never moves, baked into the map's vertex colours
+struct StaticLightInfo
+{
+	Vec3 m_position = Vec3();
+	float m_intensity = .5f;
+	float m_radius = 6.f;
+	Rgba8 m_color = Rgba8::WHITE;
+};
+
+class MapDefinition
+{
+public:
+	MapDefinition() :
+		m_name("default"),
+		m_spriteSheetCellCount(IntVec2())
+	{};
+	MapDefinition(std::string const& name, Shader* shader, Texture* sheetTexture, IntVec2 cellCount);
+	~MapDefinition();
+
+	Texture* GetTexture() const;
+	Shader* GetShader() const;
+	std::string GetName() const;
+	std::string GetImageFilePath() const;
+	IntVec2 GetSpriteCellCount() const;
+
+	std::string m_name;
+	std::string m_skyBoxFilePath;
+	std::string m_shaderName;
+	std::string m_spriteSheetPath;
+	Shader* m_shader = nullptr;
+	Texture* m_spriteSheetTexture = nullptr;
+	IntVec2 m_spriteSheetCellCount;
+	float m_ceilingHeight;
+
+	//Empty for maps from MapDefinitions.xml, which load Data/Maps/<name>.png; generated maps point into the cache
+	std::string m_imageFilePath;
+
+	//Streamed maps keep only the chunks near players loaded, reading them from files split out of the map image
+	bool m_isStreamed = false;
+	std::vector<SpawnInfo*>	m_spawnInfo;
+	std::vector<StaticLightInfo> m_staticLights;
 };
\ No newline at end of file
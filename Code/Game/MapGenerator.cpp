@@ -0,0 +1,478 @@
+#include "MapGenerator.hpp"
+#include "Game/TileDefinition.hpp"
+#include "Game/MapChunkFile.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+static uint32_t NextRandom(uint32_t& state)
+{
+	//xorshift32, kept local so a layout never depends on the game's random state
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static int GetRandomIntInRange(uint32_t& state, int minInclusive, int maxInclusive)
+{
+	if (maxInclusive <= minInclusive)
+	{
+		return minInclusive;
+	}
+	return minInclusive + (int)(NextRandom(state) % (uint32_t)(maxInclusive - minInclusive + 1));
+}
+
+static float GetRandomZeroToOne(uint32_t& state)
+{
+	return (float)(NextRandom(state) >> 8) / 16777216.f;
+}
+
+static IntVec2 GetRoomCenter(GeneratedRoom const& room)
+{
+	return IntVec2((room.m_mins.x + room.m_maxs.x) / 2, (room.m_mins.y + room.m_maxs.y) / 2);
+}
+
+static void CarveCorridorCell(Grid<GeneratedCell>& cells, int x, int y, int width)
+{
+	//The outer ring stays wall so nothing walks off the map
+	IntVec2 const& dimensions = cells.GetDimensions();
+	for (int offsetY = 0; offsetY < width; offsetY++)
+	{
+		for (int offsetX = 0; offsetX < width; offsetX++)
+		{
+			int cellX = x + offsetX;
+			int cellY = y + offsetY;
+			if (cellX > 0 && cellY > 0 && cellX < dimensions.x - 1 && cellY < dimensions.y - 1 && cells.Get(cellX, cellY) == GeneratedCell::WALL)
+			{
+				cells.Set(cellX, cellY, GeneratedCell::CORRIDOR);
+			}
+		}
+	}
+}
+
+static void CarveCorridor(Grid<GeneratedCell>& cells, IntVec2 const& start, IntVec2 const& end, int width, bool isHorizontalFirst)
+{
+	IntVec2 corner = isHorizontalFirst ? IntVec2(end.x, start.y) : IntVec2(start.x, end.y);
+	int stepX = (corner.x > start.x) ? 1 : -1;
+	for (int x = start.x; x != corner.x; x += stepX)
+	{
+		CarveCorridorCell(cells, x, start.y, width);
+	}
+	int stepY = (corner.y > start.y) ? 1 : -1;
+	for (int y = start.y; y != corner.y; y += stepY)
+	{
+		CarveCorridorCell(cells, start.x, y, width);
+	}
+	stepX = (end.x > corner.x) ? 1 : -1;
+	for (int x = corner.x; x != end.x; x += stepX)
+	{
+		CarveCorridorCell(cells, x, corner.y, width);
+	}
+	stepY = (end.y > corner.y) ? 1 : -1;
+	for (int y = corner.y; y != end.y; y += stepY)
+	{
+		CarveCorridorCell(cells, corner.x, y, width);
+	}
+	CarveCorridorCell(cells, end.x, end.y, width);
+}
+
+//Splits [mins, maxs) until each part fits one room, joins the two halves of every split, and returns a room inside the area for its parent to join to.
+//Recursion only goes as deep as the splits, a few hundred calls at worst on the largest maps.
+static int GenerateArea(MapGeneratorSettings const& settings, IntVec2 const& mins, IntVec2 const& maxs, uint32_t& state, GeneratedMap& out_map)
+{
+	//Each area keeps a one-cell wall on every side, so neighbouring rooms are always separated
+	int minAreaSize = settings.m_minRoomSize + 2;
+	int maxAreaSize = settings.m_maxRoomSize + 2;
+	int width = maxs.x - mins.x;
+	int height = maxs.y - mins.y;
+	bool canSplitX = width >= 2 * minAreaSize;
+	bool canSplitY = height >= 2 * minAreaSize;
+	bool shouldSplit = (width > maxAreaSize && canSplitX) || (height > maxAreaSize && canSplitY);
+
+	if (shouldSplit)
+	{
+		bool isSplitX = canSplitX && (!canSplitY || width >= height);
+		int firstRoom = -1;
+		int secondRoom = -1;
+		if (isSplitX)
+		{
+			int splitX = GetRandomIntInRange(state, mins.x + minAreaSize, maxs.x - minAreaSize);
+			firstRoom = GenerateArea(settings, mins, IntVec2(splitX, maxs.y), state, out_map);
+			secondRoom = GenerateArea(settings, IntVec2(splitX, mins.y), maxs, state, out_map);
+		}
+		else
+		{
+			int splitY = GetRandomIntInRange(state, mins.y + minAreaSize, maxs.y - minAreaSize);
+			firstRoom = GenerateArea(settings, mins, IntVec2(maxs.x, splitY), state, out_map);
+			secondRoom = GenerateArea(settings, IntVec2(mins.x, splitY), maxs, state, out_map);
+		}
+		bool isHorizontalFirst = (NextRandom(state) & 1u) != 0u;
+		CarveCorridor(out_map.m_cells, GetRoomCenter(out_map.m_rooms[firstRoom]), GetRoomCenter(out_map.m_rooms[secondRoom]), settings.m_corridorWidth, isHorizontalFirst);
+		return ((NextRandom(state) & 1u) != 0u) ? firstRoom : secondRoom;
+	}
+
+	//A leaf: one room somewhere inside, at least the minimum size where the area allows it
+	int roomWidth = GetRandomIntInRange(state, settings.m_minRoomSize, (width - 2 < settings.m_maxRoomSize) ? width - 2 : settings.m_maxRoomSize);
+	int roomHeight = GetRandomIntInRange(state, settings.m_minRoomSize, (height - 2 < settings.m_maxRoomSize) ? height - 2 : settings.m_maxRoomSize);
+	roomWidth = (roomWidth < width - 2) ? roomWidth : width - 2;
+	roomHeight = (roomHeight < height - 2) ? roomHeight : height - 2;
+	roomWidth = (roomWidth > 1) ? roomWidth : 1;
+	roomHeight = (roomHeight > 1) ? roomHeight : 1;
+
+	GeneratedRoom room;
+	room.m_mins.x = GetRandomIntInRange(state, mins.x + 1, maxs.x - 1 - roomWidth);
+	room.m_mins.y = GetRandomIntInRange(state, mins.y + 1, maxs.y - 1 - roomHeight);
+	room.m_maxs = IntVec2(room.m_mins.x + roomWidth, room.m_mins.y + roomHeight);
+	out_map.m_cells.ForEachInRange(room.m_mins, room.m_maxs, [&out_map](int x, int y, GeneratedCell cell)
+	{
+		UNUSED(cell);
+		out_map.m_cells.Set(x, y, GeneratedCell::ROOM);
+	});
+	out_map.m_rooms.push_back(room);
+	return (int)out_map.m_rooms.size() - 1;
+}
+
+static void PlacePillars(MapGeneratorSettings const& settings, uint32_t& state, GeneratedMap& out_map)
+{
+	//Only odd cells away from the room's edge: every even row and column stays open, so pillars never cut a room or block a doorway
+	for (int i = 0; i < (int)out_map.m_rooms.size(); i++)
+	{
+		GeneratedRoom const& room = out_map.m_rooms[i];
+		for (int y = room.m_mins.y + 1; y < room.m_maxs.y - 1; y += 2)
+		{
+			for (int x = room.m_mins.x + 1; x < room.m_maxs.x - 1; x += 2)
+			{
+				if (GetRandomZeroToOne(state) < settings.m_wallDensity)
+				{
+					out_map.m_cells.Set(x, y, GeneratedCell::PILLAR);
+				}
+			}
+		}
+	}
+}
+
+static void PlaceSpawnPoints(MapGeneratorSettings const& settings, uint32_t& state, GeneratedMap& out_map)
+{
+	//Spread across as many different rooms as there are points, in a seeded shuffle
+	std::vector<int> roomOrder(out_map.m_rooms.size());
+	for (int i = 0; i < (int)roomOrder.size(); i++)
+	{
+		roomOrder[i] = i;
+	}
+	for (int i = (int)roomOrder.size() - 1; i > 0; i--)
+	{
+		int swapIndex = GetRandomIntInRange(state, 0, i);
+		int temp = roomOrder[i];
+		roomOrder[i] = roomOrder[swapIndex];
+		roomOrder[swapIndex] = temp;
+	}
+
+	for (int i = 0; i < settings.m_numSpawnPoints && !roomOrder.empty(); i++)
+	{
+		//Even offsets from the room's corner are never pillars
+		GeneratedRoom const& room = out_map.m_rooms[roomOrder[i % (int)roomOrder.size()]];
+		int x = room.m_mins.x + (2 * GetRandomIntInRange(state, 0, (room.m_maxs.x - room.m_mins.x - 1) / 2));
+		int y = room.m_mins.y + (2 * GetRandomIntInRange(state, 0, (room.m_maxs.y - room.m_mins.y - 1) / 2));
+
+		SpawnInfo spawnPoint;
+		spawnPoint.m_actor = settings.m_spawnActorName;
+		spawnPoint.m_position = Vec3((float)x + .5f, (float)y + .5f, 0.f);
+		spawnPoint.m_orientation = EulerAngles(90.f * (float)GetRandomIntInRange(state, 0, 3), 0.f, 0.f);
+		out_map.m_spawnPoints.push_back(spawnPoint);
+	}
+}
+
+void GenerateMapLayout(MapGeneratorSettings const& settings, GeneratedMap& out_map)
+{
+	MapGeneratorSettings clampedSettings = settings;
+	clampedSettings.m_minRoomSize = (settings.m_minRoomSize > 2) ? settings.m_minRoomSize : 2;
+	clampedSettings.m_maxRoomSize = (settings.m_maxRoomSize > clampedSettings.m_minRoomSize) ? settings.m_maxRoomSize : clampedSettings.m_minRoomSize;
+	clampedSettings.m_corridorWidth = (settings.m_corridorWidth > 1) ? settings.m_corridorWidth : 1;
+	int minDimension = clampedSettings.m_minRoomSize + 2;
+	clampedSettings.m_dimensions.x = (settings.m_dimensions.x > minDimension) ? settings.m_dimensions.x : minDimension;
+	clampedSettings.m_dimensions.y = (settings.m_dimensions.y > minDimension) ? settings.m_dimensions.y : minDimension;
+
+	//xorshift never leaves zero, so the seed is mixed into a state that can't be
+	uint32_t state = (clampedSettings.m_seed * 2654435761u) ^ 0x9E3779B9u;
+	state = (state != 0u) ? state : 1u;
+
+	out_map.m_cells.Initialize(clampedSettings.m_dimensions, GeneratedCell::WALL);
+	out_map.m_rooms.clear();
+	out_map.m_spawnPoints.clear();
+	GenerateArea(clampedSettings, IntVec2(0, 0), clampedSettings.m_dimensions, state, out_map);
+	PlacePillars(clampedSettings, state, out_map);
+	PlaceSpawnPoints(clampedSettings, state, out_map);
+
+	out_map.m_numSolidCells = 0;
+	std::vector<GeneratedCell> const& cells = out_map.m_cells.GetCells();
+	for (int i = 0; i < (int)cells.size(); i++)
+	{
+		out_map.m_numSolidCells += (cells[i] == GeneratedCell::WALL || cells[i] == GeneratedCell::PILLAR) ? 1 : 0;
+	}
+}
+
+static unsigned char FindTileDefIndex(std::vector<TileDefinition*> const& tileDefs, std::string const& name)
+{
+	for (int defIndex = 0; defIndex < (int)tileDefs.size() && defIndex < NO_TILE_DEFINITION; defIndex++)
+	{
+		if (tileDefs[defIndex]->GetName() == name)
+		{
+			return (unsigned char)defIndex;
+		}
+	}
+	return NO_TILE_DEFINITION;
+}
+
+bool GetGeneratedTileDefIndexes(GeneratedMap const& map, MapGeneratorSettings const& settings, std::vector<TileDefinition*> const& tileDefs, Grid<unsigned char>& out_tileDefIndexes)
+{
+	unsigned char cellTileDefIndexes[4];
+	cellTileDefIndexes[(int)GeneratedCell::WALL] = FindTileDefIndex(tileDefs, settings.m_wallTileName);
+	cellTileDefIndexes[(int)GeneratedCell::ROOM] = FindTileDefIndex(tileDefs, settings.m_roomTileName);
+	cellTileDefIndexes[(int)GeneratedCell::CORRIDOR] = FindTileDefIndex(tileDefs, settings.m_corridorTileName);
+	cellTileDefIndexes[(int)GeneratedCell::PILLAR] = FindTileDefIndex(tileDefs, settings.m_pillarTileName);
+	for (int i = 0; i < 4; i++)
+	{
+		if (cellTileDefIndexes[i] == NO_TILE_DEFINITION)
+		{
+			return false;
+		}
+	}
+
+	out_tileDefIndexes.Initialize(map.m_cells.GetDimensions(), NO_TILE_DEFINITION);
+	map.m_cells.ForEachInRange(IntVec2(0, 0), map.m_cells.GetDimensions(), [&out_tileDefIndexes, &cellTileDefIndexes](int x, int y, GeneratedCell cell)
+	{
+		out_tileDefIndexes.Set(x, y, cellTileDefIndexes[(int)cell]);
+	});
+	return true;
+}
+
+//PNG output: the image is palette-indexed with one entry per tile definition, and its single deflate block uses the fixed codes with
+//matches at distance one only. That run-length coding is all a tile map needs, and keeps a 4096x4096 map to a few megabytes.
+struct PngBitWriter
+{
+	std::vector<unsigned char>&	m_bytes;
+	uint32_t					m_bitBuffer = 0;
+	int							m_numBits = 0;
+
+	explicit PngBitWriter(std::vector<unsigned char>& bytes) : m_bytes(bytes) {}
+};
+
+static void WriteBits(PngBitWriter& writer, uint32_t value, int numBits)
+{
+	writer.m_bitBuffer |= value << writer.m_numBits;
+	writer.m_numBits += numBits;
+	while (writer.m_numBits >= 8)
+	{
+		writer.m_bytes.push_back((unsigned char)(writer.m_bitBuffer & 0xFFu));
+		writer.m_bitBuffer >>= 8;
+		writer.m_numBits -= 8;
+	}
+}
+
+static void WriteHuffmanCode(PngBitWriter& writer, uint32_t code, int numBits)
+{
+	//Huffman codes go out most significant bit first, against the rest of the stream
+	uint32_t reversed = 0;
+	for (int i = 0; i < numBits; i++)
+	{
+		reversed = (reversed << 1) | ((code >> i) & 1u);
+	}
+	WriteBits(writer, reversed, numBits);
+}
+
+static void WriteFixedLiteral(PngBitWriter& writer, int symbol)
+{
+	if (symbol <= 143)
+	{
+		WriteHuffmanCode(writer, 0x30u + (uint32_t)symbol, 8);
+	}
+	else if (symbol <= 255)
+	{
+		WriteHuffmanCode(writer, 0x190u + (uint32_t)(symbol - 144), 9);
+	}
+	else if (symbol <= 279)
+	{
+		WriteHuffmanCode(writer, (uint32_t)(symbol - 256), 7);
+	}
+	else
+	{
+		WriteHuffmanCode(writer, 0xC0u + (uint32_t)(symbol - 280), 8);
+	}
+}
+
+constexpr int DEFLATE_LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr int DEFLATE_LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr int DEFLATE_MIN_MATCH = 3;
+constexpr int DEFLATE_MAX_MATCH = 258;
+
+static void WriteRepeatOfPrevious(PngBitWriter& writer, int length)
+{
+	int code = 28;
+	while (DEFLATE_LENGTH_BASES[code] > length)
+	{
+		code--;
+	}
+	WriteFixedLiteral(writer, 257 + code);
+	WriteBits(writer, (uint32_t)(length - DEFLATE_LENGTH_BASES[code]), DEFLATE_LENGTH_EXTRA_BITS[code]);
+	WriteHuffmanCode(writer, 0u, 5);
+}
+
+static void Deflate(std::vector<unsigned char> const& data, std::vector<unsigned char>& out_bytes)
+{
+	//zlib header: deflate with a 32K window, no dictionary
+	out_bytes.push_back(0x78);
+	out_bytes.push_back(0x01);
+
+	PngBitWriter writer(out_bytes);
+	WriteBits(writer, 1u, 1);
+	WriteBits(writer, 1u, 2);
+	int index = 0;
+	while (index < (int)data.size())
+	{
+		int runLength = 0;
+		if (index > 0)
+		{
+			while (runLength < DEFLATE_MAX_MATCH && index + runLength < (int)data.size() && data[index + runLength] == data[index - 1])
+			{
+				runLength++;
+			}
+		}
+		if (runLength >= DEFLATE_MIN_MATCH)
+		{
+			WriteRepeatOfPrevious(writer, runLength);
+			index += runLength;
+		}
+		else
+		{
+			WriteFixedLiteral(writer, data[index]);
+			index++;
+		}
+	}
+	WriteFixedLiteral(writer, 256);
+	if (writer.m_numBits > 0)
+	{
+		writer.m_bytes.push_back((unsigned char)(writer.m_bitBuffer & 0xFFu));
+	}
+
+	uint32_t adlerA = 1;
+	uint32_t adlerB = 0;
+	for (int i = 0; i < (int)data.size(); i++)
+	{
+		adlerA = (adlerA + data[i]) % 65521u;
+		adlerB = (adlerB + adlerA) % 65521u;
+	}
+	uint32_t adler = (adlerB << 16) | adlerA;
+	for (int shift = 24; shift >= 0; shift -= 8)
+	{
+		out_bytes.push_back((unsigned char)((adler >> shift) & 0xFFu));
+	}
+}
+
+static uint32_t GetCrc32(unsigned char const* bytes, size_t numBytes, uint32_t crc = 0xFFFFFFFFu)
+{
+	static uint32_t s_table[256] = {};
+	if (s_table[1] == 0u)
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; bit++)
+			{
+				value = (value & 1u) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+			}
+			s_table[i] = value;
+		}
+	}
+	for (size_t i = 0; i < numBytes; i++)
+	{
+		crc = s_table[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+static void WriteBigEndian(std::ofstream& file, uint32_t value)
+{
+	unsigned char bytes[4] = { (unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value };
+	file.write(reinterpret_cast<char const*>(bytes), 4);
+}
+
+static void WritePngChunk(std::ofstream& file, char const* type, std::vector<unsigned char> const& data)
+{
+	WriteBigEndian(file, (uint32_t)data.size());
+	file.write(type, 4);
+	if (!data.empty())
+	{
+		file.write(reinterpret_cast<char const*>(data.data()), data.size());
+	}
+	uint32_t crc = GetCrc32(reinterpret_cast<unsigned char const*>(type), 4);
+	crc = GetCrc32(data.data(), data.size(), crc);
+	WriteBigEndian(file, crc ^ 0xFFFFFFFFu);
+}
+
+std::string GetGeneratedMapImagePath(std::string const& mapName)
+{
+	return g_gameConfigBlackboard->GetValue("generatedMapDirectory", "Data/Cache/GeneratedMaps") + "/" + mapName + ".png";
+}
+
+bool WriteGeneratedMapImage(std::string const& path, Grid<unsigned char> const& tileDefIndexes, std::vector<TileDefinition*> const& tileDefs)
+{
+	if (tileDefs.empty())
+	{
+		return false;
+	}
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	IntVec2 const& dimensions = tileDefIndexes.GetDimensions();
+	unsigned char const signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+	file.write(reinterpret_cast<char const*>(signature), 8);
+
+	std::vector<unsigned char> header(13, 0);
+	for (int i = 0; i < 4; i++)
+	{
+		header[i] = (unsigned char)(dimensions.x >> (24 - (8 * i)));
+		header[4 + i] = (unsigned char)(dimensions.y >> (24 - (8 * i)));
+	}
+	header[8] = 8;	//Bits per index
+	header[9] = 3;	//Palette colour
+	WritePngChunk(file, "IHDR", header);
+
+	int numColors = ((int)tileDefs.size() < NO_TILE_DEFINITION) ? (int)tileDefs.size() : NO_TILE_DEFINITION;
+	std::vector<unsigned char> palette;
+	for (int defIndex = 0; defIndex < numColors; defIndex++)
+	{
+		Rgba8 color = tileDefs[defIndex]->GetMapPixelColor();
+		palette.push_back(color.r);
+		palette.push_back(color.g);
+		palette.push_back(color.b);
+	}
+	WritePngChunk(file, "PLTE", palette);
+
+	//Map reads the image's first row as y = 0, which is its bottom row once loaded; the top row written here is the map's last
+	std::vector<unsigned char> scanlines;
+	scanlines.reserve((size_t)(dimensions.x + 1) * (size_t)dimensions.y);
+	for (int y = dimensions.y - 1; y >= 0; y--)
+	{
+		scanlines.push_back(0);
+		for (int x = 0; x < dimensions.x; x++)
+		{
+			unsigned char tileDefIndex = tileDefIndexes.Get(x, y);
+			scanlines.push_back((tileDefIndex < numColors) ? tileDefIndex : 0);
+		}
+	}
+	std::vector<unsigned char> compressed;
+	Deflate(scanlines, compressed);
+	WritePngChunk(file, "IDAT", compressed);
+	WritePngChunk(file, "IEND", std::vector<unsigned char>());
+	return file.good();
+}
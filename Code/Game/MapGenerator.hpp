@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/Grid.hpp"
+#include "Game/MapDefinition.hpp"
+
+class TileDefinition;
+
+//What a generated cell is, before it is given a tile definition
+enum class GeneratedCell : unsigned char
+{
+	WALL,
+	ROOM,
+	CORRIDOR,
+	PILLAR
+};
+
+//Everything that shapes a generated map. The same settings always give the same map, on any machine.
+struct MapGeneratorSettings
+{
+	IntVec2			m_dimensions = IntVec2(64, 64);
+	unsigned int	m_seed = 1;
+	int				m_minRoomSize = 4;
+	int				m_maxRoomSize = 12;
+	int				m_corridorWidth = 1;
+	float			m_wallDensity = .1f;	//Chance each pillar slot inside a room is filled
+	int				m_numSpawnPoints = 8;
+	std::string		m_spawnActorName = "SpawnPoint";
+
+	//Tile definitions from TileDefinitions.xml, by name
+	std::string		m_wallTileName = "StoneBrickWall";
+	std::string		m_roomTileName = "StoneFloor";
+	std::string		m_corridorTileName = "StoneBrickFloor";
+	std::string		m_pillarTileName = "MarbleWall";
+};
+
+struct GeneratedRoom
+{
+	IntVec2	m_mins;
+	IntVec2	m_maxs;
+};
+
+struct GeneratedMap
+{
+	Grid<GeneratedCell>			m_cells;
+	std::vector<GeneratedRoom>	m_rooms;
+	std::vector<SpawnInfo>		m_spawnPoints;
+	int							m_numSolidCells = 0;
+};
+
+//Rooms are carved from a binary split of the whole map and joined along the split tree, so every open cell is reachable.
+//Pillars sit on a lattice inside rooms that always leaves a path around them.
+void	GenerateMapLayout(MapGeneratorSettings const& settings, GeneratedMap& out_map);
+
+//False if any of the settings' tile names has no definition
+bool	GetGeneratedTileDefIndexes(GeneratedMap const& map, MapGeneratorSettings const& settings, std::vector<TileDefinition*> const& tileDefs, Grid<unsigned char>& out_tileDefIndexes);
+
+//Generated images live with the other caches, so a generated name can never overwrite a shipped map in Data/Maps
+std::string	GetGeneratedMapImagePath(std::string const& mapName);
+
+//Writes the tiles as the map image Map reads, each texel the tile definition's map colour
+bool	WriteGeneratedMapImage(std::string const& path, Grid<unsigned char> const& tileDefIndexes, std::vector<TileDefinition*> const& tileDefs);
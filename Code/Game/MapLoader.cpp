@@ -0,0 +1,67 @@
+#include "MapLoader.hpp"
+#include "Game/Map.hpp"
+#include "Engine/Core/Time.hpp"
+
+MapLoader::~MapLoader()
+{
+	Cancel();
+}
+
+bool MapLoader::Start(Game* game, MapDefinition* definition)
+{
+	if (IsLoading())
+	{
+		return false;
+	}
+	m_game = game;
+	m_definition = definition;
+	m_isFinished = false;
+	m_thread = std::thread(&MapLoader::ThreadMain, this);
+	return true;
+}
+
+Map* MapLoader::Finish(MapLoadStats& out_stats)
+{
+	if (!IsLoading())
+	{
+		return nullptr;
+	}
+
+	//Usually already done; joining an unfinished load is the wait it was meant to hide
+	double startSeconds = GetCurrentTimeSeconds();
+	m_thread.join();
+	out_stats.m_waitSeconds = GetCurrentTimeSeconds() - startSeconds;
+	out_stats.m_prepareSeconds = m_prepareSeconds;
+
+	startSeconds = GetCurrentTimeSeconds();
+	Map* map = m_map;
+	map->FinishLoading();
+	out_stats.m_uploadSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	m_map = nullptr;
+	m_definition = nullptr;
+	m_isFinished = false;
+	return map;
+}
+
+void MapLoader::Cancel()
+{
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+
+	//Never uploaded, so there are no GPU resources to wait on
+	delete m_map;
+	m_map = nullptr;
+	m_definition = nullptr;
+	m_isFinished = false;
+}
+
+void MapLoader::ThreadMain()
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	m_map = new Map(m_game, m_definition, true);
+	m_prepareSeconds = GetCurrentTimeSeconds() - startSeconds;
+	m_isFinished = true;
+}
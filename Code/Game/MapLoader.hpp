@@ -0,0 +1,39 @@
+#pragma once
+#include <thread>
+#include <atomic>
+
+class Game;
+class Map;
+class MapDefinition;
+
+struct MapLoadStats
+{
+	double	m_prepareSeconds = 0.0;
+	double	m_waitSeconds = 0.0;
+	double	m_uploadSeconds = 0.0;
+};
+
+//Builds the next map on a background thread while the current one keeps running: tiles, distance field, chunk meshes and baked lighting.
+//Finish is the only main-thread part, uploading to the GPU and handing the map over.
+class MapLoader
+{
+public:
+	MapLoader() = default;
+	~MapLoader();
+
+	bool	Start(Game* game, MapDefinition* definition);
+	bool	IsLoading() const	{ return m_thread.joinable(); }
+	bool	IsFinished() const	{ return m_isFinished; }
+	Map*	Finish(MapLoadStats& out_stats);
+	void	Cancel();
+
+private:
+	void	ThreadMain();
+
+	std::thread			m_thread;
+	std::atomic<bool>	m_isFinished { false };
+	Game*				m_game = nullptr;
+	MapDefinition*		m_definition = nullptr;
+	Map*				m_map = nullptr;
+	double				m_prepareSeconds = 0.0;
+};
@@ -0,0 +1,231 @@
+#include "MeshOptimizer.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cstring>
+#include <cstdint>
+
+MeshOptimizer::MeshOptimizer(int cacheSize)
+{
+	m_cacheSize = (cacheSize > 3) ? cacheSize : 3;
+}
+
+void MeshOptimizer::Optimize(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	m_stats = MeshOptimizeStats();
+	m_stats.m_numVertsBefore = (int)verts.size();
+	m_stats.m_numTriangles = (int)indexes.size() / 3;
+	m_stats.m_acmrBefore = ComputeACMR(indexes, (int)verts.size());
+
+	WeldVertices(verts, indexes);
+	OptimizeTriangleOrder(indexes, (int)verts.size());
+	OptimizeVertexFetch(verts, indexes);
+
+	m_stats.m_numVertsAfter = (int)verts.size();
+	m_stats.m_acmrAfter = ComputeACMR(indexes, (int)verts.size());
+	m_stats.m_seconds = GetCurrentTimeSeconds() - startSeconds;
+}
+
+MeshOptimizeStats const& MeshOptimizer::GetStats() const
+{
+	return m_stats;
+}
+
+float MeshOptimizer::ComputeACMR(std::vector<unsigned int> const& indexes, int numVerts) const
+{
+	if (indexes.size() < 3)
+	{
+		return 0.f;
+	}
+
+	//FIFO like the hardware: a hit doesn't refresh the entry
+	std::vector<int> entryTimes(numVerts, -1);
+	int time = 0;
+	int numMisses = 0;
+	for (int i = 0; i < (int)indexes.size(); i++)
+	{
+		int vert = (int)indexes[i];
+		if (entryTimes[vert] < 0 || time - entryTimes[vert] >= m_cacheSize)
+		{
+			entryTimes[vert] = time;
+			time++;
+			numMisses++;
+		}
+	}
+	return (float)numMisses / (float)(indexes.size() / 3);
+}
+
+void MeshOptimizer::WeldVertices(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	//Open-addressed table keyed on the vertex bytes, so only bit-identical vertices merge
+	int tableSize = 1;
+	while (tableSize < (int)verts.size() * 2)
+	{
+		tableSize *= 2;
+	}
+	std::vector<int> table(tableSize, -1);
+	std::vector<unsigned int> remap(verts.size());
+	int numUnique = 0;
+	for (int i = 0; i < (int)verts.size(); i++)
+	{
+		unsigned char const* bytes = (unsigned char const*)&verts[i];
+		uint32_t hash = 2166136261u;
+		for (int b = 0; b < (int)sizeof(Vertex_PCUTBN); b++)
+		{
+			hash = (hash ^ bytes[b]) * 16777619u;
+		}
+
+		int slot = (int)(hash & (uint32_t)(tableSize - 1));
+		while (table[slot] >= 0 && memcmp(&verts[table[slot]], &verts[i], sizeof(Vertex_PCUTBN)) != 0)
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if (table[slot] < 0)
+		{
+			verts[numUnique] = verts[i];
+			table[slot] = numUnique;
+			numUnique++;
+		}
+		remap[i] = (unsigned int)table[slot];
+	}
+
+	verts.resize(numUnique);
+	for (int i = 0; i < (int)indexes.size(); i++)
+	{
+		indexes[i] = remap[indexes[i]];
+	}
+}
+
+void MeshOptimizer::OptimizeTriangleOrder(std::vector<unsigned int>& indexes, int numVerts)
+{
+	int numTriangles = (int)indexes.size() / 3;
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	//Triangles around each vertex, laid out as one array with per-vertex starts
+	m_liveTriangleCounts.assign(numVerts, 0);
+	for (int i = 0; i < numTriangles * 3; i++)
+	{
+		m_liveTriangleCounts[indexes[i]]++;
+	}
+	m_vertTriangleStarts.assign(numVerts + 1, 0);
+	for (int v = 0; v < numVerts; v++)
+	{
+		m_vertTriangleStarts[v + 1] = m_vertTriangleStarts[v] + m_liveTriangleCounts[v];
+	}
+	m_vertTriangles.resize(numTriangles * 3);
+	std::vector<int> cursors(m_vertTriangleStarts.begin(), m_vertTriangleStarts.end() - 1);
+	for (int i = 0; i < numTriangles * 3; i++)
+	{
+		m_vertTriangles[cursors[indexes[i]]++] = i / 3;
+	}
+
+	m_cacheTimes.assign(numVerts, 0);
+	m_isTriangleEmitted.assign(numTriangles, false);
+	m_deadEndStack.clear();
+	m_time = m_cacheSize + 1;
+	m_cursor = 1;
+
+	//Fan out from a vertex, emitting all its live triangles, then move to the candidate that will still be in the cache
+	std::vector<unsigned int> ordered;
+	ordered.reserve(indexes.size());
+	int fanningVertex = 0;
+	while (fanningVertex >= 0)
+	{
+		m_candidates.clear();
+		for (int t = m_vertTriangleStarts[fanningVertex]; t < m_vertTriangleStarts[fanningVertex + 1]; t++)
+		{
+			int triangle = m_vertTriangles[t];
+			if (m_isTriangleEmitted[triangle])
+			{
+				continue;
+			}
+			for (int corner = 0; corner < 3; corner++)
+			{
+				int vert = (int)indexes[(triangle * 3) + corner];
+				ordered.push_back((unsigned int)vert);
+				m_deadEndStack.push_back(vert);
+				m_candidates.push_back(vert);
+				m_liveTriangleCounts[vert]--;
+				if (m_time - m_cacheTimes[vert] > m_cacheSize)
+				{
+					m_cacheTimes[vert] = m_time;
+					m_time++;
+				}
+			}
+			m_isTriangleEmitted[triangle] = true;
+		}
+		fanningVertex = GetNextFanningVertex(numVerts);
+	}
+	indexes.swap(ordered);
+}
+
+int MeshOptimizer::GetNextFanningVertex(int numVerts)
+{
+	//Prefer the candidate that entered the cache earliest but will still be there after its remaining triangles go out
+	int bestVertex = -1;
+	int bestPriority = -1;
+	for (int i = 0; i < (int)m_candidates.size(); i++)
+	{
+		int vert = m_candidates[i];
+		if (m_liveTriangleCounts[vert] <= 0)
+		{
+			continue;
+		}
+		int priority = 0;
+		if (m_time - m_cacheTimes[vert] + (2 * m_liveTriangleCounts[vert]) <= m_cacheSize)
+		{
+			priority = m_time - m_cacheTimes[vert];
+		}
+		if (priority > bestPriority)
+		{
+			bestPriority = priority;
+			bestVertex = vert;
+		}
+	}
+	if (bestVertex >= 0)
+	{
+		return bestVertex;
+	}
+
+	//Dead end: back up through recently used vertices, then sweep forward for anything left
+	while (!m_deadEndStack.empty())
+	{
+		int vert = m_deadEndStack.back();
+		m_deadEndStack.pop_back();
+		if (m_liveTriangleCounts[vert] > 0)
+		{
+			return vert;
+		}
+	}
+	while (m_cursor < numVerts)
+	{
+		int vert = m_cursor;
+		m_cursor++;
+		if (m_liveTriangleCounts[vert] > 0)
+		{
+			return vert;
+		}
+	}
+	return -1;
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	//Number vertices in the order the triangles first touch them; anything never touched drops out
+	std::vector<int> remap(verts.size(), -1);
+	std::vector<Vertex_PCUTBN> ordered;
+	ordered.reserve(verts.size());
+	for (int i = 0; i < (int)indexes.size(); i++)
+	{
+		int vert = (int)indexes[i];
+		if (remap[vert] < 0)
+		{
+			remap[vert] = (int)ordered.size();
+			ordered.push_back(verts[vert]);
+		}
+		indexes[i] = (unsigned int)remap[vert];
+	}
+	verts.swap(ordered);
+}
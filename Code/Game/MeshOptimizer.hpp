@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+struct MeshOptimizeStats
+{
+	int		m_numVertsBefore = 0;
+	int		m_numVertsAfter = 0;
+	int		m_numTriangles = 0;
+	float	m_acmrBefore = 0.f;
+	float	m_acmrAfter = 0.f;
+	double	m_seconds = 0.0;
+};
+
+//Welds identical vertices, reorders triangles for the post-transform cache (Tipsify) and then vertices for fetch order.
+//ACMR is the average number of vertices transformed per triangle against a FIFO cache of the given size.
+class MeshOptimizer
+{
+public:
+	MeshOptimizer(int cacheSize);
+	~MeshOptimizer() = default;
+
+	void						Optimize(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+	MeshOptimizeStats const&	GetStats() const;
+	float						ComputeACMR(std::vector<unsigned int> const& indexes, int numVerts) const;
+
+private:
+	void						WeldVertices(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+	void						OptimizeTriangleOrder(std::vector<unsigned int>& indexes, int numVerts);
+	int							GetNextFanningVertex(int numVerts);
+	void						OptimizeVertexFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+
+	int							m_cacheSize = 16;
+
+	//Tipsify state: triangles around each vertex, how many are still unemitted, and when the vertex last entered the cache
+	std::vector<int>			m_vertTriangleStarts;
+	std::vector<int>			m_vertTriangles;
+	std::vector<int>			m_liveTriangleCounts;
+	std::vector<int>			m_cacheTimes;
+	std::vector<bool>			m_isTriangleEmitted;
+	std::vector<int>			m_deadEndStack;
+	std::vector<int>			m_candidates;
+	int							m_time = 0;
+	int							m_cursor = 0;
+
+	MeshOptimizeStats			m_stats;
+};
@@ -1,378 +1,438 @@
-#include "Player.hpp"
-#include "Game/Game.hpp"
-#include "Engine/Math/EulerAngles.hpp"
-#include "Engine/Input/InputSystem.hpp"
-#include "Engine/Renderer/Camera.hpp"
-#include "Engine/Core/DebugRenderSystem.hpp"
-#include "Engine/Renderer/BitmapFont.hpp"
-
-extern Renderer* g_theRenderer;
-extern InputSystem* g_theInputSystem;
-extern Window* g_theWindow;
-extern BitmapFont* g_testFont;
-
-Player::Player(Game* owner, Vec3 const& startPos)
-{
-	m_game = owner;
-	m_playerCamPosition = startPos;
-
-	m_camera = new Camera();
-	m_camera->SetOrthographicView(Vec2(WORLD_MINS_X, WORLD_MINS_Y), Vec2(WORLD_MAXS_X, WORLD_MAXS_Y));
-	m_camera->SetPerspectiveView(g_theWindow->GetConfig().m_aspectRatio, 60.f, .1f, 100.f);
-	m_camera->SetCameraToRenderTransform(Mat44(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 0.f)));
-}
-
-Player::~Player()
-{
-	m_game = nullptr;
-}
-
-void Player::Update()
-{
-	//Setup ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	float textWidth = 40.f;
-	float HUDHeight = SCREEN_SIZE_Y / 6.f;
-	Vec2 HUDBottomLeft = Vec2(0.f, 0.f);
-	Vec2 HUDBottomRight = Vec2(SCREEN_SIZE_X, 0.f);
-	Vec2 HUDTopLeft = Vec2(0.f, HUDHeight);
-	Vec2 HUDTopRight = Vec2(SCREEN_SIZE_X, HUDHeight);
-
-	//Text ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	m_textVerts.clear();
-	m_verts.clear();
-	std::string health = Stringf("%.f",  m_map->GetActorByHandle(m_possessedActor)->m_health);
-	std::string kills = Stringf("%i", m_kills);
-	std::string deaths = Stringf("%i", m_deaths);
-	std::string ammo;
-	if (GetActor()->m_equippedWeapon && !GetActor()->m_equippedWeapon->m_weaponDef.m_isEnergyBased)
-	{
-		int ammoMag = GetActor()->m_equippedWeapon->m_roundsInMag;
-		int ammoTotal = GetActor()->m_equippedWeapon->m_roundsInBag;
-		ammo = Stringf("%i/%i", ammoMag, ammoTotal);
-		g_testFont->AddVertsForTextInBox2D(m_textVerts, ammo, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
-			Rgba8::WHITE, .6f, Vec2(.5f, .5f));
-	}
-	else if(GetActor()->m_equippedWeapon && GetActor()->m_equippedWeapon->m_cooldownTimer == nullptr)
-	{
-		float currentHeat = GetActor()->m_equippedWeapon->m_heatValue;
-		float maxtHeat = GetActor()->m_equippedWeapon->m_weaponDef.m_maxHeat;
-		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), Rgba8::GRAY);
-		float heatBar = RangeMap(currentHeat, 0.f, maxtHeat, 0.f, (textWidth * 3.f));
-		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + heatBar, (HUDHeight * .5f) + textWidth), Rgba8::BLUE);
-	}
-	else if(GetActor()->m_equippedWeapon)
-	{
-		float fractionOfTimeElapsed = (float)GetActor()->m_equippedWeapon->m_cooldownTimer->GetElapsedFraction();
-		float heatBar = (textWidth * 3.f) * (1.f - fractionOfTimeElapsed);
-		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), Rgba8::GRAY);
-		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + heatBar, (HUDHeight * .5f) + textWidth), Rgba8::RED);
-	}
-
-	//Add Verts ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	g_testFont->AddVertsForTextInBox2D(m_textVerts, health, AABB2(SCREEN_SIZE_X * .27f, HUDHeight * .5f, (SCREEN_SIZE_X * .27f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
-		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
-	g_testFont->AddVertsForTextInBox2D(m_textVerts, kills, AABB2(SCREEN_SIZE_X * .03f, HUDHeight * .5f, (SCREEN_SIZE_X * .03f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
-		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
-	g_testFont->AddVertsForTextInBox2D(m_textVerts, deaths, AABB2(SCREEN_SIZE_X * .9f, HUDHeight * .5f, (SCREEN_SIZE_X * .9f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
-		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
-
-	//Camera ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-	if ((m_map->GetActorByHandle(m_possessedActor)->m_deathTimer)->IsStopped())
-	{
-		HandleInput();
-		UpdateCamera();
-	}
-	else
-	{
-		AddVertsForAABB2D(m_verts, AABB2(0.f, 0.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), Rgba8(180, 180, 180, 80));
-		UpdateCamera();
-	}
-}
-
-void Player::HandleInput()
-{
-	switch (m_currentControlMode)
-	{
-	case ACTOR:
-	{
-		m_playerCamPosition = GetActor()->m_position;
-		DebugAddScreenText(Stringf("FPS: %.2f",(1.f / (float)g_theGameClock->GetDeltaSeconds())), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
-		HandleInputActorMode();
-		break;
-	}
-	}
-}
-
-void Player::HandleInputActorMode()
-{
-	XboxController controller = g_theInputSystem->GetController(0);
-	Vec3 forward;
-	Vec3 left;
-	Vec3 up;
-	m_playerCamOrientation.GetAsVectors_IFwd_JLeft_KUp(forward, left, up);
-	Weapon* weapon = GetActor()->m_equippedWeapon;
-
-	if (m_playerIndex == -1)
-	{
-		//Weapons
-		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_MOUSEWHEEL_DOWN))
-		{
-			GetActor()->CycleWeaponDown();
-		}
-		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_MOUSEWHEEL_UP))
-		{
-			GetActor()->CycleWeaponUp();
-		}
-		if (g_theInputSystem->IsKeyDown(KEYCODE_LMB))
-		{
-			GetActor()->Attack();
-			if (GetActor()->m_equippedWeapon)
-			{
-				GetActor()->m_equippedWeapon->ResetAutoCooldown();
-			}
-			//Check for hold
-			if (!g_theInputSystem->WasKeyJustPressed(KEYCODE_LMB))
-			{
-				if (GetActor()->m_equippedWeapon)
-				{
-					GetActor()->m_equippedWeapon->OnHoldFire();
-				}
-			}
-		}
-		else if (g_theInputSystem->WasKeyJustReleased(KEYCODE_LMB))
-		{
-			if (GetActor()->m_equippedWeapon)
-			{
-				GetActor()->m_equippedWeapon->OnReleaseFire();
-			}
-		}
-		if (g_theInputSystem->IsKeyDown('R'))
-		{
-			weapon->Reload();
-		}
-
-		//Shift to run
-		if (g_theInputSystem->WasKeyJustPressed(KEYCODE_SHIFT))
-		{
-			m_speed = GetActor()->m_definition.m_physicsElement.m_runSpeed;
-		}
-		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_SHIFT))
-		{
-			m_speed = GetActor()->m_definition.m_physicsElement.m_walkSpeed;
-		}
-
-		//Movement
-		if (g_theInputSystem->IsKeyDown('W'))
-		{
-			GetActor()->MoveInDirection(forward.GetFlattenedNormalXY(), m_speed);
-		}
-		if (g_theInputSystem->IsKeyDown('S'))
-		{
-			GetActor()->MoveInDirection(-forward.GetFlattenedNormalXY(), m_speed);
-		}
-		if (g_theInputSystem->IsKeyDown('A'))
-		{
-			GetActor()->MoveInDirection(left.GetFlattenedNormalXY(), m_speed);
-		}
-		if (g_theInputSystem->IsKeyDown('D'))
-		{
-			GetActor()->MoveInDirection(-left.GetFlattenedNormalXY(), m_speed);
-		}
-
-		//Orientation
-		m_playerCamOrientation.m_yawDegrees -= m_lookSpeed * g_theInputSystem->GetCursorClientDelta().x;
-		m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees + m_lookSpeed * g_theInputSystem->GetCursorClientDelta().y, -85.f, 85.f);
-		GetActor()->m_orientation.m_yawDegrees -= m_lookSpeed * g_theInputSystem->GetCursorClientDelta().x;
-		GetActor()->m_orientation.m_pitchDegrees  = GetClamped(m_playerCamOrientation.m_pitchDegrees + m_lookSpeed * g_theInputSystem->GetCursorClientDelta().y, -85.f, 85.f);
-	}
-
-	else if (m_playerIndex == 0)
-	{
-		//Weapons
-		if (controller.WasButtonJustPressed(XBOX_BUTTON_RIGHT_BUMPER))
-		{
-			GetActor()->CycleWeaponDown();
-		}
-		if (controller.WasButtonJustPressed(XBOX_BUTTON_LEFT_BUMPER))
-		{
-			GetActor()->CycleWeaponUp();
-		}
-		if (controller.GetRightTrigger() > .5f)
-		{
-			GetActor()->Attack();
-			if (GetActor()->m_equippedWeapon)
-			{
-				GetActor()->m_equippedWeapon->ResetAutoCooldown();
-			}
-			//Check for hold
-			if (!g_theInputSystem->WasKeyJustPressed(KEYCODE_LMB))
-			{
-				if (GetActor()->m_equippedWeapon)
-				{
-					GetActor()->m_equippedWeapon->OnHoldFire();
-				}
-			}
-		}
-		else if (controller.GetRightTrigger() < .5f)
-		{
-			if (GetActor()->m_equippedWeapon)
-			{
-				GetActor()->m_equippedWeapon->OnReleaseFire();
-			}
-		}
-		if (controller.WasButtonJustPressed(XBOX_BUTTON_X))
-		{
-			weapon->Reload();
-		}
-
-		//Movement
-		if (controller.GetLeftStick().GetPosition().y > 0.6f)
-		{
-			GetActor()->MoveInDirection(forward.GetFlattenedNormalXY(), m_speed);
-		}
-		if (controller.GetLeftStick().GetPosition().y < -0.6f)
-		{
-			GetActor()->MoveInDirection(-forward.GetFlattenedNormalXY(), m_speed);
-		}
-		if (controller.GetLeftStick().GetPosition().x < -0.6f)
-		{
-			GetActor()->MoveInDirection(left.GetFlattenedNormalXY(), m_speed);
-		}
-		if (controller.GetLeftStick().GetPosition().x > 0.6f)
-		{
-			GetActor()->MoveInDirection(-left.GetFlattenedNormalXY(), m_speed);
-		}
-
-		//Shift to run
-		if ((controller.GetButton(XBOX_BUTTON_B).m_wasPressedLastFrame && !controller.GetButton(XBOX_BUTTON_B).m_isPressed))
-		{
-			if (m_speed > GetActor()->m_definition.m_physicsElement.m_walkSpeed)
-			{
-				m_speed = GetActor()->m_definition.m_physicsElement.m_walkSpeed;
-			}
-			else
-			{
-				m_speed = GetActor()->m_definition.m_physicsElement.m_runSpeed;
-			}
-		}
-
-		if (controller.GetRightStick().GetPosition().y > 0.3f)
-		{
-			float adjust = controller.GetRightStick().GetMagnitude() * m_lookSpeed * 1500.f * (float)g_theGameClock->GetDeltaSeconds();
-			m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees - adjust, -85.f, 85.f);
-		}
-		if (controller.GetRightStick().GetPosition().y < -0.3f)
-		{
-			float adjust = controller.GetRightStick().GetMagnitude() * m_lookSpeed * 1500.f * (float)g_theGameClock->GetDeltaSeconds();
-			m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees + adjust, -85.f, 85.f);
-		}
-		if (controller.GetRightStick().GetPosition().x < -0.3f)
-		{
-			m_playerCamOrientation.m_yawDegrees += controller.GetRightStick().GetMagnitude() * m_lookSpeed * 2000.f * (float)g_theGameClock->GetDeltaSeconds();
-		}
-		if (controller.GetRightStick().GetPosition().x > 0.3f)
-		{
-			m_playerCamOrientation.m_yawDegrees -= controller.GetRightStick().GetMagnitude() * m_lookSpeed * 2000.f * (float)g_theGameClock->GetDeltaSeconds();
-		}
-		GetActor()->m_orientation = EulerAngles(m_playerCamOrientation.m_yawDegrees, 0.f, 0.f);
-	}
-
-	m_playerCamPosition = GetActor()->m_position;
-	m_camera->SetPosition(GetActor()->m_position + Vec3(0.f,0.f, GetActor()->m_definition.m_cameraElement.m_eyeHeight));
-	m_camera->SetOrientation(m_playerCamOrientation);
-	m_camera->SetPerspectiveView(g_theWindow->GetConfig().m_aspectRatio, GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees, .1f, 100.f);
-	m_game->m_worldCamera = *m_camera;
-}
-
-void Player::UpdateCamera()
-{
-	if (m_currentControlMode == ControlMode::ACTOR)
-	{
-		float fraction = (float)(m_map->GetActorByHandle(m_possessedActor)->m_deathTimer)->GetElapsedFraction();
-		float height = (1 - fraction) * GetActor()->m_definition.m_cameraElement.m_eyeHeight;
-		m_camera->SetPosition(GetActor()->m_position + Vec3(0.f, 0.f, height));
-		m_camera->SetOrientation(m_playerCamOrientation);
-		float aspect = g_theWindow->GetConfig().m_aspectRatio;
-		if (m_map->m_game->m_nextPlayerIndex > 0)
-		{
-			aspect *= 2.f;
-		}
-		m_camera->SetPerspectiveView(aspect, GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees, .1f, 100.f);
-	}
-	else if (m_currentControlMode == ControlMode::CAMERA)
-	{
-		m_camera->SetPosition(m_playerCamPosition);
-		m_camera->SetOrientation(m_playerCamOrientation);
-		m_camera->SetPerspectiveView(g_theWindow->GetConfig().m_aspectRatio, GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees, .1f, 100.f);
-	}
-}
-
-void Player::Render() const
-{
-	g_theRenderer->BindTexture(&g_testFont->GetTexture());
-	g_theRenderer->DrawVertexArray(m_textVerts);
-
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-Mat44 Player::GetModelToWorldTransform() const
-{
-	Mat44 modelToWorld = Mat44::MakeTranslation3D(m_playerCamPosition);
-	modelToWorld.Append(m_playerCamOrientation.GetAsMatrix_IFwd_JLeft_KUp());
-	return modelToWorld;
-}
-
-void Player::CycleControlMode()
-{
-	if (m_currentControlMode == (ControlMode)((int)(ControlMode::ACTOR)))
-	{
-		m_currentControlMode = ControlMode::CAMERA;
-	}
-	else
-	{
-		m_currentControlMode = (ControlMode)((int)(m_currentControlMode)+1);
-	}
-}
-
-void Player::ResetKillCount()
-{
-	m_kills = 0;
-}
-
-void Player::ResetDeathCount()
-{
-	m_deaths = 0;
-}
-
-void Player::AddKillCount()
-{
-	m_kills++;
-}
-
-void Player::AddDeathCount()
-{
-	m_deaths++;
-}
-
-int Player::GetKillCount() const
-{
-	return m_kills;
-}
-
-int Player::GetDeathCount() const
-{
-	return m_deaths;
-}
-
-float Player::GetActorHealth() const
-{
-	if (GetActor() != nullptr)
-	{
-		return GetActor()->m_health;
-	}
-	else
-	{
-		return 0.f;
-	}
+#include "Player.hpp"
+#include "Game/Game.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Core/DebugRenderSystem.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/ViewCuller.hpp"
+#include "Game/LightBudget.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderThread.hpp"
+#include "Game/FrameArena.hpp"
+
+extern Renderer* g_theRenderer;
+extern InputSystem* g_theInputSystem;
+extern Window* g_theWindow;
+extern BitmapFont* g_testFont;
+
+Player::Player(Game* owner, Vec3 const& startPos)
+{
+	m_game = owner;
+	m_playerCamPosition = startPos;
+
+	m_camera = new Camera();
+	m_camera->SetOrthographicView(Vec2(WORLD_MINS_X, WORLD_MINS_Y), Vec2(WORLD_MAXS_X, WORLD_MAXS_Y));
+	m_camera->SetPerspectiveView(g_theWindow->GetConfig().m_aspectRatio, 60.f, .1f, 100.f);
+	m_camera->SetCameraToRenderTransform(Mat44(Vec3(0.f, 0.f, 1.f), Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 0.f)));
+}
+
+Player::~Player()
+{
+	m_game = nullptr;
+}
+
+void Player::Update()
+{
+	//Setup ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	float textWidth = 40.f;
+	float HUDHeight = SCREEN_SIZE_Y / 6.f;
+	Vec2 HUDBottomLeft = Vec2(0.f, 0.f);
+	Vec2 HUDBottomRight = Vec2(SCREEN_SIZE_X, 0.f);
+	Vec2 HUDTopLeft = Vec2(0.f, HUDHeight);
+	Vec2 HUDTopRight = Vec2(SCREEN_SIZE_X, HUDHeight);
+
+	//Text ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	m_textVerts.clear();
+	m_verts.clear();
+	char const* health = FrameStringf("%.f",  m_map->GetActorByHandle(m_possessedActor)->m_health);
+	char const* kills = FrameStringf("%i", m_kills);
+	char const* deaths = FrameStringf("%i", m_deaths);
+	if (GetActor()->m_equippedWeapon)
+	{
+		GetActor()->m_equippedWeapon->UpdateHUDVerts();
+	}
+	if (GetActor()->m_equippedWeapon && !GetActor()->m_equippedWeapon->m_weaponDef.m_isEnergyBased)
+	{
+		int ammoMag = GetActor()->m_equippedWeapon->m_roundsInMag;
+		int ammoTotal = GetActor()->m_equippedWeapon->m_roundsInBag;
+		char const* ammo = FrameStringf("%i/%i", ammoMag, ammoTotal);
+		g_testFont->AddVertsForTextInBox2D(m_textVerts, ammo, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
+			Rgba8::WHITE, .6f, Vec2(.5f, .5f));
+	}
+	else if(GetActor()->m_equippedWeapon && GetActor()->m_equippedWeapon->m_cooldownTimer == nullptr)
+	{
+		float currentHeat = GetActor()->m_equippedWeapon->m_heatValue;
+		float maxtHeat = GetActor()->m_equippedWeapon->m_weaponDef.m_maxHeat;
+		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), Rgba8::GRAY);
+		float heatBar = RangeMap(currentHeat, 0.f, maxtHeat, 0.f, (textWidth * 3.f));
+		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + heatBar, (HUDHeight * .5f) + textWidth), Rgba8::BLUE);
+	}
+	else if(GetActor()->m_equippedWeapon)
+	{
+		float fractionOfTimeElapsed = (float)GetActor()->m_equippedWeapon->m_cooldownTimer->GetElapsedFraction();
+		float heatBar = (textWidth * 3.f) * (1.f - fractionOfTimeElapsed);
+		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), Rgba8::GRAY);
+		AddVertsForAABB2D(m_verts, AABB2(SCREEN_SIZE_X * .15f, HUDHeight * .5f, (SCREEN_SIZE_X * .15f) + heatBar, (HUDHeight * .5f) + textWidth), Rgba8::RED);
+	}
+
+	//Add Verts ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	g_testFont->AddVertsForTextInBox2D(m_textVerts, health, AABB2(SCREEN_SIZE_X * .27f, HUDHeight * .5f, (SCREEN_SIZE_X * .27f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
+		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
+	g_testFont->AddVertsForTextInBox2D(m_textVerts, kills, AABB2(SCREEN_SIZE_X * .03f, HUDHeight * .5f, (SCREEN_SIZE_X * .03f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
+		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
+	g_testFont->AddVertsForTextInBox2D(m_textVerts, deaths, AABB2(SCREEN_SIZE_X * .9f, HUDHeight * .5f, (SCREEN_SIZE_X * .9f) + (textWidth * 3.f), (HUDHeight * .5f) + textWidth), textWidth,
+		Rgba8::WHITE, 1.f, Vec2(.5f, .5f));
+
+	//Camera ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	if ((m_map->GetActorByHandle(m_possessedActor)->m_deathTimer)->IsStopped())
+	{
+		HandleInput();
+		UpdateCamera();
+	}
+	else
+	{
+		AddVertsForAABB2D(m_verts, AABB2(0.f, 0.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), Rgba8(180, 180, 180, 80));
+		UpdateCamera();
+	}
+}
+
+void Player::HandleInput()
+{
+	switch (m_currentControlMode)
+	{
+	case ACTOR:
+	{
+		m_playerCamPosition = GetActor()->m_position;
+		g_theFrameArena->BeginDebugAllocations();
+		DebugAddScreenText(Stringf("FPS: %.2f",(1.f / (float)g_theGameClock->GetDeltaSeconds())), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		RenderQueueStats const& renderStats = g_theRenderQueue->GetLastFrameStats();
+		DebugAddScreenText(Stringf("Draws: %i  State changes: %i (unsorted %i)", renderStats.m_numDraws, renderStats.m_numStateChanges, renderStats.m_numUnsortedStateChanges), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 2.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		CullStats const& cullStats = m_map->GetActorCullStats();
+		DebugAddScreenText(Stringf("Actors culled: %.0f%% (%i frustum, %i occluded of %i)", cullStats.GetCullRate() * 100.f, cullStats.m_numFrustumCulled, cullStats.m_numOccluded, cullStats.m_numTested), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 3.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 2.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		RenderBackendStats backendStats = g_theRenderBackend->GetLastFrameStats();
+		DebugAddScreenText(Stringf("Backend: %i draws, %i verts, %i state changes, %.1f KB uploaded", backendStats.m_numDraws, backendStats.m_numVertsDrawn, backendStats.m_numStateChanges, (float)backendStats.m_numBytesUploaded / 1024.f), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 4.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 3.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		if (g_theRenderThread != nullptr)
+		{
+			RenderThreadStats threadStats = g_theRenderThread->GetStats();
+			DebugAddScreenText(Stringf("Render thread: %i published, %i drawn, %i skipped, %.1f KB snapshot", threadStats.m_numFramesPublished, threadStats.m_numFramesRendered, threadStats.m_numFramesSkipped, (float)threadStats.m_numBytesCopied / 1024.f), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 5.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 4.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		}
+#if defined(GAME_COUNT_HEAP_ALLOCATIONS)
+		DebugAddScreenText(Stringf("Heap allocs/frame: %i game, %i overlay and console  Frame arena: %.1f KB of %.1f KB", g_theFrameArena->GetLastFrameHeapAllocations(), g_theFrameArena->GetLastFrameDebugHeapAllocations(), (float)g_theFrameArena->GetLastFrameBytesUsed() / 1024.f, (float)g_theFrameArena->GetCapacity() / 1024.f), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 6.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 5.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+#else
+		DebugAddScreenText(Stringf("Frame arena: %.1f KB of %.1f KB", (float)g_theFrameArena->GetLastFrameBytesUsed() / 1024.f, (float)g_theFrameArena->GetCapacity() / 1024.f), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 6.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 5.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+#endif
+		LightBudgetStats const& lightStats = m_map->GetLightBudgetStats();
+		DebugAddScreenText(Stringf("Lights: %i visible of %i, %i uploaded, %i over budget", lightStats.m_numVisible, lightStats.m_numLights, lightStats.m_numUploaded, lightStats.m_numOverBudget), AABB2(SCREEN_SIZE_X - SCREEN_SIZE_X / 2.5, SCREEN_SIZE_Y - 7.f * SCREEN_SIZE_Y / 45.f, SCREEN_SIZE_X, SCREEN_SIZE_Y - 6.f * SCREEN_SIZE_Y / 45.f), SCREEN_SIZE_Y / 45.f, Vec2(0, 1), 0);
+		g_theFrameArena->EndDebugAllocations();
+		HandleInputActorMode();
+		break;
+	}
+	}
+}
+
+void Player::HandleInputActorMode()
+{
+	XboxController controller = g_theInputSystem->GetController(0);
+	Vec3 forward;
+	Vec3 left;
+	Vec3 up;
+	m_playerCamOrientation.GetAsVectors_IFwd_JLeft_KUp(forward, left, up);
+	Weapon* weapon = GetActor()->m_equippedWeapon;
+
+	if (m_playerIndex == -1)
+	{
+		//Weapons
+		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_MOUSEWHEEL_DOWN))
+		{
+			GetActor()->CycleWeaponDown();
+		}
+		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_MOUSEWHEEL_UP))
+		{
+			GetActor()->CycleWeaponUp();
+		}
+		if (g_theInputSystem->IsKeyDown(KEYCODE_LMB))
+		{
+			GetActor()->Attack();
+			if (GetActor()->m_equippedWeapon)
+			{
+				GetActor()->m_equippedWeapon->ResetAutoCooldown();
+			}
+			//Check for hold
+			if (!g_theInputSystem->WasKeyJustPressed(KEYCODE_LMB))
+			{
+				if (GetActor()->m_equippedWeapon)
+				{
+					GetActor()->m_equippedWeapon->OnHoldFire();
+				}
+			}
+		}
+		else if (g_theInputSystem->WasKeyJustReleased(KEYCODE_LMB))
+		{
+			if (GetActor()->m_equippedWeapon)
+			{
+				GetActor()->m_equippedWeapon->OnReleaseFire();
+			}
+		}
+		if (g_theInputSystem->IsKeyDown('R'))
+		{
+			weapon->Reload();
+		}
+
+		//Shift to run
+		if (g_theInputSystem->WasKeyJustPressed(KEYCODE_SHIFT))
+		{
+			m_speed = GetActor()->m_definition.m_physicsElement.m_runSpeed;
+		}
+		if (g_theInputSystem->WasKeyJustReleased(KEYCODE_SHIFT))
+		{
+			m_speed = GetActor()->m_definition.m_physicsElement.m_walkSpeed;
+		}
+
+		//Movement
+		if (g_theInputSystem->IsKeyDown('W'))
+		{
+			GetActor()->MoveInDirection(forward.GetFlattenedNormalXY(), m_speed);
+		}
+		if (g_theInputSystem->IsKeyDown('S'))
+		{
+			GetActor()->MoveInDirection(-forward.GetFlattenedNormalXY(), m_speed);
+		}
+		if (g_theInputSystem->IsKeyDown('A'))
+		{
+			GetActor()->MoveInDirection(left.GetFlattenedNormalXY(), m_speed);
+		}
+		if (g_theInputSystem->IsKeyDown('D'))
+		{
+			GetActor()->MoveInDirection(-left.GetFlattenedNormalXY(), m_speed);
+		}
+
+		//Orientation
+		m_playerCamOrientation.m_yawDegrees -= m_lookSpeed * g_theInputSystem->GetCursorClientDelta().x;
+		m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees + m_lookSpeed * g_theInputSystem->GetCursorClientDelta().y, -85.f, 85.f);
+		GetActor()->m_orientation.m_yawDegrees -= m_lookSpeed * g_theInputSystem->GetCursorClientDelta().x;
+		GetActor()->m_orientation.m_pitchDegrees  = GetClamped(m_playerCamOrientation.m_pitchDegrees + m_lookSpeed * g_theInputSystem->GetCursorClientDelta().y, -85.f, 85.f);
+	}
+
+	else if (m_playerIndex == 0)
+	{
+		//Weapons
+		if (controller.WasButtonJustPressed(XBOX_BUTTON_RIGHT_BUMPER))
+		{
+			GetActor()->CycleWeaponDown();
+		}
+		if (controller.WasButtonJustPressed(XBOX_BUTTON_LEFT_BUMPER))
+		{
+			GetActor()->CycleWeaponUp();
+		}
+		if (controller.GetRightTrigger() > .5f)
+		{
+			GetActor()->Attack();
+			if (GetActor()->m_equippedWeapon)
+			{
+				GetActor()->m_equippedWeapon->ResetAutoCooldown();
+			}
+			//Check for hold
+			if (!g_theInputSystem->WasKeyJustPressed(KEYCODE_LMB))
+			{
+				if (GetActor()->m_equippedWeapon)
+				{
+					GetActor()->m_equippedWeapon->OnHoldFire();
+				}
+			}
+		}
+		else if (controller.GetRightTrigger() < .5f)
+		{
+			if (GetActor()->m_equippedWeapon)
+			{
+				GetActor()->m_equippedWeapon->OnReleaseFire();
+			}
+		}
+		if (controller.WasButtonJustPressed(XBOX_BUTTON_X))
+		{
+			weapon->Reload();
+		}
+
+		//Movement
+		if (controller.GetLeftStick().GetPosition().y > 0.6f)
+		{
+			GetActor()->MoveInDirection(forward.GetFlattenedNormalXY(), m_speed);
+		}
+		if (controller.GetLeftStick().GetPosition().y < -0.6f)
+		{
+			GetActor()->MoveInDirection(-forward.GetFlattenedNormalXY(), m_speed);
+		}
+		if (controller.GetLeftStick().GetPosition().x < -0.6f)
+		{
+			GetActor()->MoveInDirection(left.GetFlattenedNormalXY(), m_speed);
+		}
+		if (controller.GetLeftStick().GetPosition().x > 0.6f)
+		{
+			GetActor()->MoveInDirection(-left.GetFlattenedNormalXY(), m_speed);
+		}
+
+		//Shift to run
+		if ((controller.GetButton(XBOX_BUTTON_B).m_wasPressedLastFrame && !controller.GetButton(XBOX_BUTTON_B).m_isPressed))
+		{
+			if (m_speed > GetActor()->m_definition.m_physicsElement.m_walkSpeed)
+			{
+				m_speed = GetActor()->m_definition.m_physicsElement.m_walkSpeed;
+			}
+			else
+			{
+				m_speed = GetActor()->m_definition.m_physicsElement.m_runSpeed;
+			}
+		}
+
+		if (controller.GetRightStick().GetPosition().y > 0.3f)
+		{
+			float adjust = controller.GetRightStick().GetMagnitude() * m_lookSpeed * 1500.f * (float)g_theGameClock->GetDeltaSeconds();
+			m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees - adjust, -85.f, 85.f);
+		}
+		if (controller.GetRightStick().GetPosition().y < -0.3f)
+		{
+			float adjust = controller.GetRightStick().GetMagnitude() * m_lookSpeed * 1500.f * (float)g_theGameClock->GetDeltaSeconds();
+			m_playerCamOrientation.m_pitchDegrees = GetClamped(m_playerCamOrientation.m_pitchDegrees + adjust, -85.f, 85.f);
+		}
+		if (controller.GetRightStick().GetPosition().x < -0.3f)
+		{
+			m_playerCamOrientation.m_yawDegrees += controller.GetRightStick().GetMagnitude() * m_lookSpeed * 2000.f * (float)g_theGameClock->GetDeltaSeconds();
+		}
+		if (controller.GetRightStick().GetPosition().x > 0.3f)
+		{
+			m_playerCamOrientation.m_yawDegrees -= controller.GetRightStick().GetMagnitude() * m_lookSpeed * 2000.f * (float)g_theGameClock->GetDeltaSeconds();
+		}
+		GetActor()->m_orientation = EulerAngles(m_playerCamOrientation.m_yawDegrees, 0.f, 0.f);
+	}
+
+	m_playerCamPosition = GetActor()->m_position;
+	m_camera->SetPosition(GetActor()->m_position + Vec3(0.f,0.f, GetActor()->m_definition.m_cameraElement.m_eyeHeight));
+	m_camera->SetOrientation(m_playerCamOrientation);
+	m_camera->SetPerspectiveView(g_theWindow->GetConfig().m_aspectRatio, GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees, .1f, 100.f);
+	m_game->m_worldCamera = *m_camera;
+}
+
+void Player::UpdateCamera()
+{
+	if (m_currentControlMode == ControlMode::ACTOR)
+	{
+		float fraction = (float)(m_map->GetActorByHandle(m_possessedActor)->m_deathTimer)->GetElapsedFraction();
+		float height = (1 - fraction) * GetActor()->m_definition.m_cameraElement.m_eyeHeight;
+		m_cameraPosition = GetActor()->m_position + Vec3(0.f, 0.f, height);
+		m_cameraAspect = g_theWindow->GetConfig().m_aspectRatio;
+		if (m_map->m_game->m_nextPlayerIndex > 0)
+		{
+			m_cameraAspect *= 2.f;
+		}
+		m_cameraFOVDegrees = GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees;
+		m_camera->SetPosition(m_cameraPosition);
+		m_camera->SetOrientation(m_playerCamOrientation);
+		m_camera->SetPerspectiveView(m_cameraAspect, m_cameraFOVDegrees, .1f, 100.f);
+	}
+	else if (m_currentControlMode == ControlMode::CAMERA)
+	{
+		m_cameraPosition = m_playerCamPosition;
+		m_cameraAspect = g_theWindow->GetConfig().m_aspectRatio;
+		m_cameraFOVDegrees = GetActor()->m_definition.m_cameraElement.m_cameraFOVDegrees;
+		m_camera->SetPosition(m_cameraPosition);
+		m_camera->SetOrientation(m_playerCamOrientation);
+		m_camera->SetPerspectiveView(m_cameraAspect, m_cameraFOVDegrees, .1f, 100.f);
+	}
+}
+
+void Player::Render() const
+{
+	//Layered above the weapon HUD, text first as before
+	RenderCommand command;
+	command.m_pass = RenderPass::HUD;
+	command.m_depthMode = DepthMode::DISABLED;
+
+	command.m_texture = &g_testFont->GetTexture();
+	command.m_verts = &m_textVerts;
+	command.m_sortDepth = 3.f;
+	g_theRenderQueue->Submit(command);
+
+	command.m_texture = nullptr;
+	command.m_verts = &m_verts;
+	command.m_sortDepth = 4.f;
+	g_theRenderQueue->Submit(command);
+}
+
+Mat44 Player::GetModelToWorldTransform() const
+{
+	Mat44 modelToWorld = Mat44::MakeTranslation3D(m_playerCamPosition);
+	modelToWorld.Append(m_playerCamOrientation.GetAsMatrix_IFwd_JLeft_KUp());
+	return modelToWorld;
+}
+
+BillboardView Player::GetBillboardView() const
+{
+	BillboardView view;
+	view.m_cameraTransform = GetModelToWorldTransform();
+	view.m_cameraPosition = m_cameraPosition;
+	view.m_cameraOrientation = m_playerCamOrientation;
+	view.m_fovDegrees = m_cameraFOVDegrees;
+	view.m_aspect = m_cameraAspect;
+
+	//The possessed actor would fill the screen from inside, so it is only drawn from the free camera
+	if (m_currentControlMode != ControlMode::CAMERA)
+	{
+		view.m_hiddenActor = m_possessedActor;
+	}
+	return view;
+}
+
+void Player::CycleControlMode()
+{
+	if (m_currentControlMode == (ControlMode)((int)(ControlMode::ACTOR)))
+	{
+		m_currentControlMode = ControlMode::CAMERA;
+	}
+	else
+	{
+		m_currentControlMode = (ControlMode)((int)(m_currentControlMode)+1);
+	}
+}
+
+void Player::ResetKillCount()
+{
+	m_kills = 0;
+}
+
+void Player::ResetDeathCount()
+{
+	m_deaths = 0;
+}
+
+void Player::AddKillCount()
+{
+	m_kills++;
+}
+
+void Player::AddDeathCount()
+{
+	m_deaths++;
+}
+
+int Player::GetKillCount() const
+{
+	return m_kills;
+}
+
+int Player::GetDeathCount() const
+{
+	return m_deaths;
+}
+
+float Player::GetActorHealth() const
+{
+	if (GetActor() != nullptr)
+	{
+		return GetActor()->m_health;
+	}
+	else
+	{
+		return 0.f;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "ProjectileSystem.hpp"
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Actor.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/AnimationGroupDefinition.hpp"
+#include "Game/BillboardBatch.hpp"
+
+extern RandomNumberGenerator* g_rng;
+extern NamedStrings* g_gameConfigBlackboard;
+
+ProjectileSystem::ProjectileSystem(Map* map)
+{
+	m_map = map;
+	m_capacity = g_gameConfigBlackboard->GetValue("maxProjectiles", 8192);
+	m_maxFlightSeconds = g_gameConfigBlackboard->GetValue("maxProjectileFlightSeconds", 10.f);
+
+	//Reserve the whole pool up front so firing never allocates
+	m_positions.reserve(m_capacity);
+	m_velocities.reserve(m_capacity);
+	m_radii.reserve(m_capacity);
+	m_ages.reserve(m_capacity);
+	m_isDying.reserve(m_capacity);
+	m_typeIndexes.reserve(m_capacity);
+	m_owners.reserve(m_capacity);
+	m_lastHitActors.reserve(m_capacity);
+	m_explosions.reserve(m_capacity);
+}
+
+ProjectileSystem::~ProjectileSystem()
+{
+	Clear();
+	m_types.clear();
+	m_map = nullptr;
+}
+
+bool ProjectileSystem::SpawnProjectile(ProjectileSpawnInfo const& spawnInfo)
+{
+	if (spawnInfo.m_definition == nullptr || GetNumProjectiles() >= m_capacity)
+	{
+		return false;
+	}
+
+	m_positions.push_back(spawnInfo.m_position);
+	m_velocities.push_back(spawnInfo.m_velocity);
+	m_radii.push_back(spawnInfo.m_definition->m_collisionElement.m_physicsRadius);
+	m_ages.push_back(0.f);
+	m_isDying.push_back(0);
+	m_typeIndexes.push_back(GetOrCreateType(spawnInfo.m_definition));
+	m_owners.push_back(spawnInfo.m_owner);
+	m_lastHitActors.push_back(ActorHandle::INVALID);
+	m_explosions.push_back(spawnInfo.m_explosion);
+	return true;
+}
+
+void ProjectileSystem::Update(float deltaSeconds)
+{
+	int index = 0;
+	while (index < GetNumProjectiles())
+	{
+		ProjectileType const& type = m_types[m_typeIndexes[index]];
+		const ActorDefinition* definition = type.m_definition;
+		m_ages[index] += deltaSeconds;
+
+		if (m_isDying[index])
+		{
+			if (m_ages[index] >= definition->m_corpseLifetime)
+			{
+				Release(index);
+				continue;
+			}
+			m_map->AddPointLightToMap(m_positions[index], .15f, definition->m_color);
+			index++;
+			continue;
+		}
+
+		//A projectile that never hits anything, or has slowed to a stop, doesn't live forever
+		if (m_ages[index] >= m_maxFlightSeconds)
+		{
+			Release(index);
+			continue;
+		}
+
+		Vec3& velocity = m_velocities[index];
+		velocity += (-definition->m_physicsElement.m_drag * velocity) * deltaSeconds;
+		Vec3 displacement = velocity * deltaSeconds;
+		float distance = displacement.GetLength();
+		if (distance > 0.f)
+		{
+			//Sweep the whole step so nothing is skipped regardless of speed
+			Vec3 start = m_positions[index];
+			Vec3 direction = displacement / distance;
+			float radius = m_radii[index];
+
+			RaycastResult3D worldResult;
+			worldResult.m_didImpact = false;
+			if (definition->m_collisionElement.m_collidesWithWorld)
+			{
+				worldResult = m_map->SweepSphereVsWorld(start, direction, distance, radius);
+			}
+
+			Actor* hitActor = nullptr;
+			RaycastResult3D actorResult;
+			actorResult.m_didImpact = false;
+			if (definition->m_collisionElement.m_collidesWithActors)
+			{
+				float actorRange = worldResult.m_didImpact ? worldResult.m_impactDist : distance;
+				//The actor hit last is skipped, so a projectile passing through it only hurts it once
+				actorResult = m_map->SweepSphereVsActors(start, direction, actorRange, radius, hitActor, m_owners[index], m_lastHitActors[index]);
+			}
+
+			if (hitActor != nullptr && actorResult.m_didImpact)
+			{
+				Actor* owner = m_map->GetActorByHandle(m_owners[index]);
+				float damage = g_rng->RollRandomFloatInRange(definition->m_collisionElement.m_damageOnCollide.m_min, definition->m_collisionElement.m_damageOnCollide.m_max);
+				hitActor->TakeDamage(owner, damage);
+				hitActor->AddImpulse(direction * definition->m_collisionElement.m_impulseOnCollide);
+				m_lastHitActors[index] = hitActor->m_handle;
+				if (definition->m_collisionElement.m_dieOnCollision)
+				{
+					StartDeath(index, actorResult.m_impactPos, actorResult.m_impactNormal);
+					index++;
+					continue;
+				}
+			}
+
+			if (worldResult.m_didImpact)
+			{
+				if (definition->m_collisionElement.m_dieOnCollision)
+				{
+					StartDeath(index, worldResult.m_impactPos, worldResult.m_impactNormal);
+					index++;
+					continue;
+				}
+
+				//Stop at the wall and lose the speed going into it, the way actors are pushed out of walls
+				m_positions[index] = worldResult.m_impactPos;
+				float speedIntoWall = DotProduct3D(velocity, worldResult.m_impactNormal);
+				if (speedIntoWall < 0.f)
+				{
+					velocity -= worldResult.m_impactNormal * speedIntoWall;
+				}
+			}
+			else
+			{
+				m_positions[index] = start + displacement;
+			}
+			if (!m_map->IsPositionInBounds(m_positions[index]))
+			{
+				Release(index);
+				continue;
+			}
+		}
+
+		m_map->AddPointLightToMap(m_positions[index], .15f, definition->m_color);
+		index++;
+	}
+}
+
+void ProjectileSystem::UpdateVerts(Mat44 const& cameraTransform, BillboardBatch& batch) const
+{
+	for (int index = 0; index < GetNumProjectiles(); index++)
+	{
+		ProjectileType const& projectileType = m_types[m_typeIndexes[index]];
+		AnimationGroupDefinition* animation = m_isDying[index] ? projectileType.m_deathAnimation : projectileType.m_flyingAnimation;
+		if (animation == nullptr || animation->m_directionAnims.empty())
+		{
+			continue;
+		}
+
+		SpriteDefinition sprite = animation->m_directionAnims[0].m_animation->GetSpriteDefAtTime(m_ages[index]);
+		batch.AddBillboard(projectileType.m_definition, cameraTransform, m_positions[index], sprite.GetUVs(), Rgba8::WHITE);
+	}
+}
+
+void ProjectileSystem::Clear()
+{
+	m_positions.clear();
+	m_velocities.clear();
+	m_radii.clear();
+	m_ages.clear();
+	m_isDying.clear();
+	m_typeIndexes.clear();
+	m_owners.clear();
+	m_lastHitActors.clear();
+	m_explosions.clear();
+}
+
+int ProjectileSystem::GetNumProjectiles() const
+{
+	return (int)m_positions.size();
+}
+
+int ProjectileSystem::GetOrCreateType(const ActorDefinition* definition)
+{
+	for (int i = 0; i < (int)m_types.size(); i++)
+	{
+		if (m_types[i].m_definition == definition)
+		{
+			return i;
+		}
+	}
+
+	ProjectileType type;
+	type.m_definition = definition;
+	type.m_flyingAnimation = definition->GetGroupDefinition("Walk");
+	type.m_deathAnimation = definition->GetGroupDefinition("Death");
+	if (type.m_flyingAnimation == nullptr && !definition->m_VisualElement.m_groupDefinitions.empty())
+	{
+		type.m_flyingAnimation = definition->m_VisualElement.m_groupDefinitions[0];
+	}
+	m_types.push_back(type);
+	return (int)m_types.size() - 1;
+}
+
+void ProjectileSystem::StartDeath(int index, Vec3 const& impactPosition, Vec3 const& impactNormal)
+{
+	m_positions[index] = impactPosition;
+	m_velocities[index] = Vec3();
+	m_ages[index] = 0.f;
+	m_isDying[index] = 1;
+
+	if (m_explosions[index].m_radius > 0.f)
+	{
+		ExplosionInfo explosion = m_explosions[index];
+		explosion.m_position = impactPosition + impactNormal * .01f;
+		explosion.m_source = m_owners[index];
+		m_map->AddExplosion(explosion);
+	}
+}
+
+void ProjectileSystem::Release(int index)
+{
+	int last = GetNumProjectiles() - 1;
+	if (index != last)
+	{
+		m_positions[index] = m_positions[last];
+		m_velocities[index] = m_velocities[last];
+		m_radii[index] = m_radii[last];
+		m_ages[index] = m_ages[last];
+		m_isDying[index] = m_isDying[last];
+		m_typeIndexes[index] = m_typeIndexes[last];
+		m_owners[index] = m_owners[last];
+		m_lastHitActors[index] = m_lastHitActors[last];
+		m_explosions[index] = m_explosions[last];
+	}
+	m_positions.pop_back();
+	m_velocities.pop_back();
+	m_radii.pop_back();
+	m_ages.pop_back();
+	m_isDying.pop_back();
+	m_typeIndexes.pop_back();
+	m_owners.pop_back();
+	m_lastHitActors.pop_back();
+	m_explosions.pop_back();
+}
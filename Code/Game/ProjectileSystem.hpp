@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Game/ActorHandle.hpp"
+#include "Game/Map.hpp"
+
+class Map;
+class BillboardBatch;
+class ActorDefinition;
+class AnimationGroupDefinition;
+
+struct ProjectileSpawnInfo
+{
+	const ActorDefinition*	m_definition = nullptr;
+	Vec3					m_position = Vec3();
+	Vec3					m_velocity = Vec3();
+	ActorHandle				m_owner = ActorHandle::INVALID;
+	ExplosionInfo			m_explosion;
+};
+
+struct ProjectileType
+{
+	const ActorDefinition*		m_definition = nullptr;
+	AnimationGroupDefinition*	m_flyingAnimation = nullptr;
+	AnimationGroupDefinition*	m_deathAnimation = nullptr;
+};
+
+class ProjectileSystem
+{
+public:
+	ProjectileSystem(Map* map);
+	~ProjectileSystem();
+
+	bool SpawnProjectile(ProjectileSpawnInfo const& spawnInfo);
+	void Update(float deltaSeconds);
+	void UpdateVerts(Mat44 const& cameraTransform, BillboardBatch& batch) const;
+	void Clear();
+	int  GetNumProjectiles() const;
+
+private:
+	int  GetOrCreateType(const ActorDefinition* definition);
+	void StartDeath(int index, Vec3 const& impactPosition, Vec3 const& impactNormal);
+	void Release(int index);
+
+	Map*							m_map = nullptr;
+	int								m_capacity = 0;
+	float							m_maxFlightSeconds = 0.f;
+
+	//Packed SoA state; index [0, size) is always live, removal swaps the last projectile into the hole
+	std::vector<Vec3>				m_positions;
+	std::vector<Vec3>				m_velocities;
+	std::vector<float>				m_radii;
+	std::vector<float>				m_ages;
+	std::vector<unsigned char>		m_isDying;
+	std::vector<int>				m_typeIndexes;
+	std::vector<ActorHandle>		m_owners;
+	std::vector<ActorHandle>		m_lastHitActors;
+	std::vector<ExplosionInfo>		m_explosions;
+
+	std::vector<ProjectileType>	m_types;
+};
@@ -0,0 +1,210 @@
+#include "RecordingRenderBackend.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <fstream>
+#include <filesystem>
+
+void RecordingRenderBackend::BeginFrame()
+{
+	RenderBackend::BeginFrame();
+	{
+		//dumpdraws reads the last frame from the main thread while a render thread may be rolling it over
+		std::lock_guard<std::mutex> lock(m_lastFrameMutex);
+		m_lastFrameDraws.swap(m_frameDraws);
+	}
+	m_frameDraws.clear();
+}
+
+VertexBuffer* RecordingRenderBackend::CreateVertexBuffer(unsigned int size, unsigned int stride)
+{
+	UNUSED(size);
+	UNUSED(stride);
+	CountBufferCreated();
+	return nullptr;
+}
+
+IndexBuffer* RecordingRenderBackend::CreateIndexBuffer(unsigned int numIndexes)
+{
+	UNUSED(numIndexes);
+	CountBufferCreated();
+	return nullptr;
+}
+
+ConstantBuffer* RecordingRenderBackend::CreateConstantBuffer(unsigned int size)
+{
+	UNUSED(size);
+	CountBufferCreated();
+	return nullptr;
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(Vertex_PCUTBN const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer)
+{
+	UNUSED(verts);
+	UNUSED(vertexBuffer);
+	CountBytesUploaded(numVerts * (unsigned int)sizeof(Vertex_PCUTBN));
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(unsigned int const* indexes, unsigned int numIndexes, IndexBuffer* indexBuffer)
+{
+	UNUSED(indexes);
+	UNUSED(indexBuffer);
+	CountBytesUploaded(numIndexes * (unsigned int)sizeof(unsigned int));
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* constantBuffer)
+{
+	UNUSED(data);
+	UNUSED(constantBuffer);
+	CountBytesUploaded(size);
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(Vertex_PCU const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer)
+{
+	UNUSED(verts);
+	UNUSED(vertexBuffer);
+	CountBytesUploaded(numVerts * (unsigned int)sizeof(Vertex_PCU));
+}
+
+void RecordingRenderBackend::BeginCamera(Camera const& camera)
+{
+	UNUSED(camera);
+}
+
+void RecordingRenderBackend::EndCamera(Camera const& camera)
+{
+	UNUSED(camera);
+}
+
+void RecordingRenderBackend::BindTexture(const Texture* texture)
+{
+	CountTextureChange(texture);
+	m_currentState.m_texture = texture;
+}
+
+void RecordingRenderBackend::BindShader(Shader* shader)
+{
+	CountShaderChange(shader);
+	m_currentState.m_shader = shader;
+}
+
+void RecordingRenderBackend::SetBlendMode(BlendMode blendMode)
+{
+	CountBlendModeChange(blendMode);
+	m_currentState.m_blendMode = blendMode;
+}
+
+void RecordingRenderBackend::SetRasterizerMode(RasterizerMode rasterizerMode)
+{
+	CountRasterizerModeChange(rasterizerMode);
+}
+
+void RecordingRenderBackend::SetDepthMode(DepthMode depthMode)
+{
+	CountDepthModeChange(depthMode);
+	m_currentState.m_depthMode = depthMode;
+}
+
+void RecordingRenderBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	CountSamplerModeChange(samplerMode);
+}
+
+void RecordingRenderBackend::SetStatesIfChanged()
+{
+}
+
+void RecordingRenderBackend::SetModelConstants(Mat44 const& modelTransform, Rgba8 const& modelColor)
+{
+	CountModelConstantsChange(modelTransform, modelColor);
+}
+
+void RecordingRenderBackend::BindLightBuffer(ConstantBuffer* lightBuffer)
+{
+	CountLightBufferChange(lightBuffer);
+}
+
+void RecordingRenderBackend::BindVertexFrameBuffer(ConstantBuffer* vertexFrameBuffer)
+{
+	CountVertexFrameBufferChange(vertexFrameBuffer);
+}
+
+void RecordingRenderBackend::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	RecordDraw(RecordedDrawType::VERTEX_ARRAY, (int)verts.size());
+}
+
+void RecordingRenderBackend::DrawVertexBuffer(VertexBuffer* vertexBuffer, int numVerts)
+{
+	UNUSED(vertexBuffer);
+	RecordDraw(RecordedDrawType::VERTEX_BUFFER, numVerts);
+}
+
+void RecordingRenderBackend::DrawLitIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, ConstantBuffer* lightBuffer, int numIndexes)
+{
+	UNUSED(vertexBuffer);
+	UNUSED(indexBuffer);
+	UNUSED(lightBuffer);
+	RecordDraw(RecordedDrawType::LIT_INDEX_BUFFER, numIndexes);
+}
+
+std::vector<RecordedDraw> RecordingRenderBackend::GetLastFrameDraws() const
+{
+	std::lock_guard<std::mutex> lock(m_lastFrameMutex);
+	return m_lastFrameDraws;
+}
+
+bool RecordingRenderBackend::WriteLastFrameDraws(std::string const& path, int& out_numDraws) const
+{
+	std::vector<RecordedDraw> draws = GetLastFrameDraws();
+	out_numDraws = (int)draws.size();
+
+	std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+	}
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	static char const* const DRAW_TYPE_NAMES[] = { "VertexArray", "VertexBuffer", "LitIndexBuffer" };
+	std::vector<const void*> resources;
+	for (int i = 0; i < (int)draws.size(); i++)
+	{
+		RecordedDraw const& draw = draws[i];
+		int ids[2] = { -1, -1 };
+		const void* drawResources[2] = { draw.m_texture, draw.m_shader };
+		for (int r = 0; r < 2; r++)
+		{
+			if (drawResources[r] == nullptr)
+			{
+				continue;
+			}
+			int id = 0;
+			while (id < (int)resources.size() && resources[id] != drawResources[r])
+			{
+				id++;
+			}
+			if (id == (int)resources.size())
+			{
+				resources.push_back(drawResources[r]);
+			}
+			ids[r] = id;
+		}
+		file << DRAW_TYPE_NAMES[(int)draw.m_type] << " texture=" << ids[0] << " shader=" << ids[1] << " blend=" << (int)draw.m_blendMode
+			<< " depth=" << (int)draw.m_depthMode << " count=" << draw.m_count << "\n";
+	}
+	return file.good();
+}
+
+void RecordingRenderBackend::RecordDraw(RecordedDrawType type, int count)
+{
+	CountDraw(count);
+
+	RecordedDraw draw = m_currentState;
+	draw.m_type = type;
+	draw.m_count = count;
+	m_frameDraws.push_back(draw);
+}
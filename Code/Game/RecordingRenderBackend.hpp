@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include "Game/RenderBackend.hpp"
+
+enum class RecordedDrawType : unsigned char
+{
+	VERTEX_ARRAY,
+	VERTEX_BUFFER,
+	LIT_INDEX_BUFFER
+};
+
+//One draw as the GPU would have seen it, for comparing frames between runs
+struct RecordedDraw
+{
+	RecordedDrawType	m_type = RecordedDrawType::VERTEX_ARRAY;
+	const Texture*		m_texture = nullptr;
+	Shader*				m_shader = nullptr;
+	BlendMode			m_blendMode = BlendMode::ALPHA;
+	DepthMode			m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+	int					m_count = 0;
+};
+
+//Sends the game's render path nowhere: buffers are never created and draws are only counted and recorded.
+//This is not headless: the window and engine renderer still exist, since textures, fonts, the dev console, debug drawing and the HUD use them directly.
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	RecordingRenderBackend() = default;
+	~RecordingRenderBackend() = default;
+
+	void			BeginFrame() override;
+
+	VertexBuffer*	CreateVertexBuffer(unsigned int size, unsigned int stride) override;
+	IndexBuffer*	CreateIndexBuffer(unsigned int numIndexes) override;
+	ConstantBuffer*	CreateConstantBuffer(unsigned int size) override;
+	void			CopyCPUToGPU(Vertex_PCUTBN const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) override;
+	void			CopyCPUToGPU(unsigned int const* indexes, unsigned int numIndexes, IndexBuffer* indexBuffer) override;
+	void			CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* constantBuffer) override;
+	void			CopyCPUToGPU(Vertex_PCU const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) override;
+
+	void			BeginCamera(Camera const& camera) override;
+	void			EndCamera(Camera const& camera) override;
+	void			BindTexture(const Texture* texture) override;
+	void			BindShader(Shader* shader) override;
+	void			SetBlendMode(BlendMode blendMode) override;
+	void			SetRasterizerMode(RasterizerMode rasterizerMode) override;
+	void			SetDepthMode(DepthMode depthMode) override;
+	void			SetSamplerMode(SamplerMode samplerMode) override;
+	void			SetStatesIfChanged() override;
+	void			SetModelConstants(Mat44 const& modelTransform, Rgba8 const& modelColor) override;
+	void			BindLightBuffer(ConstantBuffer* lightBuffer) override;
+	void			BindVertexFrameBuffer(ConstantBuffer* vertexFrameBuffer) override;
+
+	void			DrawVertexArray(std::vector<Vertex_PCU> const& verts) override;
+	void			DrawVertexBuffer(VertexBuffer* vertexBuffer, int numVerts) override;
+	void			DrawLitIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, ConstantBuffer* lightBuffer, int numIndexes) override;
+
+	std::vector<RecordedDraw>			GetLastFrameDraws() const;
+
+	//One line per draw; textures and shaders are numbered by first use so two runs of the same frame diff cleanly
+	bool								WriteLastFrameDraws(std::string const& path, int& out_numDraws) const;
+
+private:
+	void			RecordDraw(RecordedDrawType type, int count);
+
+	RecordedDraw				m_currentState;
+	std::vector<RecordedDraw>	m_frameDraws;
+	mutable std::mutex			m_lastFrameMutex;
+	std::vector<RecordedDraw>	m_lastFrameDraws;
+};
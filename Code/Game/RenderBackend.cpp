@@ -0,0 +1,180 @@
+#include "RenderBackend.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+constexpr unsigned int KNOWN_TEXTURE = 1 << 0;
+constexpr unsigned int KNOWN_SHADER = 1 << 1;
+constexpr unsigned int KNOWN_BLEND_MODE = 1 << 2;
+constexpr unsigned int KNOWN_RASTERIZER_MODE = 1 << 3;
+constexpr unsigned int KNOWN_DEPTH_MODE = 1 << 4;
+constexpr unsigned int KNOWN_SAMPLER_MODE = 1 << 5;
+constexpr unsigned int KNOWN_MODEL_CONSTANTS = 1 << 6;
+constexpr unsigned int KNOWN_LIGHT_BUFFER = 1 << 7;
+constexpr unsigned int KNOWN_VERTEX_FRAME_BUFFER = 1 << 8;
+
+RenderBackend::RenderBackend()
+{
+	m_drawingThread = std::this_thread::get_id();
+}
+
+void RenderBackend::BeginFrame()
+{
+	AssertOnDrawingThread();
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = RenderBackendStats();
+	m_knownStates = 0;
+}
+
+RenderBackendStats RenderBackend::GetLastFrameStats() const
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	return m_lastFrameStats;
+}
+
+void RenderBackend::CountBufferCreated()
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_frameStats.m_numBuffersCreated++;
+}
+
+void RenderBackend::CountBytesUploaded(unsigned int numBytes)
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_frameStats.m_numBytesUploaded += numBytes;
+}
+
+void RenderBackend::CountDraw(int numVerts)
+{
+	AssertOnDrawingThread();
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_frameStats.m_numDraws++;
+	m_frameStats.m_numVertsDrawn += numVerts;
+}
+
+void RenderBackend::CountStateChange()
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_frameStats.m_numStateChanges++;
+}
+
+void RenderBackend::ForgetBoundState()
+{
+	AssertOnDrawingThread();
+	m_knownStates = 0;
+}
+
+void RenderBackend::SetDrawingThread(std::thread::id drawingThread)
+{
+	m_drawingThread = drawingThread;
+}
+
+void RenderBackend::AssertOnDrawingThread() const
+{
+	ASSERT_OR_DIE(std::this_thread::get_id() == m_drawingThread, "Render backend bound or drew from a thread other than its drawing thread");
+}
+
+void RenderBackend::CountTextureChange(const Texture* texture)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_TEXTURE) == 0 || m_boundTexture != texture)
+	{
+		CountStateChange();
+		m_boundTexture = texture;
+		m_knownStates |= KNOWN_TEXTURE;
+	}
+}
+
+void RenderBackend::CountShaderChange(Shader* shader)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_SHADER) == 0 || m_boundShader != shader)
+	{
+		CountStateChange();
+		m_boundShader = shader;
+		m_knownStates |= KNOWN_SHADER;
+	}
+}
+
+void RenderBackend::CountBlendModeChange(BlendMode blendMode)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_BLEND_MODE) == 0 || m_boundBlendMode != blendMode)
+	{
+		CountStateChange();
+		m_boundBlendMode = blendMode;
+		m_knownStates |= KNOWN_BLEND_MODE;
+	}
+}
+
+void RenderBackend::CountRasterizerModeChange(RasterizerMode rasterizerMode)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_RASTERIZER_MODE) == 0 || m_boundRasterizerMode != rasterizerMode)
+	{
+		CountStateChange();
+		m_boundRasterizerMode = rasterizerMode;
+		m_knownStates |= KNOWN_RASTERIZER_MODE;
+	}
+}
+
+void RenderBackend::CountDepthModeChange(DepthMode depthMode)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_DEPTH_MODE) == 0 || m_boundDepthMode != depthMode)
+	{
+		CountStateChange();
+		m_boundDepthMode = depthMode;
+		m_knownStates |= KNOWN_DEPTH_MODE;
+	}
+}
+
+void RenderBackend::CountSamplerModeChange(SamplerMode samplerMode)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_SAMPLER_MODE) == 0 || m_boundSamplerMode != samplerMode)
+	{
+		CountStateChange();
+		m_boundSamplerMode = samplerMode;
+		m_knownStates |= KNOWN_SAMPLER_MODE;
+	}
+}
+
+void RenderBackend::CountModelConstantsChange(Mat44 const& modelTransform, Rgba8 const& modelColor)
+{
+	AssertOnDrawingThread();
+	bool isSame = (m_knownStates & KNOWN_MODEL_CONSTANTS) != 0 && m_boundModelColor.r == modelColor.r && m_boundModelColor.g == modelColor.g &&
+		m_boundModelColor.b == modelColor.b && m_boundModelColor.a == modelColor.a;
+	for (int i = 0; i < 16 && isSame; i++)
+	{
+		isSame = m_boundModelTransform.m_values[i] == modelTransform.m_values[i];
+	}
+	if (!isSame)
+	{
+		CountStateChange();
+		m_boundModelTransform = modelTransform;
+		m_boundModelColor = modelColor;
+		m_knownStates |= KNOWN_MODEL_CONSTANTS;
+	}
+}
+
+void RenderBackend::CountLightBufferChange(ConstantBuffer* lightBuffer)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_LIGHT_BUFFER) == 0 || m_boundLightBuffer != lightBuffer)
+	{
+		CountStateChange();
+		m_boundLightBuffer = lightBuffer;
+		m_knownStates |= KNOWN_LIGHT_BUFFER;
+	}
+}
+
+void RenderBackend::CountVertexFrameBufferChange(ConstantBuffer* vertexFrameBuffer)
+{
+	AssertOnDrawingThread();
+	if ((m_knownStates & KNOWN_VERTEX_FRAME_BUFFER) == 0 || m_boundVertexFrameBuffer != vertexFrameBuffer)
+	{
+		CountStateChange();
+		m_boundVertexFrameBuffer = vertexFrameBuffer;
+		m_knownStates |= KNOWN_VERTEX_FRAME_BUFFER;
+	}
+}
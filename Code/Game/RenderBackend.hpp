@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <thread>
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+class Texture;
+class Shader;
+class VertexBuffer;
+class IndexBuffer;
+class ConstantBuffer;
+class Camera;
+
+struct RenderBackendStats
+{
+	int				m_numDraws = 0;
+	int				m_numVertsDrawn = 0;
+	int				m_numStateChanges = 0;
+	int				m_numBuffersCreated = 0;
+	unsigned int	m_numBytesUploaded = 0;
+};
+
+//Everything the per-frame game render path asks of the GPU; the engine renderer or a recorder sits behind it.
+//Creating and filling buffers is allowed from any thread. Binding, drawing and BeginFrame belong to one drawing thread,
+//the creating thread unless a render thread claims it, and assert that they are called from it.
+class RenderBackend
+{
+public:
+	RenderBackend();
+	virtual ~RenderBackend() = default;
+
+	virtual VertexBuffer*	CreateVertexBuffer(unsigned int size, unsigned int stride) = 0;
+	virtual IndexBuffer*	CreateIndexBuffer(unsigned int numIndexes) = 0;
+	virtual ConstantBuffer*	CreateConstantBuffer(unsigned int size) = 0;
+	virtual void			CopyCPUToGPU(Vertex_PCUTBN const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) = 0;
+	virtual void			CopyCPUToGPU(unsigned int const* indexes, unsigned int numIndexes, IndexBuffer* indexBuffer) = 0;
+	virtual void			CopyCPUToGPU(void const* data, unsigned int size, ConstantBuffer* constantBuffer) = 0;
+
+	//Compact map chunks upload in the PCU layout and rebuild their tangent frames in the shader
+	virtual void			CopyCPUToGPU(Vertex_PCU const* verts, unsigned int numVerts, VertexBuffer* vertexBuffer) = 0;
+
+	virtual void			BeginCamera(Camera const& camera) = 0;
+	virtual void			EndCamera(Camera const& camera) = 0;
+	virtual void			BindTexture(const Texture* texture) = 0;
+	virtual void			BindShader(Shader* shader) = 0;
+	virtual void			SetBlendMode(BlendMode blendMode) = 0;
+	virtual void			SetRasterizerMode(RasterizerMode rasterizerMode) = 0;
+	virtual void			SetDepthMode(DepthMode depthMode) = 0;
+	virtual void			SetSamplerMode(SamplerMode samplerMode) = 0;
+	virtual void			SetStatesIfChanged() = 0;
+	virtual void			SetModelConstants(Mat44 const& modelTransform, Rgba8 const& modelColor) = 0;
+	virtual void			BindLightBuffer(ConstantBuffer* lightBuffer) = 0;
+	virtual void			BindVertexFrameBuffer(ConstantBuffer* vertexFrameBuffer) = 0;
+
+	virtual void			DrawVertexArray(std::vector<Vertex_PCU> const& verts) = 0;
+	virtual void			DrawVertexBuffer(VertexBuffer* vertexBuffer, int numVerts) = 0;
+	virtual void			DrawLitIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, ConstantBuffer* lightBuffer, int numIndexes) = 0;
+
+	virtual void			BeginFrame();
+	RenderBackendStats		GetLastFrameStats() const;
+
+	//Anything drawn straight through the engine renderer can change state behind the backend, so each view starts from unknown
+	void					ForgetBoundState();
+
+	//Hands binding and drawing to another thread; only call while neither thread is drawing
+	void					SetDrawingThread(std::thread::id drawingThread);
+
+protected:
+	//Buffers may be created and filled from the simulation while a render thread draws, so every counter goes through the same lock as the frame rollover
+	void					CountBufferCreated();
+	void					CountBytesUploaded(unsigned int numBytes);
+	void					CountDraw(int numVerts);
+	void					CountStateChange();
+
+	void					AssertOnDrawingThread() const;
+
+	//A setter only counts as a state change when it differs from what the backend last set
+	void					CountTextureChange(const Texture* texture);
+	void					CountShaderChange(Shader* shader);
+	void					CountBlendModeChange(BlendMode blendMode);
+	void					CountRasterizerModeChange(RasterizerMode rasterizerMode);
+	void					CountDepthModeChange(DepthMode depthMode);
+	void					CountSamplerModeChange(SamplerMode samplerMode);
+	void					CountModelConstantsChange(Mat44 const& modelTransform, Rgba8 const& modelColor);
+	void					CountLightBufferChange(ConstantBuffer* lightBuffer);
+	void					CountVertexFrameBufferChange(ConstantBuffer* vertexFrameBuffer);
+
+	mutable std::mutex		m_statsMutex;
+	RenderBackendStats		m_frameStats;
+	RenderBackendStats		m_lastFrameStats;
+
+	std::thread::id			m_drawingThread;
+
+	//Bit per state below, set once the backend has bound a value for it. Only the drawing thread reads or writes these
+	unsigned int			m_knownStates = 0;
+	const Texture*			m_boundTexture = nullptr;
+	Shader*					m_boundShader = nullptr;
+	BlendMode				m_boundBlendMode = BlendMode::ALPHA;
+	RasterizerMode			m_boundRasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	DepthMode				m_boundDepthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+	SamplerMode				m_boundSamplerMode = SamplerMode::POINT_CLAMP;
+	Mat44					m_boundModelTransform;
+	Rgba8					m_boundModelColor;
+	ConstantBuffer*			m_boundLightBuffer = nullptr;
+	ConstantBuffer*			m_boundVertexFrameBuffer = nullptr;
+};
@@ -0,0 +1,377 @@
+#include "RenderQueue.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderThread.hpp"
+#include <cstring>
+
+constexpr float MAX_SORT_DEPTH = 256.f;
+constexpr uint64_t DEPTH_MASK = 0xFFFFFF;
+constexpr uint64_t RESOURCE_ID_MASK = 0xFFF;
+constexpr int NUM_STATES_PER_COMMAND = 7;
+
+int RenderCommand::CountStateChanges(RenderCommand const& previous) const
+{
+	int numChanges = 0;
+	numChanges += (previous.m_blendMode != m_blendMode) ? 1 : 0;
+	numChanges += (previous.m_rasterizerMode != m_rasterizerMode) ? 1 : 0;
+	numChanges += (previous.m_depthMode != m_depthMode) ? 1 : 0;
+	numChanges += (previous.m_samplerMode != m_samplerMode) ? 1 : 0;
+	numChanges += (previous.m_texture != m_texture) ? 1 : 0;
+	numChanges += (previous.m_shader != m_shader) ? 1 : 0;
+	numChanges += HasSameModelConstants(previous) ? 0 : 1;
+	return numChanges;
+}
+
+bool RenderCommand::HasSameModelConstants(RenderCommand const& other) const
+{
+	if (other.m_modelColor.r != m_modelColor.r || other.m_modelColor.g != m_modelColor.g ||
+		other.m_modelColor.b != m_modelColor.b || other.m_modelColor.a != m_modelColor.a)
+	{
+		return false;
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		if (other.m_modelTransform.m_values[i] != m_modelTransform.m_values[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+RenderExecutor::~RenderExecutor()
+{
+	for (int i = 0; i < (int)m_streamBuffers.size(); i++)
+	{
+		delete m_streamBuffers[i];
+	}
+	m_streamBuffers.clear();
+}
+
+void RenderExecutor::BeginFrame()
+{
+	m_numStreamBuffersUsed = 0;
+	m_previous = nullptr;
+	m_boundLightBuffer = nullptr;
+	m_boundVertexFrameBuffer = nullptr;
+}
+
+void RenderExecutor::ExecuteUploads(RenderUpload const* uploads, int numUploads)
+{
+	for (int i = 0; i < numUploads; i++)
+	{
+		RenderUpload const& upload = uploads[i];
+		if (upload.m_vertexBuffer != nullptr)
+		{
+			g_theRenderBackend->CopyCPUToGPU((Vertex_PCUTBN const*)upload.m_data, upload.m_size / (unsigned int)sizeof(Vertex_PCUTBN), upload.m_vertexBuffer);
+		}
+		else
+		{
+			g_theRenderBackend->CopyCPUToGPU(upload.m_data, upload.m_size, upload.m_constantBuffer);
+		}
+	}
+}
+
+void RenderExecutor::BeginView()
+{
+	//The first command of a view can't trust whatever state was left behind
+	m_previous = nullptr;
+	m_boundLightBuffer = nullptr;
+	m_boundVertexFrameBuffer = nullptr;
+	g_theRenderBackend->ForgetBoundState();
+}
+
+void RenderExecutor::Execute(RenderCommand const& command)
+{
+	bool isFirst = (m_previous == nullptr);
+	bool pipelineChanged = false;
+	if (isFirst || m_previous->m_blendMode != command.m_blendMode)
+	{
+		g_theRenderBackend->SetBlendMode(command.m_blendMode);
+		pipelineChanged = true;
+	}
+	if (isFirst || m_previous->m_rasterizerMode != command.m_rasterizerMode)
+	{
+		g_theRenderBackend->SetRasterizerMode(command.m_rasterizerMode);
+		pipelineChanged = true;
+	}
+	if (isFirst || m_previous->m_depthMode != command.m_depthMode)
+	{
+		g_theRenderBackend->SetDepthMode(command.m_depthMode);
+		pipelineChanged = true;
+	}
+	if (isFirst || m_previous->m_samplerMode != command.m_samplerMode)
+	{
+		g_theRenderBackend->SetSamplerMode(command.m_samplerMode);
+		pipelineChanged = true;
+	}
+	if (pipelineChanged)
+	{
+		g_theRenderBackend->SetStatesIfChanged();
+	}
+	if (isFirst || m_previous->m_texture != command.m_texture)
+	{
+		g_theRenderBackend->BindTexture(command.m_texture);
+	}
+	if (isFirst || m_previous->m_shader != command.m_shader)
+	{
+		g_theRenderBackend->BindShader(command.m_shader);
+	}
+	if (isFirst || !command.HasSameModelConstants(*m_previous))
+	{
+		g_theRenderBackend->SetModelConstants(command.m_modelTransform, command.m_modelColor);
+	}
+
+	//Lit index draws bind their own light buffer; any other lit draw would inherit whichever one drew last
+	if (command.m_lightBuffer != nullptr && command.m_lightBuffer != m_boundLightBuffer)
+	{
+		if (command.m_type != RenderCommandType::LIT_INDEX_BUFFER)
+		{
+			g_theRenderBackend->BindLightBuffer(command.m_lightBuffer);
+		}
+		m_boundLightBuffer = command.m_lightBuffer;
+	}
+	if (command.m_vertexFrameBuffer != nullptr && command.m_vertexFrameBuffer != m_boundVertexFrameBuffer)
+	{
+		g_theRenderBackend->BindVertexFrameBuffer(command.m_vertexFrameBuffer);
+		m_boundVertexFrameBuffer = command.m_vertexFrameBuffer;
+	}
+
+	DrawCommand(command);
+	m_previous = &command;
+}
+
+void RenderExecutor::DrawCommand(RenderCommand const& command)
+{
+	switch (command.m_type)
+	{
+	case RenderCommandType::VERTEX_ARRAY:
+		g_theRenderBackend->DrawVertexArray(*command.m_verts);
+		break;
+	case RenderCommandType::VERTEX_BUFFER:
+		g_theRenderBackend->DrawVertexBuffer(command.m_vertexBuffer, command.m_count);
+		break;
+	case RenderCommandType::VERTEX_STREAM:
+	{
+		if (m_numStreamBuffersUsed >= (int)m_streamBuffers.size())
+		{
+			m_streamBuffers.push_back(g_theRenderBackend->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN)));
+		}
+		VertexBuffer* streamBuffer = m_streamBuffers[m_numStreamBuffersUsed++];
+		g_theRenderBackend->CopyCPUToGPU(command.m_streamVerts, (unsigned int)command.m_count, streamBuffer);
+		g_theRenderBackend->DrawVertexBuffer(streamBuffer, command.m_count);
+		break;
+	}
+	case RenderCommandType::LIT_INDEX_BUFFER:
+		g_theRenderBackend->DrawLitIndexBuffer(command.m_vertexBuffer, command.m_indexBuffer, command.m_lightBuffer, command.m_count);
+		break;
+	}
+}
+
+void RenderQueue::BeginFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = RenderQueueStats();
+	m_executor.BeginFrame();
+	m_resourceIDs.clear();
+}
+
+void RenderQueue::Submit(RenderCommand const& command)
+{
+	//Buffers may legitimately be null behind the recording backend, so only the count matters for them
+	bool hasGeometry = false;
+	switch (command.m_type)
+	{
+	case RenderCommandType::VERTEX_ARRAY:
+		hasGeometry = (command.m_verts != nullptr && !command.m_verts->empty());
+		break;
+	case RenderCommandType::VERTEX_STREAM:
+		hasGeometry = (command.m_streamVerts != nullptr && command.m_count > 0);
+		break;
+	default:
+		hasGeometry = (command.m_count > 0);
+		break;
+	}
+	if (!hasGeometry)
+	{
+		return;
+	}
+
+	RenderSortEntry entry;
+	entry.m_key = MakeSortKey(command);
+	entry.m_commandIndex = (int)m_commands.size();
+	m_commands.push_back(command);
+	m_entries.push_back(entry);
+}
+
+void RenderQueue::SubmitUpload(VertexBuffer* vertexBuffer, Vertex_PCUTBN const* verts, unsigned int numVerts)
+{
+	if (numVerts == 0)
+	{
+		return;
+	}
+
+	RenderUpload upload;
+	upload.m_vertexBuffer = vertexBuffer;
+	upload.m_size = numVerts * (unsigned int)sizeof(Vertex_PCUTBN);
+	unsigned char* data = AllocateUploadData(upload.m_size);
+	memcpy(data, verts, upload.m_size);
+	upload.m_data = data;
+	m_uploads.push_back(upload);
+}
+
+void RenderQueue::SubmitUpload(ConstantBuffer* constantBuffer, void const* data, unsigned int size)
+{
+	RenderUpload upload;
+	upload.m_constantBuffer = constantBuffer;
+	upload.m_size = size;
+	unsigned char* uploadData = AllocateUploadData(size);
+	memcpy(uploadData, data, size);
+	upload.m_data = uploadData;
+	m_uploads.push_back(upload);
+}
+
+void RenderQueue::Execute(Camera const& camera)
+{
+	if (m_commands.empty() && m_uploads.empty())
+	{
+		return;
+	}
+
+	//What the same commands would have cost in the order they were submitted
+	if (!m_commands.empty())
+	{
+		m_frameStats.m_numUnsortedStateChanges += NUM_STATES_PER_COMMAND;
+	}
+	for (int i = 1; i < (int)m_commands.size(); i++)
+	{
+		m_frameStats.m_numUnsortedStateChanges += m_commands[i].CountStateChanges(m_commands[i - 1]);
+	}
+
+	SortEntries();
+	for (int i = 0; i < (int)m_entries.size(); i++)
+	{
+		RenderCommand const& command = m_commands[m_entries[i].m_commandIndex];
+		m_frameStats.m_numStateChanges += (i == 0) ? NUM_STATES_PER_COMMAND : command.CountStateChanges(m_commands[m_entries[i - 1].m_commandIndex]);
+	}
+	m_frameStats.m_numCommands += (int)m_commands.size();
+	m_frameStats.m_numDraws += (int)m_commands.size();
+
+	//With a render thread the view is copied out and drawn later; otherwise the caller already has the camera bound
+	if (g_theRenderThread != nullptr)
+	{
+		g_theRenderThread->GetWriteSnapshot().AddView(camera, m_uploads, m_commands, m_entries);
+	}
+	else
+	{
+		m_executor.ExecuteUploads(m_uploads.data(), (int)m_uploads.size());
+		m_executor.BeginView();
+		for (int i = 0; i < (int)m_entries.size(); i++)
+		{
+			m_executor.Execute(m_commands[m_entries[i].m_commandIndex]);
+		}
+	}
+
+	m_commands.clear();
+	m_entries.clear();
+	m_uploads.clear();
+	m_numUploadDataUsed = 0;
+}
+
+RenderQueueStats const& RenderQueue::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
+uint64_t RenderQueue::MakeSortKey(RenderCommand const& command)
+{
+	//pass:4 | blend:4 | shader:12 | texture:12 | depth:24 | unused:8
+	uint64_t pass = (uint64_t)command.m_pass & 0xF;
+	uint64_t blend = (uint64_t)command.m_blendMode & 0xF;
+	uint64_t shader = (uint64_t)GetResourceID(command.m_shader);
+	uint64_t texture = (uint64_t)GetResourceID(command.m_texture);
+	uint64_t depth = (uint64_t)(GetClamped(command.m_sortDepth / MAX_SORT_DEPTH, 0.f, 1.f) * (float)DEPTH_MASK);
+
+	//Blending only comes out right far to near, so depth outranks state there
+	if (command.m_pass == RenderPass::TRANSLUCENT)
+	{
+		return (pass << 60) | ((DEPTH_MASK - depth) << 36) | (blend << 32) | (shader << 20) | (texture << 8);
+	}
+
+	//HUD layers must draw in the order they were asked for
+	if (command.m_pass == RenderPass::HUD)
+	{
+		return (pass << 60) | (depth << 36) | (blend << 32) | (shader << 20) | (texture << 8);
+	}
+	return (pass << 60) | (blend << 56) | (shader << 44) | (texture << 32) | (depth << 8);
+}
+
+int RenderQueue::GetResourceID(void const* resource)
+{
+	if (resource == nullptr)
+	{
+		return 0;
+	}
+	auto found = m_resourceIDs.find(resource);
+	if (found != m_resourceIDs.end())
+	{
+		return found->second;
+	}
+
+	//Two resources sharing an id would interleave their draws in the sort
+	int id = (int)m_resourceIDs.size() + 1;
+	ASSERT_OR_DIE((uint64_t)id <= RESOURCE_ID_MASK, "More shaders and textures in one frame than the render queue's sort key can tell apart");
+	m_resourceIDs[resource] = id;
+	return id;
+}
+
+void RenderQueue::SortEntries()
+{
+	if (m_entries.empty())
+	{
+		return;
+	}
+
+	//LSD radix sort on the key a byte at a time; stable, so equal keys keep submission order
+	m_scratchEntries.resize(m_entries.size());
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		int counts[257] = {};
+		for (int i = 0; i < (int)m_entries.size(); i++)
+		{
+			counts[((m_entries[i].m_key >> shift) & 0xFF) + 1]++;
+		}
+
+		//Every key shares this byte, nothing to reorder
+		if (counts[((m_entries[0].m_key >> shift) & 0xFF) + 1] == (int)m_entries.size())
+		{
+			continue;
+		}
+
+		for (int bucket = 1; bucket < 257; bucket++)
+		{
+			counts[bucket] += counts[bucket - 1];
+		}
+		for (int i = 0; i < (int)m_entries.size(); i++)
+		{
+			int bucket = (int)((m_entries[i].m_key >> shift) & 0xFF);
+			m_scratchEntries[counts[bucket]++] = m_entries[i];
+		}
+		m_entries.swap(m_scratchEntries);
+	}
+}
+
+unsigned char* RenderQueue::AllocateUploadData(unsigned int size)
+{
+	//Each upload keeps its own array, reused from frame to frame; a deque never moves the earlier ones
+	if (m_numUploadDataUsed >= (int)m_uploadData.size())
+	{
+		m_uploadData.emplace_back();
+	}
+	std::vector<unsigned char>& data = m_uploadData[m_numUploadDataUsed++];
+	data.resize(size);
+	return data.data();
+}
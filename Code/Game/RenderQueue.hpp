@@ -0,0 +1,149 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+class Texture;
+class Shader;
+class VertexBuffer;
+class IndexBuffer;
+class ConstantBuffer;
+class Camera;
+
+//Passes draw in this order; translucent draws far to near and HUD keeps its layers instead of grouping by state
+enum class RenderPass : unsigned char
+{
+	SKY,
+	WORLD,
+	DECALS,
+	TRANSLUCENT,
+	HUD,
+	COUNT
+};
+
+enum class RenderCommandType : unsigned char
+{
+	VERTEX_ARRAY,
+	VERTEX_BUFFER,
+	VERTEX_STREAM,
+	LIT_INDEX_BUFFER
+};
+
+struct RenderCommand
+{
+	RenderPass						m_pass = RenderPass::WORLD;
+	RenderCommandType				m_type = RenderCommandType::VERTEX_ARRAY;
+	float							m_sortDepth = 0.f;
+
+	const Texture*					m_texture = nullptr;
+	Shader*							m_shader = nullptr;
+	BlendMode						m_blendMode = BlendMode::ALPHA;
+	RasterizerMode					m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	DepthMode						m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+	SamplerMode						m_samplerMode = SamplerMode::POINT_CLAMP;
+	Mat44							m_modelTransform;
+	Rgba8							m_modelColor = Rgba8::WHITE;
+
+	//Geometry must stay alive until the queue is executed; streamed verts are uploaded into a pooled buffer right before drawing
+	std::vector<Vertex_PCU> const*	m_verts = nullptr;
+	Vertex_PCUTBN const*			m_streamVerts = nullptr;
+	VertexBuffer*					m_vertexBuffer = nullptr;
+	IndexBuffer*					m_indexBuffer = nullptr;
+	ConstantBuffer*					m_lightBuffer = nullptr;
+	ConstantBuffer*					m_vertexFrameBuffer = nullptr;
+	int								m_count = 0;
+
+	int								CountStateChanges(RenderCommand const& previous) const;
+	bool							HasSameModelConstants(RenderCommand const& other) const;
+};
+
+//A buffer write that has to land before the next view draws; the data belongs to whoever holds the upload
+struct RenderUpload
+{
+	VertexBuffer*			m_vertexBuffer = nullptr;
+	ConstantBuffer*			m_constantBuffer = nullptr;
+	unsigned char const*	m_data = nullptr;
+	unsigned int			m_size = 0;
+};
+
+struct RenderQueueStats
+{
+	int	m_numCommands = 0;
+	int	m_numDraws = 0;
+	int	m_numStateChanges = 0;
+	int	m_numUnsortedStateChanges = 0;
+};
+
+struct RenderSortEntry
+{
+	uint64_t	m_key = 0;
+	int			m_commandIndex = 0;
+};
+
+//Replays commands against the render backend, skipping state that didn't change since the previous command
+class RenderExecutor
+{
+public:
+	RenderExecutor() = default;
+	~RenderExecutor();
+
+	void						BeginFrame();
+	void						ExecuteUploads(RenderUpload const* uploads, int numUploads);
+	void						BeginView();
+	void						Execute(RenderCommand const& command);
+
+private:
+	void						DrawCommand(RenderCommand const& command);
+
+	RenderCommand const*		m_previous = nullptr;
+	ConstantBuffer*				m_boundLightBuffer = nullptr;
+	ConstantBuffer*				m_boundVertexFrameBuffer = nullptr;
+
+	//The engine draws a buffer from its start, so each streamed command gets its own buffer for the frame
+	std::vector<VertexBuffer*>	m_streamBuffers;
+	int							m_numStreamBuffersUsed = 0;
+};
+
+class RenderQueue
+{
+public:
+	RenderQueue() = default;
+	~RenderQueue() = default;
+
+	void						BeginFrame();
+	void						Submit(RenderCommand const& command);
+	void						SubmitUpload(VertexBuffer* vertexBuffer, Vertex_PCUTBN const* verts, unsigned int numVerts);
+	void						SubmitUpload(ConstantBuffer* constantBuffer, void const* data, unsigned int size);
+	void						Execute(Camera const& camera);
+
+	RenderQueueStats const&		GetLastFrameStats() const;
+
+private:
+	uint64_t					MakeSortKey(RenderCommand const& command);
+	int							GetResourceID(void const* resource);
+	void						SortEntries();
+	unsigned char*				AllocateUploadData(unsigned int size);
+
+	std::vector<RenderCommand>		m_commands;
+	std::vector<RenderSortEntry>	m_entries;
+	std::vector<RenderSortEntry>	m_scratchEntries;
+
+	//Upload data is copied on submit, since callers are free to change their copy before the view executes
+	std::vector<RenderUpload>				m_uploads;
+	std::deque<std::vector<unsigned char>>	m_uploadData;
+	int										m_numUploadDataUsed = 0;
+
+	RenderExecutor					m_executor;
+
+	//Shaders and textures get small ids so they fit in the key; handed out again every frame, so they only have to be unique within one
+	std::unordered_map<void const*, int>	m_resourceIDs;
+
+	RenderQueueStats				m_frameStats;
+	RenderQueueStats				m_lastFrameStats;
+};
@@ -0,0 +1,108 @@
+#include "RenderSnapshot.hpp"
+#include <cstring>
+
+void RenderSnapshot::Clear()
+{
+	m_views.clear();
+	m_uploads.clear();
+	m_commands.clear();
+	m_numVertexArraysUsed = 0;
+	m_numStreamVertsUsed = 0;
+	m_numUploadDataUsed = 0;
+	m_numBytesCopied = 0;
+}
+
+void RenderSnapshot::AddView(Camera const& camera, std::vector<RenderUpload> const& uploads, std::vector<RenderCommand> const& commands, std::vector<RenderSortEntry> const& sortedEntries)
+{
+	RenderSnapshotView view;
+	view.m_camera = camera;
+	view.m_firstUpload = (int)m_uploads.size();
+	view.m_numUploads = (int)uploads.size();
+	view.m_firstCommand = (int)m_commands.size();
+	view.m_numCommands = (int)sortedEntries.size();
+
+	for (int i = 0; i < (int)uploads.size(); i++)
+	{
+		RenderUpload upload = uploads[i];
+		upload.m_data = CopyUploadData(upload.m_data, upload.m_size);
+		m_uploads.push_back(upload);
+	}
+
+	//Stored already sorted, so the render thread just walks them
+	for (int i = 0; i < (int)sortedEntries.size(); i++)
+	{
+		RenderCommand command = commands[sortedEntries[i].m_commandIndex];
+		if (command.m_type == RenderCommandType::VERTEX_ARRAY)
+		{
+			command.m_verts = CopyVertexArray(*command.m_verts);
+		}
+		else if (command.m_type == RenderCommandType::VERTEX_STREAM)
+		{
+			command.m_streamVerts = CopyStreamVerts(command.m_streamVerts, command.m_count);
+		}
+		m_commands.push_back(command);
+	}
+	m_views.push_back(view);
+}
+
+int RenderSnapshot::GetNumViews() const
+{
+	return (int)m_views.size();
+}
+
+RenderSnapshotView const& RenderSnapshot::GetView(int viewIndex) const
+{
+	return m_views[viewIndex];
+}
+
+RenderUpload const* RenderSnapshot::GetUploads(RenderSnapshotView const& view) const
+{
+	return m_uploads.data() + view.m_firstUpload;
+}
+
+RenderCommand const* RenderSnapshot::GetCommands(RenderSnapshotView const& view) const
+{
+	return m_commands.data() + view.m_firstCommand;
+}
+
+unsigned int RenderSnapshot::GetNumBytesCopied() const
+{
+	return m_numBytesCopied;
+}
+
+std::vector<Vertex_PCU>* RenderSnapshot::CopyVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	if (m_numVertexArraysUsed >= (int)m_vertexArrays.size())
+	{
+		m_vertexArrays.emplace_back();
+	}
+	std::vector<Vertex_PCU>& copy = m_vertexArrays[m_numVertexArraysUsed++];
+	copy.assign(verts.begin(), verts.end());
+	m_numBytesCopied += (unsigned int)(verts.size() * sizeof(Vertex_PCU));
+	return &copy;
+}
+
+Vertex_PCUTBN const* RenderSnapshot::CopyStreamVerts(Vertex_PCUTBN const* verts, int numVerts)
+{
+	if (m_numStreamVertsUsed >= (int)m_streamVerts.size())
+	{
+		m_streamVerts.emplace_back();
+	}
+	std::vector<Vertex_PCUTBN>& copy = m_streamVerts[m_numStreamVertsUsed++];
+	copy.assign(verts, verts + numVerts);
+	m_numBytesCopied += (unsigned int)numVerts * (unsigned int)sizeof(Vertex_PCUTBN);
+	return copy.data();
+}
+
+unsigned char const* RenderSnapshot::CopyUploadData(unsigned char const* data, unsigned int size)
+{
+	if (m_numUploadDataUsed >= (int)m_uploadData.size())
+	{
+		m_uploadData.emplace_back();
+	}
+	std::vector<unsigned char>& copy = m_uploadData[m_numUploadDataUsed++];
+	copy.resize(size);
+	memcpy(copy.data(), data, size);
+	m_numBytesCopied += size;
+	return copy.data();
+}
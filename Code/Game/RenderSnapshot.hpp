@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include "Engine/Renderer/Camera.hpp"
+#include "Game/RenderQueue.hpp"
+
+//One camera's share of a frame: its uploads land first, then its commands draw in sorted order
+struct RenderSnapshotView
+{
+	Camera	m_camera;
+	int		m_firstUpload = 0;
+	int		m_numUploads = 0;
+	int		m_firstCommand = 0;
+	int		m_numCommands = 0;
+};
+
+//Everything needed to draw one frame, copied out of the simulation so the render thread never reads game state
+class RenderSnapshot
+{
+public:
+	RenderSnapshot() = default;
+	~RenderSnapshot() = default;
+
+	void						Clear();
+	void						AddView(Camera const& camera, std::vector<RenderUpload> const& uploads, std::vector<RenderCommand> const& commands, std::vector<RenderSortEntry> const& sortedEntries);
+
+	int							GetNumViews() const;
+	RenderSnapshotView const&	GetView(int viewIndex) const;
+	RenderUpload const*			GetUploads(RenderSnapshotView const& view) const;
+	RenderCommand const*		GetCommands(RenderSnapshotView const& view) const;
+	unsigned int				GetNumBytesCopied() const;
+
+private:
+	std::vector<Vertex_PCU>*	CopyVertexArray(std::vector<Vertex_PCU> const& verts);
+	Vertex_PCUTBN const*		CopyStreamVerts(Vertex_PCUTBN const* verts, int numVerts);
+	unsigned char const*		CopyUploadData(unsigned char const* data, unsigned int size);
+
+	std::vector<RenderSnapshotView>	m_views;
+	std::vector<RenderUpload>		m_uploads;
+	std::vector<RenderCommand>		m_commands;
+
+	//Copied geometry, one array per command; deques keep earlier arrays in place and the arrays are reused frame to frame
+	std::deque<std::vector<Vertex_PCU>>		m_vertexArrays;
+	std::deque<std::vector<Vertex_PCUTBN>>	m_streamVerts;
+	std::deque<std::vector<unsigned char>>	m_uploadData;
+	int										m_numVertexArraysUsed = 0;
+	int										m_numStreamVertsUsed = 0;
+	int										m_numUploadDataUsed = 0;
+	unsigned int							m_numBytesCopied = 0;
+};
@@ -0,0 +1,106 @@
+#include "RenderThread.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+
+RenderThread::RenderThread()
+{
+	m_thread = std::thread(&RenderThread::ThreadMain, this);
+
+	//The thread waits for the first published frame, so it owns binding and drawing before it ever uses the backend
+	g_theRenderBackend->SetDrawingThread(m_thread.get_id());
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_condition.notify_all();
+	m_thread.join();
+	g_theRenderBackend->SetDrawingThread(std::this_thread::get_id());
+}
+
+RenderSnapshot& RenderThread::GetWriteSnapshot()
+{
+	//The write slot only changes hands inside Publish, which runs on this same simulation thread
+	return m_snapshots[m_writeIndex];
+}
+
+void RenderThread::Publish()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		//A frame the thread never got to is replaced rather than queued; only the newest one matters
+		if (m_hasReadyFrame)
+		{
+			m_stats.m_numFramesSkipped++;
+		}
+		m_stats.m_numFramesPublished++;
+		m_stats.m_numBytesCopied = m_snapshots[m_writeIndex].GetNumBytesCopied();
+		std::swap(m_writeIndex, m_readyIndex);
+		m_hasReadyFrame = true;
+	}
+	m_condition.notify_all();
+	m_snapshots[m_writeIndex].Clear();
+}
+
+void RenderThread::Flush()
+{
+	//Used before anything a snapshot points at (map buffers) is destroyed or rebuilt
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this]() { return !m_hasReadyFrame && !m_isRendering; });
+}
+
+RenderThreadStats RenderThread::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void RenderThread::ThreadMain()
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_hasReadyFrame || m_isQuitting; });
+			if (m_isQuitting)
+			{
+				break;
+			}
+			std::swap(m_readyIndex, m_renderIndex);
+			m_hasReadyFrame = false;
+			m_isRendering = true;
+		}
+
+		RenderFrame(m_snapshots[m_renderIndex]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isRendering = false;
+			m_stats.m_numFramesRendered++;
+		}
+		m_condition.notify_all();
+	}
+}
+
+void RenderThread::RenderFrame(RenderSnapshot const& snapshot)
+{
+	m_executor.BeginFrame();
+	for (int viewIndex = 0; viewIndex < snapshot.GetNumViews(); viewIndex++)
+	{
+		RenderSnapshotView const& view = snapshot.GetView(viewIndex);
+		g_theRenderBackend->BeginCamera(view.m_camera);
+		m_executor.ExecuteUploads(snapshot.GetUploads(view), view.m_numUploads);
+		m_executor.BeginView();
+		RenderCommand const* commands = snapshot.GetCommands(view);
+		for (int i = 0; i < view.m_numCommands; i++)
+		{
+			m_executor.Execute(commands[i]);
+		}
+		g_theRenderBackend->EndCamera(view.m_camera);
+	}
+	g_theRenderBackend->BeginFrame();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Game/RenderSnapshot.hpp"
+
+struct RenderThreadStats
+{
+	int				m_numFramesPublished = 0;
+	int				m_numFramesRendered = 0;
+	int				m_numFramesSkipped = 0;
+	unsigned int	m_numBytesCopied = 0;
+};
+
+//Test harness for the snapshot handoff, only started with renderBackend="Recording": it replays published world snapshots
+//into the recorder on its own thread and reports bytes copied and frames skipped. It does not overlap any GPU work with the
+//simulation; the HUD, menus, console and debug drawing still call the engine renderer directly from the main thread.
+//Three snapshots rotate between owners: the simulation writes one, one waits ready, the thread draws the last.
+class RenderThread
+{
+public:
+	RenderThread();
+	~RenderThread();
+
+	RenderSnapshot&			GetWriteSnapshot();
+	void					Publish();
+	void					Flush();
+	RenderThreadStats		GetStats() const;
+
+private:
+	void					ThreadMain();
+	void					RenderFrame(RenderSnapshot const& snapshot);
+
+	RenderSnapshot			m_snapshots[3];
+	int						m_writeIndex = 0;
+	int						m_readyIndex = 1;
+	int						m_renderIndex = 2;
+
+	std::thread				m_thread;
+	mutable std::mutex		m_mutex;
+	std::condition_variable	m_condition;
+	bool					m_hasReadyFrame = false;
+	bool					m_isRendering = false;
+	bool					m_isQuitting = false;
+	RenderThreadStats		m_stats;
+
+	//Only ever touched from the render thread
+	RenderExecutor			m_executor;
+};
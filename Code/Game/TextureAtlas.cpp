@@ -0,0 +1,298 @@
+#include "TextureAtlas.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include <algorithm>
+#include <filesystem>
+
+extern Renderer* g_theRenderer;
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+{
+	m_pageSize = pageSize;
+	m_padding = padding;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	//Page textures are owned by the renderer like every other loaded texture
+	m_pages.clear();
+	m_regions.clear();
+}
+
+void TextureAtlas::AddSource(const Texture* texture, std::string const& imageFilePath)
+{
+	if (m_isBuilt || texture == nullptr || FindRegion(texture) >= 0)
+	{
+		return;
+	}
+
+	AtlasRegion region;
+	region.m_source = texture;
+	region.m_imageFilePath = imageFilePath;
+	m_regions.push_back(region);
+}
+
+void TextureAtlas::Build(std::string const& layoutCachePath)
+{
+	if (m_isBuilt)
+	{
+		return;
+	}
+
+	std::vector<Image*> images;
+	for (int i = 0; i < (int)m_regions.size(); i++)
+	{
+		images.push_back(g_theRenderer->CreateImageFromFile(m_regions[i].m_imageFilePath.c_str()));
+		m_regions[i].m_dimensions = images[i]->GetDimensions();
+	}
+
+	if (!LoadLayout(layoutCachePath))
+	{
+		PackLayout();
+		SaveLayout(layoutCachePath);
+	}
+
+	//Images are stored bottom row first, so v grows with the texel row
+	for (int page = 0; page < m_numPages; page++)
+	{
+		Image pageImage = Image(IntVec2(m_pageSize, m_pageSize), Rgba8(0, 0, 0, 0));
+		for (int i = 0; i < (int)m_regions.size(); i++)
+		{
+			if (m_regions[i].m_page == page)
+			{
+				BlitRegion(pageImage, *images[i], m_regions[i]);
+			}
+		}
+		m_pages.push_back(g_theRenderer->CreateTextureFromImage(pageImage));
+	}
+
+	float pageSize = (float)m_pageSize;
+	for (int i = 0; i < (int)m_regions.size(); i++)
+	{
+		AtlasRegion& region = m_regions[i];
+		Vec2 mins = Vec2((float)region.m_offset.x / pageSize, (float)region.m_offset.y / pageSize);
+		Vec2 maxs = Vec2((float)(region.m_offset.x + region.m_dimensions.x) / pageSize, (float)(region.m_offset.y + region.m_dimensions.y) / pageSize);
+		region.m_UVs = AABB2(mins, maxs);
+		delete images[i];
+	}
+	m_isBuilt = true;
+}
+
+bool TextureAtlas::IsBuilt() const
+{
+	return m_isBuilt;
+}
+
+int TextureAtlas::GetNumPages() const
+{
+	return m_numPages;
+}
+
+const Texture* TextureAtlas::GetAtlasTexture(const Texture* source) const
+{
+	int regionIndex = FindRegion(source);
+	if (!m_isBuilt || regionIndex < 0 || m_regions[regionIndex].m_page < 0)
+	{
+		return source;
+	}
+	return m_pages[m_regions[regionIndex].m_page];
+}
+
+Vec2 TextureAtlas::RemapUV(const Texture* source, Vec2 const& UV) const
+{
+	int regionIndex = FindRegion(source);
+	if (!m_isBuilt || regionIndex < 0 || m_regions[regionIndex].m_page < 0)
+	{
+		return UV;
+	}
+	AABB2 const& region = m_regions[regionIndex].m_UVs;
+	return Vec2(region.m_mins.x + UV.x * (region.m_maxs.x - region.m_mins.x), region.m_mins.y + UV.y * (region.m_maxs.y - region.m_mins.y));
+}
+
+AABB2 TextureAtlas::RemapUVs(const Texture* source, AABB2 const& UVs) const
+{
+	return AABB2(RemapUV(source, UVs.m_mins), RemapUV(source, UVs.m_maxs));
+}
+
+int TextureAtlas::FindRegion(const Texture* source) const
+{
+	for (int i = 0; i < (int)m_regions.size(); i++)
+	{
+		if (m_regions[i].m_source == source)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+void TextureAtlas::PackLayout()
+{
+	//Tallest first, ties broken by width then path, so the same sources always give the same layout
+	std::vector<int> order;
+	for (int i = 0; i < (int)m_regions.size(); i++)
+	{
+		order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [this](int a, int b)
+		{
+			AtlasRegion const& regionA = m_regions[a];
+			AtlasRegion const& regionB = m_regions[b];
+			if (regionA.m_dimensions.y != regionB.m_dimensions.y)
+			{
+				return regionA.m_dimensions.y > regionB.m_dimensions.y;
+			}
+			if (regionA.m_dimensions.x != regionB.m_dimensions.x)
+			{
+				return regionA.m_dimensions.x > regionB.m_dimensions.x;
+			}
+			return regionA.m_imageFilePath < regionB.m_imageFilePath;
+		});
+
+	//Shelf packing: fill a row left to right, start a new shelf above the tallest entry, new page when out of rows
+	int page = 0;
+	int cursorX = 0;
+	int cursorY = 0;
+	int shelfHeight = 0;
+	m_numPages = 0;
+	for (int i = 0; i < (int)order.size(); i++)
+	{
+		AtlasRegion& region = m_regions[order[i]];
+		int paddedWidth = region.m_dimensions.x + (2 * m_padding);
+		int paddedHeight = region.m_dimensions.y + (2 * m_padding);
+		if (paddedWidth > m_pageSize || paddedHeight > m_pageSize)
+		{
+			region.m_page = -1;
+			continue;
+		}
+
+		if (cursorX + paddedWidth > m_pageSize)
+		{
+			cursorY += shelfHeight;
+			cursorX = 0;
+			shelfHeight = 0;
+		}
+		if (cursorY + paddedHeight > m_pageSize)
+		{
+			page++;
+			cursorX = 0;
+			cursorY = 0;
+			shelfHeight = 0;
+		}
+
+		region.m_page = page;
+		region.m_offset = IntVec2(cursorX + m_padding, cursorY + m_padding);
+		cursorX += paddedWidth;
+		shelfHeight = (paddedHeight > shelfHeight) ? paddedHeight : shelfHeight;
+		m_numPages = page + 1;
+	}
+}
+
+bool TextureAtlas::LoadLayout(std::string const& layoutCachePath)
+{
+	XmlDocument layoutDocument;
+	if (layoutDocument.LoadFile(layoutCachePath.c_str()) != 0)
+	{
+		return false;
+	}
+	XmlElement* rootElement = layoutDocument.RootElement();
+	if (rootElement == nullptr)
+	{
+		return false;
+	}
+
+	NamedStrings rootAttributes;
+	rootAttributes.PopulateFromXmlElementAttributes(*rootElement);
+	if (rootAttributes.GetValue("pageSize", 0) != m_pageSize || rootAttributes.GetValue("padding", -1) != m_padding)
+	{
+		return false;
+	}
+
+	//The cache only applies if it describes exactly the sources we have, at the same sizes
+	std::vector<AtlasRegion> cachedRegions = m_regions;
+	int numCachedRegions = 0;
+	int numPages = 0;
+	XmlElement* regionElement = rootElement->FirstChildElement("Region");
+	while (regionElement)
+	{
+		NamedStrings attributes;
+		attributes.PopulateFromXmlElementAttributes(*regionElement);
+		std::string path = attributes.GetValue("path", "");
+		IntVec2 dimensions = IntVec2(attributes.GetValue("width", 0), attributes.GetValue("height", 0));
+
+		bool isMatched = false;
+		for (int i = 0; i < (int)cachedRegions.size(); i++)
+		{
+			if (cachedRegions[i].m_imageFilePath == path && cachedRegions[i].m_dimensions == dimensions)
+			{
+				cachedRegions[i].m_page = attributes.GetValue("page", -1);
+				cachedRegions[i].m_offset = IntVec2(attributes.GetValue("x", 0), attributes.GetValue("y", 0));
+				numPages = (cachedRegions[i].m_page + 1 > numPages) ? cachedRegions[i].m_page + 1 : numPages;
+				isMatched = true;
+				break;
+			}
+		}
+		if (!isMatched)
+		{
+			return false;
+		}
+		numCachedRegions++;
+		regionElement = regionElement->NextSiblingElement("Region");
+	}
+	if (numCachedRegions != (int)m_regions.size())
+	{
+		return false;
+	}
+
+	m_regions = cachedRegions;
+	m_numPages = numPages;
+	return true;
+}
+
+void TextureAtlas::SaveLayout(std::string const& layoutCachePath) const
+{
+	std::filesystem::path directory = std::filesystem::path(layoutCachePath).parent_path();
+	if (!directory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+	}
+
+	XmlDocument layoutDocument;
+	XmlElement* rootElement = layoutDocument.NewElement("SpriteAtlasLayout");
+	rootElement->SetAttribute("pageSize", m_pageSize);
+	rootElement->SetAttribute("padding", m_padding);
+	layoutDocument.InsertEndChild(rootElement);
+	for (int i = 0; i < (int)m_regions.size(); i++)
+	{
+		AtlasRegion const& region = m_regions[i];
+		XmlElement* regionElement = layoutDocument.NewElement("Region");
+		regionElement->SetAttribute("path", region.m_imageFilePath.c_str());
+		regionElement->SetAttribute("width", region.m_dimensions.x);
+		regionElement->SetAttribute("height", region.m_dimensions.y);
+		regionElement->SetAttribute("page", region.m_page);
+		regionElement->SetAttribute("x", region.m_offset.x);
+		regionElement->SetAttribute("y", region.m_offset.y);
+		rootElement->InsertEndChild(regionElement);
+	}
+	layoutDocument.SaveFile(layoutCachePath.c_str());
+}
+
+void TextureAtlas::BlitRegion(Image& page, Image& source, AtlasRegion const& region) const
+{
+	//Padding repeats the edge texels so filtering at a sprite border never pulls in a neighbour
+	std::vector<Rgba8> texels = source.GetDataAsRgba8Vector();
+	IntVec2 dimensions = region.m_dimensions;
+	for (int y = -m_padding; y < dimensions.y + m_padding; y++)
+	{
+		int sourceY = (y < 0) ? 0 : ((y >= dimensions.y) ? dimensions.y - 1 : y);
+		for (int x = -m_padding; x < dimensions.x + m_padding; x++)
+		{
+			int sourceX = (x < 0) ? 0 : ((x >= dimensions.x) ? dimensions.x - 1 : x);
+			page.SetTexelColor(IntVec2(region.m_offset.x + x, region.m_offset.y + y), texels[(sourceY * dimensions.x) + sourceX]);
+		}
+	}
+}
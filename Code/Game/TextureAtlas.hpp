@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/AABB2.hpp"
+
+class Texture;
+class Image;
+
+struct AtlasRegion
+{
+	const Texture*	m_source = nullptr;
+	std::string		m_imageFilePath;
+	IntVec2			m_dimensions = IntVec2(0, 0);
+	int				m_page = -1; //-1 means it did not fit and keeps its own texture
+	IntVec2			m_offset = IntVec2(0, 0);
+	AABB2			m_UVs = AABB2(Vec2(0.f, 0.f), Vec2(1.f, 1.f));
+};
+
+class TextureAtlas
+{
+public:
+	TextureAtlas(int pageSize, int padding);
+	~TextureAtlas();
+
+	void			AddSource(const Texture* texture, std::string const& imageFilePath);
+	void			Build(std::string const& layoutCachePath);
+	bool			IsBuilt() const;
+	int				GetNumPages() const;
+
+	const Texture*	GetAtlasTexture(const Texture* source) const;
+	Vec2			RemapUV(const Texture* source, Vec2 const& UV) const;
+	AABB2			RemapUVs(const Texture* source, AABB2 const& UVs) const;
+
+private:
+	int		FindRegion(const Texture* source) const;
+	void	PackLayout();
+	bool	LoadLayout(std::string const& layoutCachePath);
+	void	SaveLayout(std::string const& layoutCachePath) const;
+	void	BlitRegion(Image& page, Image& source, AtlasRegion const& region) const;
+
+	int							m_pageSize = 2048;
+	int							m_padding = 2;
+	int							m_numPages = 0;
+	bool						m_isBuilt = false;
+	std::vector<AtlasRegion>	m_regions;
+	std::vector<Texture*>		m_pages;
+};
@@ -0,0 +1,156 @@
+#include "ViewCuller.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Game/Map.hpp"
+
+extern NamedStrings* g_gameConfigBlackboard;
+
+float CullStats::GetCullRate() const
+{
+	if (m_numTested == 0)
+	{
+		return 0.f;
+	}
+	return (float)(m_numFrustumCulled + m_numOccluded) / (float)m_numTested;
+}
+
+ViewCuller::ViewCuller(Map* map)
+{
+	m_map = map;
+	m_numColumns = g_gameConfigBlackboard->GetValue("occlusionColumns", 256);
+	if (m_numColumns < 8)
+	{
+		m_numColumns = 8;
+	}
+	m_columnDepths.resize(m_numColumns);
+}
+
+void ViewCuller::BeginView(Vec3 const& position, EulerAngles const& orientation, float fovDegrees, float aspect, float farDistance)
+{
+	m_position = position;
+	m_farDistance = farDistance;
+	m_stats = CullStats();
+	BuildFrustum(orientation, fovDegrees, aspect);
+	RasterizeOcclusion();
+}
+
+bool ViewCuller::IsCylinderVisible(Vec3 const& base, float radius, float height)
+{
+	m_stats.m_numTested++;
+
+	//The sphere around the cylinder is a little loose at the caps but never culls something on screen
+	float halfHeight = height * .5f;
+	Vec3 center = base + Vec3(0.f, 0.f, halfHeight);
+	float sphereRadius = sqrtf((radius * radius) + (halfHeight * halfHeight));
+	if (!IsSphereInFrustum(center, sphereRadius))
+	{
+		m_stats.m_numFrustumCulled++;
+		return false;
+	}
+	if (IsCylinderOccluded(base, radius))
+	{
+		m_stats.m_numOccluded++;
+		return false;
+	}
+	return true;
+}
+
+CullStats const& ViewCuller::GetStats() const
+{
+	return m_stats;
+}
+
+void ViewCuller::BuildFrustum(EulerAngles const& orientation, float fovDegrees, float aspect)
+{
+	Vec3 forward;
+	Vec3 left;
+	Vec3 up;
+	orientation.GetAsVectors_IFwd_JLeft_KUp(forward, left, up);
+
+	float tanHalfVertical = SinDegrees(fovDegrees * .5f) / CosDegrees(fovDegrees * .5f);
+	float tanHalfHorizontal = tanHalfVertical * aspect;
+
+	//Normals point into the frustum; the side planes all pass through the eye
+	Vec3 normals[6] =
+	{
+		forward,
+		-forward,
+		(forward * tanHalfHorizontal - left).GetNormalized(),
+		(forward * tanHalfHorizontal + left).GetNormalized(),
+		(forward * tanHalfVertical - up).GetNormalized(),
+		(forward * tanHalfVertical + up).GetNormalized()
+	};
+	for (int i = 0; i < 6; i++)
+	{
+		m_planes[i].m_normal = normals[i];
+		m_planes[i].m_distance = DotProduct3D(normals[i], m_position);
+	}
+	m_planes[0].m_distance += m_nearDistance;
+	m_planes[1].m_distance -= m_farDistance;
+}
+
+void ViewCuller::RasterizeOcclusion()
+{
+	//An eye inside a wall (free camera) would see every column blocked
+	m_isOcclusionValid = !m_map->IsTileSolid((int)floorf(m_position.x), (int)floorf(m_position.y));
+	if (!m_isOcclusionValid)
+	{
+		return;
+	}
+
+	//Walls are full-height grid cells, so one distance per horizontal direction is the whole depth buffer
+	float degreesPerColumn = 360.f / (float)m_numColumns;
+	Vec3 eye = Vec3(m_position.x, m_position.y, 0.f);
+	for (int column = 0; column < m_numColumns; column++)
+	{
+		float degrees = ((float)column + .5f) * degreesPerColumn;
+		Vec3 direction = Vec3(CosDegrees(degrees), SinDegrees(degrees), 0.f);
+		RaycastResult3D result = m_map->RaycastWorldXY(eye, direction, m_farDistance);
+		m_columnDepths[column] = result.m_didImpact ? result.m_impactDist : m_farDistance;
+	}
+}
+
+bool ViewCuller::IsSphereInFrustum(Vec3 const& center, float radius) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (DotProduct3D(m_planes[i].m_normal, center) - m_planes[i].m_distance < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ViewCuller::IsCylinderOccluded(Vec3 const& base, float radius) const
+{
+	if (!m_isOcclusionValid)
+	{
+		return false;
+	}
+
+	Vec3 toActor = Vec3(base.x - m_position.x, base.y - m_position.y, 0.f);
+	float distance = toActor.GetLength();
+	if (distance <= radius)
+	{
+		return false;
+	}
+
+	//Columns the disc covers, widened by one each side since a column only samples its centre ray
+	float degreesPerColumn = 360.f / (float)m_numColumns;
+	float centerDegrees = Atan2Degrees(toActor.y, toActor.x);
+	float halfWidthDegrees = Atan2Degrees(radius, sqrtf((distance * distance) - (radius * radius)));
+	int firstColumn = (int)floorf((centerDegrees - halfWidthDegrees) / degreesPerColumn) - 1;
+	int lastColumn = (int)floorf((centerDegrees + halfWidthDegrees) / degreesPerColumn) + 1;
+
+	float nearestDistance = distance - radius;
+	for (int column = firstColumn; column <= lastColumn; column++)
+	{
+		int wrappedColumn = ((column % m_numColumns) + m_numColumns) % m_numColumns;
+		if (m_columnDepths[wrappedColumn] >= nearestDistance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+
+class Map;
+
+struct CullPlane
+{
+	Vec3	m_normal;
+	float	m_distance = 0.f;
+};
+
+struct CullStats
+{
+	int		m_numTested = 0;
+	int		m_numFrustumCulled = 0;
+	int		m_numOccluded = 0;
+
+	float	GetCullRate() const;
+};
+
+//Per-view visibility for actors: frustum planes plus a ring of wall distances around the eye
+class ViewCuller
+{
+public:
+	ViewCuller(Map* map);
+	~ViewCuller() = default;
+
+	void				BeginView(Vec3 const& position, EulerAngles const& orientation, float fovDegrees, float aspect, float farDistance);
+	bool				IsCylinderVisible(Vec3 const& base, float radius, float height);
+	CullStats const&	GetStats() const;
+
+private:
+	void				BuildFrustum(EulerAngles const& orientation, float fovDegrees, float aspect);
+	void				RasterizeOcclusion();
+	bool				IsSphereInFrustum(Vec3 const& center, float radius) const;
+	bool				IsCylinderOccluded(Vec3 const& base, float radius) const;
+
+	Map*				m_map = nullptr;
+	Vec3				m_position;
+	float				m_nearDistance = .1f;
+	float				m_farDistance = 100.f;
+	CullPlane			m_planes[6];
+
+	//Horizontal distance to the first solid tile, one entry per slice of the full circle around the eye
+	int					m_numColumns = 256;
+	bool				m_isOcclusionValid = false;
+	std::vector<float>	m_columnDepths;
+
+	CullStats			m_stats;
+};
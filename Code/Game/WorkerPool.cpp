@@ -0,0 +1,107 @@
+#include "WorkerPool.hpp"
+
+WorkerPool::WorkerPool(int numThreads)
+{
+	m_nextIndex = 0;
+	for (int i = 0; i < numThreads; i++)
+	{
+		m_threads.emplace_back(&WorkerPool::ThreadMain, this, i + 1);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_startCondition.notify_all();
+	for (int i = 0; i < (int)m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+	m_threads.clear();
+}
+
+int WorkerPool::GetNumWorkers() const
+{
+	return (int)m_threads.size() + 1;
+}
+
+void WorkerPool::ParallelFor(int count, int batchSize, std::function<void(int begin, int end, int workerIndex)> const& body)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	batchSize = (batchSize > 0) ? batchSize : 1;
+
+	//Waking the threads costs more than a single batch
+	if (m_threads.empty() || count <= batchSize)
+	{
+		body(0, count, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_body = &body;
+		m_count = count;
+		m_batchSize = batchSize;
+		m_nextIndex = 0;
+		m_numThreadsBusy = (int)m_threads.size();
+		m_generation++;
+	}
+	m_startCondition.notify_all();
+
+	RunBatches(0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this]() { return m_numThreadsBusy == 0; });
+	m_body = nullptr;
+}
+
+void WorkerPool::ThreadMain(int workerIndex)
+{
+	unsigned int lastGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, lastGeneration]() { return m_isQuitting || m_generation != lastGeneration; });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			lastGeneration = m_generation;
+		}
+
+		RunBatches(workerIndex);
+
+		bool isLast = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_numThreadsBusy--;
+			isLast = (m_numThreadsBusy == 0);
+		}
+		if (isLast)
+		{
+			m_doneCondition.notify_one();
+		}
+	}
+}
+
+void WorkerPool::RunBatches(int workerIndex)
+{
+	//Batches are handed out first come first served, so a slow one doesn't hold up a whole thread's share
+	for (;;)
+	{
+		int begin = m_nextIndex.fetch_add(m_batchSize);
+		if (begin >= m_count)
+		{
+			return;
+		}
+		int end = (begin + m_batchSize < m_count) ? begin + m_batchSize : m_count;
+		(*m_body)(begin, end, workerIndex);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+//Fixed set of threads for splitting a loop across cores. The calling thread works too and is always worker 0.
+//Only one ParallelFor runs at a time, and only the main thread starts one.
+class WorkerPool
+{
+public:
+	WorkerPool(int numThreads);
+	~WorkerPool();
+
+	int		GetNumWorkers() const;
+	void	ParallelFor(int count, int batchSize, std::function<void(int begin, int end, int workerIndex)> const& body);
+
+private:
+	void	ThreadMain(int workerIndex);
+	void	RunBatches(int workerIndex);
+
+	std::vector<std::thread>	m_threads;
+	std::mutex					m_mutex;
+	std::condition_variable		m_startCondition;
+	std::condition_variable		m_doneCondition;
+	bool						m_isQuitting = false;
+
+	//The current loop; the generation tells sleeping threads a new one has started
+	std::function<void(int, int, int)> const*	m_body = nullptr;
+	int											m_count = 0;
+	int											m_batchSize = 1;
+	std::atomic<int>							m_nextIndex;
+	unsigned int								m_generation = 0;
+	int											m_numThreadsBusy = 0;
+};
@@ -0,0 +1,87 @@
+//Static map chunks in the PCU input layout: chunk-relative positions, baked colour with the tangent frame index in alpha, plain UVs.
+//The frame itself comes from the map's frame table; lighting matches what Diffuse does for full PCUTBN vertices.
+struct PointLight
+{
+	float4 LightColor;
+	float3 LightPosition;
+	float Intensity;
+};
+cbuffer LightConstants : register(b1)
+{
+	float3 SunDirection;
+	float SunIntensity;
+	float AmbientIntensity;
+	uint NumPointLights;
+	PointLight PointLightList[64];
+};
+cbuffer CameraConstants : register(b2)
+{
+	float4x4 WorldToCameraTransform;
+	float4x4 CameraToRenderTransform;
+	float4x4 RenderToClipTransform;
+};
+cbuffer ModelConstants : register(b3)
+{
+	float4x4 ModelToWorldTransform;
+	float4 ModelColor;
+};
+cbuffer VertexFrameConstants : register(b4)
+{
+	float4 FrameTangents[64];
+	float4 FrameBitangents[64];
+	float4 FrameNormals[64];
+};
+Texture2D diffuseTexture : register(t0);
+SamplerState diffuseSampler : register(s0);
+struct vs_input_t
+{
+	float3 modelSpacePosition : POSITION;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+};
+struct v2p_t
+{
+	float4 clipSpacePosition : SV_Position;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float3 worldPosition : WORLDPOSITION;
+	float3 worldNormal : NORMAL;
+};
+v2p_t VertexMain(vs_input_t input)
+{
+	float4 modelSpacePosition = float4(input.modelSpacePosition, 1);
+	float4 worldSpacePosition = mul(ModelToWorldTransform, modelSpacePosition);
+	float4 cameraSpacePosition = mul(WorldToCameraTransform, worldSpacePosition);
+	float4 renderSpacePosition = mul(CameraToRenderTransform, cameraSpacePosition);
+	float4 clipSpacePosition = mul(RenderToClipTransform, renderSpacePosition);
+	uint frameIndex = (uint)round(input.color.a * 255.0f);
+	v2p_t v2p;
+	v2p.clipSpacePosition = clipSpacePosition;
+	v2p.color = float4(input.color.rgb, 1);
+	v2p.uv = input.uv;
+	v2p.worldPosition = worldSpacePosition.xyz;
+	v2p.worldNormal = mul(ModelToWorldTransform, float4(FrameNormals[frameIndex].xyz, 0)).xyz;
+	return v2p;
+}
+float4 PixelMain(v2p_t input) : SV_Target0
+{
+	float3 normal = normalize(input.worldNormal);
+	float light = AmbientIntensity + (SunIntensity * saturate(dot(normal, -SunDirection)));
+	float3 pointLight = float3(0, 0, 0);
+	for (uint i = 0; i < NumPointLights; i++)
+	{
+		//Same reach the light budget assumes: 40 units per point of intensity, squared falloff
+		float3 toLight = PointLightList[i].LightPosition - input.worldPosition;
+		float distance = length(toLight);
+		float radius = max(PointLightList[i].Intensity * 40.0f, 0.01f);
+		float falloff = saturate(1.0f - (distance / radius));
+		float facing = saturate(dot(normal, toLight / max(distance, 0.0001f)));
+		pointLight += PointLightList[i].LightColor.rgb * PointLightList[i].Intensity * facing * falloff * falloff;
+	}
+	float4 textureColor = diffuseTexture.Sample(diffuseSampler, input.uv);
+	float4 vertexColor = input.color;
+	float4 color = textureColor * vertexColor * ModelColor;
+	color.rgb *= saturate(float3(light, light, light) + pointLight);
+	clip(color.a - 0.01f);
+	return float4(color);
+}